@@ -0,0 +1,113 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark a pruned BERT before and after the automatic block sparse conversion.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import graph_executor
+
+
+def get_bert(batch_size, seq_len):
+    # pylint: disable=import-outside-toplevel
+    import torch
+    from transformers import BertModel
+
+    model = BertModel.from_pretrained("bert-base-uncased", torchscript=True).eval()
+    inputs = torch.randint(0, 30000, (batch_size, seq_len))
+    traced = torch.jit.trace(model, inputs)
+    mod, params = relay.frontend.from_pytorch(
+        traced, [("input_ids", ((batch_size, seq_len), "int64"))]
+    )
+    # The linear layers are imported as dense ops of transposed weights, fold the transposes
+    # so the weights are the operands of the dense ops.
+    mod = relay.transform.SimplifyExpr()(relay.transform.InferType()(mod))
+    func, params = relay.data_dep_optimization.simplify_fc_transpose.convert(mod["main"], params)
+    return tvm.IRModule.from_expr(func), params
+
+
+def prune(mod, params, sparsity, block_size):
+    """Zero the blocks of the smallest norm of the dense weights, like a block pruned model."""
+    bs_r, bs_c = block_size
+    for name in relay.analysis.sparse_dense._search_dense_op_weight(mod["main"]):
+        name = str(name)
+        w_np = params[name].numpy()
+        rows, cols = w_np.shape
+        if rows % bs_r or cols % bs_c:
+            continue
+        blocks = w_np.reshape(rows // bs_r, bs_r, cols // bs_c, bs_c)
+        norms = np.abs(blocks).sum(axis=(1, 3))
+        mask = norms > np.quantile(norms, sparsity)
+        blocks *= mask[:, None, :, None]
+        params[name] = tvm.nd.array(blocks.reshape(rows, cols))
+
+
+def run(mod, params, inputs, target, repeat):
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target=target, params=params)
+    dev = tvm.device(tvm.target.Target(target).kind.name, 0)
+    module = graph_executor.GraphModule(lib["default"](dev))
+    module.set_input(**inputs)
+    module.run()
+    ftimer = module.module.time_evaluator("run", dev, number=1, repeat=repeat)
+    return np.mean(ftimer().results) * 1e3, module.get_output(0).numpy()
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--seq-len", type=int, default=128)
+    parser.add_argument("--sparsity", type=float, default=0.9)
+    parser.add_argument("--prune-block", type=int, nargs=2, default=[16, 1])
+    parser.add_argument("--target", type=str, default="llvm -mcpu=core-avx2")
+    parser.add_argument("--measure", action="store_true")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    mod, params = get_bert(1, args.seq_len)
+    prune(mod, params, args.sparsity, args.prune_block)
+    inputs = {"input_ids": np.random.randint(0, 30000, (1, args.seq_len)).astype("int64")}
+    dense_time, dense_out = run(mod, params, inputs, args.target, args.repeat)
+
+    func, params, report = relay.data_dep_optimization.auto_bsr.convert(
+        mod["main"], dict(params), target=args.target, measure=args.measure
+    )
+    print("%-48s %12s %10s %10s %10s" % ("weight", "block", "density", "speedup", "converted"))
+    for layer in report:
+        print(
+            "%-48s %12s %10.3f %10.2f %10s"
+            % (
+                layer["name"],
+                "%dx%d" % layer["block_size"],
+                layer["block_density"],
+                layer["speedup"],
+                layer["converted"],
+            )
+        )
+    sparse_time, sparse_out = run(
+        tvm.IRModule.from_expr(func), params, inputs, args.target, args.repeat
+    )
+    tvm.testing.assert_allclose(dense_out, sparse_out, rtol=1e-3, atol=1e-3)
+    print("%-10s %12s %12s %10s" % ("model", "dense (ms)", "sparse (ms)", "speedup"))
+    print(
+        "%-10s %12.2f %12.2f %10.2f"
+        % ("bert", dense_time, sparse_time, dense_time / sparse_time)
+    )
@@ -0,0 +1,86 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the feature extraction pipeline that feeds the auto-scheduler cost model.
+see README.md for the usage of this script.
+"""
+import argparse
+import time
+
+import numpy as np
+
+import tvm
+from tvm import auto_scheduler, te, topi
+from tvm.auto_scheduler.cost_model.xgb_model import (
+    feature_to_pack_sum_xgbmatrix,
+    feature_tensor_to_pack_sum_xgbmatrix,
+)
+
+
+@auto_scheduler.register_workload
+def conv2d_nchw(N, H, W, CI, CO, KH, KW):
+    data = te.placeholder((N, CI, H, W), name="data")
+    kernel = te.placeholder((CO, CI, KH, KW), name="kernel")
+    out = topi.nn.conv2d_nchw(data, kernel, 1, 1, 1, out_dtype="float32")
+    return [data, kernel, out]
+
+
+def sample_states(task, n_states):
+    policy = auto_scheduler.SketchPolicy(task, verbose=0)
+    states = []
+    while len(states) < n_states:
+        states.extend(policy.sample_initial_population())
+    return states[:n_states]
+
+
+def measure(func, repeat):
+    costs = []
+    for _ in range(repeat):
+        tic = time.time()
+        func()
+        costs.append(time.time() - tic)
+    return np.median(costs)
+
+
+def benchmark(n_states, repeat):
+    target = tvm.target.Target("llvm")
+    task = auto_scheduler.SearchTask(
+        func=conv2d_nchw, args=(1, 56, 56, 64, 64, 3, 3), target=target
+    )
+    states = sample_states(task, n_states)
+
+    def row_pipeline():
+        features = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+        feature_to_pack_sum_xgbmatrix(features)
+
+    def tensor_pipeline():
+        features, row_offsets = auto_scheduler.feature.get_per_store_feature_tensor_from_states(
+            states, task
+        )
+        feature_tensor_to_pack_sum_xgbmatrix(features, row_offsets)
+
+    for name, func in [("per-state rows", row_pipeline), ("packed tensor", tensor_pipeline)]:
+        cost = measure(func, repeat)
+        print("%-16s %8.3f s  %10.1f states/s" % (name, cost, n_states / cost))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n-states", type=int, default=10000)
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    benchmark(args.n_states, args.repeat)
@@ -0,0 +1,109 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark shape-bucketed kernels on a BERT encoder with a dynamic sequence length.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relay, runtime
+from tvm.relay.backend import vm
+
+
+def dense(x, name, units, params, in_units):
+    w = relay.var(name + "_weight", shape=(units, in_units))
+    b = relay.var(name + "_bias", shape=(units,))
+    params[name + "_weight"] = np.random.uniform(-0.1, 0.1, (units, in_units)).astype("float32")
+    params[name + "_bias"] = np.random.uniform(-0.1, 0.1, (units,)).astype("float32")
+    return relay.nn.bias_add(relay.nn.dense(x, w), b, axis=-1)
+
+
+def layer_norm(x, name, hidden, params):
+    gamma = relay.var(name + "_gamma", shape=(hidden,))
+    beta = relay.var(name + "_beta", shape=(hidden,))
+    params[name + "_gamma"] = np.ones((hidden,), "float32")
+    params[name + "_beta"] = np.zeros((hidden,), "float32")
+    return relay.nn.layer_norm(x, gamma, beta)
+
+
+def encoder_layer(x, name, hidden, heads, params):
+    """One encoder layer on a (seq_len, hidden) input."""
+    head_dim = hidden // heads
+
+    def split_heads(t):
+        t = relay.reshape(t, (-1, heads, head_dim))
+        return relay.transpose(t, (1, 0, 2))
+
+    q = split_heads(dense(x, name + "_q", hidden, params, hidden))
+    k = split_heads(dense(x, name + "_k", hidden, params, hidden))
+    v = split_heads(dense(x, name + "_v", hidden, params, hidden))
+    score = relay.nn.batch_matmul(q, k) * relay.const(1.0 / np.sqrt(head_dim), "float32")
+    prob = relay.nn.softmax(score, axis=-1)
+    ctx = relay.nn.batch_matmul(prob, relay.transpose(v, (0, 2, 1)))
+    ctx = relay.reshape(relay.transpose(ctx, (1, 0, 2)), (-1, hidden))
+    x = x + dense(ctx, name + "_o", hidden, params, hidden)
+    x = layer_norm(x, name + "_ln1", hidden, params)
+    ffn = relay.nn.relu(dense(x, name + "_ffn1", 4 * hidden, params, hidden))
+    ffn = dense(ffn, name + "_ffn2", hidden, params, 4 * hidden)
+    return layer_norm(x + ffn, name + "_ln2", hidden, params)
+
+
+def bert_encoder(num_layers, hidden, heads):
+    params = {}
+    x = relay.var("data", shape=(relay.Any(), hidden))
+    out = x
+    for i in range(num_layers):
+        out = encoder_layer(out, "layer%d" % i, hidden, heads, params)
+    func = relay.Function(relay.analysis.free_vars(out), out)
+    return tvm.IRModule.from_expr(func), params
+
+
+def benchmark(mod, params, target, buckets, seq_lens, hidden, repeat):
+    config = {"relay.backend.shape_buckets": buckets} if buckets else {}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        exe = vm.compile(mod, target=target, params=params)
+    dev = tvm.cpu(0)
+    vm_exec = runtime.vm.VirtualMachine(exe, dev)
+    results = []
+    for seq_len in seq_lens:
+        data = tvm.nd.array(np.random.uniform(size=(seq_len, hidden)).astype("float32"), dev)
+        vm_exec.set_input("main", data)
+        evaluator = vm_exec.module.time_evaluator("invoke", dev, number=10, repeat=repeat)
+        results.append(np.median(evaluator("main").results) * 1e3)
+    return results
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--num-layers", type=int, default=2)
+    parser.add_argument("--hidden", type=int, default=768)
+    parser.add_argument("--heads", type=int, default=12)
+    parser.add_argument("--buckets", type=int, nargs="+", default=[32, 64, 128, 256])
+    parser.add_argument("--seq-lens", type=int, nargs="+", default=[32, 64, 100, 128, 256])
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    mod, params = bert_encoder(args.num_layers, args.hidden, args.heads)
+    common = (args.seq_lens, args.hidden, args.repeat)
+    generic = benchmark(mod, params, args.target, [], *common)
+    bucketed = benchmark(mod, params, args.target, args.buckets, *common)
+    print("%-10s %14s %14s %10s" % ("seq_len", "generic (ms)", "bucketed (ms)", "speedup"))
+    for seq_len, g, b in zip(args.seq_lens, generic, bucketed):
+        print("%-10d %14.3f %14.3f %9.2fx" % (seq_len, g, b, g / b))
@@ -0,0 +1,91 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the constant folding of the weight-side transforms of a network.
+see README.md for the usage of this script.
+"""
+import argparse
+import time
+
+import tvm
+from tvm import relay
+from tvm.relay.build_module import bind_params_by_name
+
+from util import get_network
+
+
+def get_bert(batch_size, seq_len):
+    # pylint: disable=import-outside-toplevel
+    import torch
+    from transformers import BertModel
+
+    model = BertModel.from_pretrained("bert-base-uncased", torchscript=True).eval()
+    inputs = torch.randint(0, 30000, (batch_size, seq_len))
+    traced = torch.jit.trace(model, inputs)
+    return relay.frontend.from_pytorch(traced, [("input_ids", ((batch_size, seq_len), "int64"))])
+
+
+def prepare(mod, params, target):
+    """Bind the weights and produce the weight-side transforms of a build, unfolded."""
+    mod["main"] = bind_params_by_name(mod["main"], params)
+    seq = tvm.transform.Sequential(
+        [
+            relay.transform.InferType(),
+            relay.transform.SimplifyInference(),
+            relay.transform.ConvertLayout({"nn.conv2d": ["NHWC", "default"]}),
+            relay.transform.AlterOpLayout(),
+            relay.transform.InferType(),
+        ]
+    )
+    with tvm.transform.PassContext(opt_level=3, disabled_pass=["FoldConstant"]):
+        with tvm.target.Target(target):
+            return seq(mod)
+
+
+def fold(mod, batch):
+    config = {"relay.FoldConstant": {"batch": batch, "report": True}}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        start = time.time()
+        mod = relay.transform.FoldConstant()(mod)
+        return mod, time.time() - start
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--network",
+        type=str,
+        choices=["resnet-18", "resnet-50", "vgg-16", "inception_v3", "mobilenet", "bert"],
+        default="resnet-50",
+    )
+    parser.add_argument("--target", type=str, default="llvm -mcpu=core-avx2")
+    parser.add_argument("--seq-len", type=int, default=128)
+    args = parser.parse_args()
+
+    if args.network == "bert":
+        mod, params = get_bert(1, args.seq_len)
+    else:
+        mod, params, _, _ = get_network(args.network, batch_size=1)
+    mod = prepare(mod, params, args.target)
+
+    base, base_time = fold(mod, False)
+    batched, batched_time = fold(mod, True)
+    assert tvm.ir.structural_equal(base, batched), "the batched folding changed the program"
+    print("%-14s %14s %14s %10s" % ("network", "default (s)", "batched (s)", "speedup"))
+    print(
+        "%-14s %14.2f %14.2f %10.2f"
+        % (args.network, base_time, batched_time, base_time / batched_time)
+    )
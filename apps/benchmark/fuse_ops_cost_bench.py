@@ -0,0 +1,117 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark a network fused with the pattern rules and with the cost model of FuseOps.
+see README.md for the usage of this script.
+"""
+import argparse
+import json
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import graph_executor
+
+from util import get_network
+
+
+def get_transformer(num_layers, seq_len, hidden):
+    """Single head transformer layers, with the softmax and layer norm decomposed like the
+    graphs imported from the frameworks."""
+
+    def layer_norm(x):
+        mean = relay.mean(x, axis=1, keepdims=True)
+        centered = relay.subtract(x, mean)
+        var = relay.mean(relay.multiply(centered, centered), axis=1, keepdims=True)
+        return relay.divide(centered, relay.sqrt(relay.add(var, relay.const(1e-5))))
+
+    def softmax(x):
+        e = relay.exp(relay.subtract(x, relay.max(x, axis=1, keepdims=True)))
+        return relay.divide(e, relay.sum(e, axis=1, keepdims=True))
+
+    x = relay.var("data", shape=(seq_len, hidden))
+    params = {}
+
+    def weight(name, shape):
+        params[name] = np.random.uniform(-0.1, 0.1, size=shape).astype("float32")
+        return relay.var(name, shape=shape)
+
+    for i in range(num_layers):
+        q = relay.nn.dense(x, weight("wq%d" % i, (hidden, hidden)))
+        k = relay.nn.dense(x, weight("wk%d" % i, (hidden, hidden)))
+        v = relay.nn.dense(x, weight("wv%d" % i, (hidden, hidden)))
+        scores = relay.multiply(relay.nn.dense(q, k), relay.const(1.0 / np.sqrt(hidden)))
+        attn = relay.nn.dense(softmax(scores), relay.transpose(v))
+        x = layer_norm(relay.add(x, attn))
+        ffn = relay.nn.relu(relay.nn.dense(x, weight("w1%d" % i, (4 * hidden, hidden))))
+        x = layer_norm(relay.add(x, relay.nn.dense(ffn, weight("w2%d" % i, (hidden, 4 * hidden)))))
+    func = relay.Function(relay.analysis.free_vars(x), x)
+    params = {k: tvm.nd.array(v) for k, v in params.items()}
+    return tvm.IRModule.from_expr(func), params
+
+
+def run(mod, params, inputs, target, objective, repeat):
+    # only the x86 schedules compute chained reductions.
+    fuse_reductions = tvm.target.Target(target).kind.name == "llvm"
+    config = {
+        "relay.FuseOps.cost_model": {"objective": objective, "fuse_reductions": fuse_reductions}
+    }
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = relay.build(mod, target=target, params=params)
+    num_kernels = sum(node["op"] == "tvm_op" for node in json.loads(lib.get_graph_json())["nodes"])
+    dev = tvm.device(target, 0)
+    module = graph_executor.GraphModule(lib["default"](dev))
+    module.set_input(**inputs)
+    ftimer = module.module.time_evaluator("run", dev, number=10, repeat=repeat)
+    module.run()
+    return num_kernels, np.mean(ftimer().results) * 1e3, module.get_output(0).numpy()
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--network",
+        type=str,
+        choices=["transformer", "resnet-18", "resnet-50", "mobilenet", "inception_v3"],
+        default="transformer",
+    )
+    parser.add_argument("--num-layers", type=int, default=4)
+    parser.add_argument("--seq-len", type=int, default=128)
+    parser.add_argument("--hidden", type=int, default=256)
+    parser.add_argument("--target", type=str, default="llvm -mcpu=core-avx2")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    if args.network == "transformer":
+        mod, params = get_transformer(args.num_layers, args.seq_len, args.hidden)
+    else:
+        mod, params, _, _ = get_network(args.network, batch_size=1)
+    mod = relay.transform.InferType()(mod)
+    inputs = {}
+    for param in mod["main"].params:
+        if param.name_hint not in params:
+            shape = [int(d) for d in param.checked_type.shape]
+            inputs[param.name_hint] = np.random.uniform(size=shape).astype("float32")
+
+    print("%-14s %-10s %8s %12s" % ("network", "objective", "kernels", "time (ms)"))
+    outputs = []
+    for objective in ["pattern", "cost"]:
+        num_kernels, time, output = run(mod, params, inputs, args.target, objective, args.repeat)
+        outputs.append(output)
+        print("%-14s %-10s %8d %12.3f" % (args.network, objective, num_kernels, time))
+    tvm.testing.assert_allclose(outputs[0], outputs[1], rtol=1e-4, atol=1e-4)
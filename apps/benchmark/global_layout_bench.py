@@ -0,0 +1,86 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the layouts of the convolutions selected one at a time by AlterOpLayout
+against the layouts selected together by SelectGlobalLayout.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import autotvm, relay
+from tvm.contrib import graph_executor
+from tvm.relay import transform
+from tvm.relay.testing import count_ops
+
+from util import get_network
+
+
+def select_layouts(mod, params, target, global_layout, config):
+    """Bind the weights and select the layouts, then fold the weight transforms."""
+    mod["main"] = relay.build_module.bind_params_by_name(mod["main"], params)
+    layout_pass = transform.SelectGlobalLayout() if global_layout else transform.AlterOpLayout()
+    seq = tvm.transform.Sequential(
+        [
+            transform.SimplifyInference(),
+            transform.FoldConstant(),
+            transform.FoldScaleAxis(),
+            layout_pass,
+            transform.FoldConstant(),
+        ]
+    )
+    with tvm.transform.PassContext(opt_level=3, config=config), tvm.target.Target(target):
+        return seq(mod)
+
+
+def run(mod, target, input_shape, repeat):
+    with tvm.transform.PassContext(opt_level=3, disabled_pass=["AlterOpLayout"]):
+        lib = relay.build(mod, target=target)
+    dev = tvm.cpu(0)
+    module = graph_executor.GraphModule(lib["default"](dev))
+    module.set_input("data", np.random.uniform(size=input_shape).astype("float32"))
+    ftimer = module.module.time_evaluator("run", dev, number=1, repeat=repeat)
+    return np.mean(ftimer().results) * 1000
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--network",
+        type=str,
+        choices=["resnet-18", "resnet-50", "mobilenet", "vgg-16", "inception_v3"],
+        default="resnet-50",
+    )
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--target", type=str, default="llvm -mcpu=core-avx2")
+    parser.add_argument("--log-file", type=str, default="", help="an autotvm log of conv2d_NCHWc")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    mod, params, input_shape, _ = get_network(args.network, batch_size=args.batch_size)
+    config = {"relay.SelectGlobalLayout": {"log_file": args.log_file}}
+    print("%-16s %18s %14s" % ("layouts", "layout_transform", "time (ms)"))
+    # The tuned configurations also serve the kernels of both selections.
+    with autotvm.apply_history_best(args.log_file or None):
+        for name, global_layout in [("AlterOpLayout", False), ("SelectGlobalLayout", True)]:
+            selected = select_layouts(mod, params, args.target, global_layout, config)
+            num_transforms = count_ops(selected["main"]).get("layout_transform", 0)
+            print(
+                "%-16s %18d %14.2f"
+                % (name, num_transforms, run(selected, args.target, input_shape, args.repeat))
+            )
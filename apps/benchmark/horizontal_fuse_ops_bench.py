@@ -0,0 +1,70 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark a network with many independent small branches with and without the
+horizontal fusion of the fused operators.
+see README.md for the usage of this script.
+"""
+import argparse
+import json
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+
+
+def get_multi_head(num_heads, seq_len, head_dim):
+    """The per-head normalization and scoring of an attention layer, one branch per head."""
+    outputs, inputs = [], []
+    for i in range(num_heads):
+        x = relay.var("head%d" % i, shape=(seq_len, head_dim))
+        inputs.append(x)
+        y = relay.nn.relu(relay.multiply(x, relay.const(0.125)))
+        mean = relay.mean(y, axis=1, keepdims=True)
+        outputs.append(relay.sum(relay.exp(relay.subtract(y, mean)), axis=1))
+    return tvm.IRModule.from_expr(relay.Function(inputs, relay.Tuple(outputs)))
+
+
+def run(mod, target, horizontal, repeat):
+    required = ["HorizontalFuseOps"] if horizontal else []
+    with tvm.transform.PassContext(opt_level=3, required_pass=required):
+        lib = relay.build(mod, target=target)
+    num_kernels = sum(node["op"] == "tvm_op" for node in json.loads(lib.get_graph_json())["nodes"])
+    dev = tvm.device(target, 0)
+    module = graph_executor.GraphModule(lib["default"](dev))
+    for param in mod["main"].params:
+        shape = [int(d) for d in param.checked_type.shape]
+        module.set_input(param.name_hint, np.random.uniform(size=shape).astype("float32"))
+    ftimer = module.module.time_evaluator("run", dev, number=100, repeat=repeat)
+    return num_kernels, np.mean(ftimer().results) * 1e6
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--num-heads", type=int, default=16)
+    parser.add_argument("--seq-len", type=int, default=16)
+    parser.add_argument("--head-dim", type=int, default=64)
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    mod = relay.transform.InferType()(get_multi_head(args.num_heads, args.seq_len, args.head_dim))
+    print("%-12s %8s %12s" % ("fusion", "kernels", "time (us)"))
+    for name, horizontal in [("vertical", False), ("horizontal", True)]:
+        num_kernels, time = run(mod, args.target, horizontal, args.repeat)
+        print("%-12s %8d %12.2f" % (name, num_kernels, time))
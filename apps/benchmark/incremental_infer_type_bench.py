@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the incremental type inference on the optimization of a network.
+see README.md for the usage of this script.
+"""
+import argparse
+import time
+
+import tvm
+from tvm import relay
+
+from util import get_network
+
+
+def get_bert(batch_size, seq_len):
+    # pylint: disable=import-outside-toplevel
+    import torch
+    from transformers import BertModel
+
+    model = BertModel.from_pretrained("bert-base-uncased", torchscript=True).eval()
+    inputs = torch.randint(0, 30000, (batch_size, seq_len))
+    traced = torch.jit.trace(model, inputs)
+    return relay.frontend.from_pytorch(traced, [("input_ids", ((batch_size, seq_len), "int64"))])
+
+
+def measure(mod, params, target, incremental, repeat):
+    """Time a type inference of the unchanged module, and the optimization of the module."""
+    config = {"relay.InferType.incremental": incremental}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        mod = relay.transform.InferType()(mod)
+        start = time.time()
+        for _ in range(repeat):
+            relay.transform.InferType()(mod)
+        infer_time = (time.time() - start) / repeat
+        start = time.time()
+        optimized, _ = relay.optimize(mod, target, params)
+        optimize_time = time.time() - start
+    return optimized, infer_time, optimize_time
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--network",
+        type=str,
+        choices=["resnet-18", "resnet-50", "vgg-16", "inception_v3", "mobilenet", "bert"],
+        default="resnet-50",
+    )
+    parser.add_argument("--target", type=str, default="llvm -mcpu=core-avx2")
+    parser.add_argument("--seq-len", type=int, default=128)
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    if args.network == "bert":
+        mod, params = get_bert(1, args.seq_len)
+    else:
+        mod, params, _, _ = get_network(args.network, batch_size=1)
+
+    full, full_infer, full_optimize = measure(mod, params, args.target, False, args.repeat)
+    incr, incr_infer, incr_optimize = measure(mod, params, args.target, True, args.repeat)
+    assert tvm.ir.structural_equal(full, incr), "the incremental inference changed the program"
+    print(
+        "%-14s %-10s %14s %16s %10s"
+        % ("network", "step", "full (s)", "incremental (s)", "speedup")
+    )
+    for step, base, new in [
+        ("InferType", full_infer, incr_infer),
+        ("optimize", full_optimize, incr_optimize),
+    ]:
+        print("%-14s %-10s %14.4f %16.4f %10.2f" % (args.network, step, base, new, base / new))
@@ -0,0 +1,71 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the time to first inference of a JIT-compiled model with the MCJIT and ORC engines.
+see README.md for the usage of this script.
+"""
+import argparse
+import time
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor, utils
+
+from util import get_network
+
+
+def time_to_first_inference(mod, params, input_name, input_shape, target):
+    """Return the build time and the time of the first run, which includes the JIT."""
+    start = time.time()
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target=target, params=params)
+    built = time.time()
+    module = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    data = np.random.uniform(size=input_shape).astype("float32")
+    module.set_input(input_name, data)
+    module.run()
+    module.get_output(0).numpy()
+    return built - start, time.time() - built
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--network",
+        type=str,
+        choices=["resnet-18", "resnet-34", "resnet-50", "vgg-16", "vgg-19", "densenet-121",
+                 "inception_v3", "mobilenet", "squeezenet_v1.0", "squeezenet_v1.1"],
+        default="resnet-18",
+    )
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--jit-threads", type=int, default=4)
+    args = parser.parse_args()
+
+    mod, params, input_shape, _ = get_network(args.network, batch_size=1)
+    cache = utils.tempdir()
+    configs = [
+        ("mcjit", args.target),
+        ("orc", "%s -jit=orc" % args.target),
+        ("orc threads", "%s -jit=orc -jit-threads=%d" % (args.target, args.jit_threads)),
+        ("orc cold cache", "%s -jit=orc -jit-cache-dir=%s" % (args.target, cache.relpath("c"))),
+        ("orc warm cache", "%s -jit=orc -jit-cache-dir=%s" % (args.target, cache.relpath("c"))),
+    ]
+    print("%-16s %12s %16s %12s" % ("engine", "build (s)", "first run (s)", "total (s)"))
+    for name, target in configs:
+        build, first = time_to_first_inference(mod, params, "data", input_shape, target)
+        print("%-16s %12.3f %16.3f %12.3f" % (name, build, first, build + first))
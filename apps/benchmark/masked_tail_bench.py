@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark masked vector tails against scalarized tails on shapes that are
+not a multiple of the vector width.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te
+
+
+def bias_relu(rows, channel, lanes):
+    data = te.placeholder((rows, channel), name="data")
+    bias = te.placeholder((channel,), name="bias")
+    out = te.compute((rows, channel), lambda i, c: te.max(data[i, c] + bias[c], 0.0), name="out")
+    s = te.create_schedule(out.op)
+    i, c = s[out].op.axis
+    co, ci = s[out].split(c, factor=lanes)
+    s[out].parallel(i)
+    s[out].vectorize(ci)
+    return s, [data, bias, out]
+
+
+def channel_sum(rows, channel, lanes):
+    data = te.placeholder((rows, channel), name="data")
+    k = te.reduce_axis((0, rows), name="k")
+    out = te.compute((channel,), lambda c: te.sum(data[k, c], axis=k), name="out")
+    s = te.create_schedule(out.op)
+    co, ci = s[out].split(s[out].op.axis[0], factor=lanes)
+    s[out].reorder(co, s[out].op.reduce_axis[0], ci)
+    s[out].parallel(co)
+    s[out].vectorize(ci)
+    return s, [data, out]
+
+
+def benchmark(workload, predicated, repeat, **kwargs):
+    s, args = workload(**kwargs)
+    with tvm.transform.PassContext(config={"tir.vectorize_predicated_tail": predicated}):
+        f = tvm.build(s, args, "llvm")
+    dev = tvm.cpu(0)
+    arrays = [
+        tvm.nd.array(np.random.uniform(size=[int(x) for x in t.shape]).astype(t.dtype), dev)
+        for t in args
+    ]
+    evaluator = f.time_evaluator(f.entry_name, dev, number=10, repeat=repeat)
+    return np.median(evaluator(*arrays).results) * 1e3
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--rows", type=int, default=256)
+    parser.add_argument("--lanes", type=int, default=16)
+    parser.add_argument("--channels", type=int, nargs="+", default=[17, 33, 100, 255, 1001])
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    print("%-12s %8s %12s %12s" % ("workload", "channel", "scalar (ms)", "masked (ms)"))
+    for name, workload in [("bias_relu", bias_relu), ("channel_sum", channel_sum)]:
+        for channel in args.channels:
+            costs = [
+                benchmark(
+                    workload,
+                    predicated,
+                    args.repeat,
+                    rows=args.rows,
+                    channel=channel,
+                    lanes=args.lanes,
+                )
+                for predicated in [False, True]
+            ]
+            print("%-12s %8d %12.4f %12.4f" % (name, channel, costs[0], costs[1]))
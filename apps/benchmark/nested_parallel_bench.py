@@ -0,0 +1,81 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark nested parallel loops against manually fused parallel loops on conv2d NCHWc.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te, topi
+
+
+def conv2d_nchwc(nested, batch, in_channel, out_channel, size, bn):
+    data = te.placeholder((batch, in_channel // bn, size, size, bn), name="data")
+    kernel = te.placeholder((out_channel // bn, in_channel // bn, 3, 3, bn, bn), name="kernel")
+    out = topi.nn.conv2d_NCHWc(
+        data, kernel, 1, 1, 1, "NCHW%dc" % bn, "NCHW%dc" % bn, out_dtype="float32"
+    )
+    s = te.create_schedule(out.op)
+    s[out.op.input_tensors[0]].compute_inline()
+    n, oc_chunk, oh, ow, oc_block = s[out].op.axis
+    ic, kh, kw = s[out].op.reduce_axis
+    ic_chunk, ic_block = s[out].split(ic, factor=bn)
+    s[out].reorder(n, oc_chunk, oh, ic_chunk, kh, kw, ic_block, ow, oc_block)
+    s[out].vectorize(oc_block)
+    if nested:
+        # the codegen collapses the nested parallel loops into one iteration space
+        s[out].parallel(n)
+        s[out].parallel(oc_chunk)
+        s[out].parallel(oh)
+    else:
+        s[out].parallel(s[out].fuse(n, oc_chunk, oh))
+    return s, [data, kernel, out]
+
+
+def benchmark(nested, repeat, **kwargs):
+    s, args = conv2d_nchwc(nested, **kwargs)
+    f = tvm.build(s, args, "llvm")
+    dev = tvm.cpu(0)
+    arrays = [
+        tvm.nd.array(np.random.uniform(size=[int(x) for x in t.shape]).astype(t.dtype), dev)
+        for t in args
+    ]
+    evaluator = f.time_evaluator(f.entry_name, dev, number=10, repeat=repeat)
+    return np.median(evaluator(*arrays).results) * 1e3
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--batch", type=int, default=1)
+    parser.add_argument("--channel", type=int, default=64)
+    parser.add_argument("--size", type=int, default=56)
+    parser.add_argument("--bn", type=int, default=16)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    workload = dict(
+        batch=args.batch,
+        in_channel=args.channel,
+        out_channel=args.channel,
+        size=args.size,
+        bn=args.bn,
+    )
+    for name, nested in [("fused", False), ("nested", True)]:
+        cost = benchmark(nested, args.repeat, **workload)
+        print("%-8s %8.3f ms" % (name, cost))
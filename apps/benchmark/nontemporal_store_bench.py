@@ -0,0 +1,94 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark non-temporal stores on memory-bound operators with large outputs.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te, topi
+
+
+def schedule_injective(out, lanes):
+    s = te.create_schedule(out.op)
+    axes = s[out].op.axis
+    inner = axes[-1]
+    outer = s[out].fuse(*axes[:-1])
+    if int(out.shape[-1]) % lanes == 0:
+        inner, vec = s[out].split(inner, factor=lanes)
+        s[out].vectorize(vec)
+    s[out].parallel(outer)
+    return s
+
+
+def layout_transform(channel, size, lanes):
+    data = te.placeholder((1, channel, size, size), name="data")
+    out = topi.layout_transform(data, "NCHW", "NCHW%dc" % lanes)
+    return schedule_injective(out, lanes), [data, out]
+
+
+def concatenate(channel, size, lanes):
+    a = te.placeholder((1, size, size, channel), name="a")
+    b = te.placeholder((1, size, size, channel), name="b")
+    out = topi.concatenate([a, b], axis=3)
+    return schedule_injective(out, lanes), [a, b, out]
+
+
+def add(channel, size, lanes):
+    a = te.placeholder((1, channel, size, size), name="a")
+    b = te.placeholder((1, channel, size, size), name="b")
+    out = topi.add(a, b)
+    return schedule_injective(out, lanes), [a, b, out]
+
+
+def benchmark(workload, threshold, repeat, **kwargs):
+    s, args = workload(**kwargs)
+    with tvm.transform.PassContext(config={"tir.nontemporal_store_threshold": threshold}):
+        f = tvm.build(s, args, "llvm")
+    dev = tvm.cpu(0)
+    arrays = [
+        tvm.nd.array(np.random.uniform(size=[int(x) for x in t.shape]).astype(t.dtype), dev)
+        for t in args
+    ]
+    evaluator = f.time_evaluator(f.entry_name, dev, number=10, repeat=repeat)
+    cost = np.median(evaluator(*arrays).results)
+    nbytes = sum(np.prod(a.shape) * a.numpy().itemsize for a in arrays)
+    return cost * 1e3, nbytes / cost / 1e9
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--channel", type=int, default=256)
+    parser.add_argument("--size", type=int, default=224)
+    parser.add_argument("--lanes", type=int, default=16)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    kwargs = dict(channel=args.channel, size=args.size, lanes=args.lanes)
+    header = ("workload", "base (ms)", "base GB/s", "nt (ms)", "nt GB/s")
+    print("%-18s %12s %12s %14s %14s" % header)
+    for name, workload in [
+        ("layout_transform", layout_transform),
+        ("concatenate", concatenate),
+        ("add", add),
+    ]:
+        # a threshold of 0 disables the non-temporal stores, 1 marks every eligible output
+        base = benchmark(workload, 0, args.repeat, **kwargs)
+        nontemporal = benchmark(workload, 1, args.repeat, **kwargs)
+        print("%-18s %12.3f %12.2f %14.3f %14.2f" % ((name,) + base + nontemporal))
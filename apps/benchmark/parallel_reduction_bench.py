@@ -0,0 +1,85 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark reductions over a parallel axis on CPU.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te
+
+
+def global_avg_pool(size, channel):
+    # one large spatial reduction per channel, the channels are too few to parallelize
+    data = te.placeholder((channel, size * size), name="data")
+    k = te.reduce_axis((0, size * size), name="k")
+    out = te.compute((channel,), lambda c: te.sum(data[c, k], axis=k), name="pool")
+    return data, out, k
+
+
+def softmax_denominator(size, channel):
+    data = te.placeholder((size * size * channel,), name="data")
+    k = te.reduce_axis((0, size * size * channel), name="k")
+    out = te.compute((1,), lambda _: te.sum(te.exp(data[k]), axis=k), name="denom")
+    return data, out, k
+
+
+def row_sum(size, channel):
+    # the mean of a layer normalization over a long row
+    data = te.placeholder((1, size * size * channel), name="data")
+    k = te.reduce_axis((0, size * size * channel), name="k")
+    out = te.compute((1,), lambda i: te.sum(data[i, k], axis=k), name="row_sum")
+    return data, out, k
+
+
+def benchmark(workload, chunks, repeat, **kwargs):
+    data, out, k = workload(**kwargs)
+    s = te.create_schedule(out.op)
+    # without chunks the reduction stays a serial loop
+    if chunks > 0:
+        s[out].parallel(k)
+    with tvm.transform.PassContext(config={"tir.parallel_reduce_chunks": chunks}):
+        f = tvm.build(s, [data, out], "llvm")
+    dev = tvm.cpu(0)
+    arrays = [
+        tvm.nd.array(np.random.uniform(size=[int(x) for x in t.shape]).astype(t.dtype), dev)
+        for t in [data, out]
+    ]
+    evaluator = f.time_evaluator(f.entry_name, dev, number=10, repeat=repeat)
+    return np.median(evaluator(*arrays).results) * 1e3
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--size", type=int, default=224)
+    parser.add_argument("--channel", type=int, default=64)
+    parser.add_argument("--chunks", type=int, default=256)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    kwargs = dict(size=args.size, channel=args.channel)
+    print("%-20s %14s %16s %10s" % ("workload", "serial (ms)", "parallel (ms)", "speedup"))
+    for name, workload in [
+        ("global_avg_pool", global_avg_pool),
+        ("softmax_denominator", softmax_denominator),
+        ("row_sum", row_sum),
+    ]:
+        serial = benchmark(workload, 0, args.repeat, **kwargs)
+        parallel = benchmark(workload, args.chunks, args.repeat, **kwargs)
+        print("%-20s %14.3f %16.3f %10.2f" % (name, serial, parallel, serial / parallel))
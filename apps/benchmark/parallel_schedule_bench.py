@@ -0,0 +1,65 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the scheduling of parallel loops on an imbalanced workload.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te
+
+
+def triangular_workload(n):
+    """Row i of the output reduces over the first i + 1 rows of A, so the work grows with i."""
+    A = te.placeholder((n, n), name="A")
+    k = te.reduce_axis((0, n), name="k")
+    B = te.compute(
+        (n, n),
+        lambda i, j: te.sum(te.if_then_else(k <= i, A[k, j], 0.0), axis=k),
+        name="B",
+    )
+    return A, B
+
+
+def benchmark(n, schedule, repeat):
+    A, B = triangular_workload(n)
+    s = te.create_schedule(B.op)
+    i, j = B.op.axis
+    s[B].parallel(i)
+    s[B].vectorize(j)
+    if schedule != "static":
+        s[B].pragma(i, "parallel_schedule", schedule)
+    f = tvm.build(s, [A, B], "llvm")
+
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=(n, n)).astype(A.dtype), dev)
+    b = tvm.nd.array(np.zeros((n, n), dtype=B.dtype), dev)
+    evaluator = f.time_evaluator(f.entry_name, dev, number=10, repeat=repeat)
+    return np.median(evaluator(a, b).results) * 1e3
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n", type=int, default=1024)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    for schedule in ["static", "dynamic", "dynamic,4", "guided"]:
+        cost = benchmark(args.n, schedule, args.repeat)
+        print("%-12s %8.3f ms" % (schedule, cost))
@@ -0,0 +1,80 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark profile-guided loop unrolling and vectorization parameters.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm.contrib import utils
+from tvm.relay.backend import vm
+from tvm.runtime import profiler_vm
+from tvm.runtime.profiling import save_kernel_profile
+
+from util import get_network
+
+
+def compile_network(mod, params, target, config):
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        return vm.compile(mod, target=target, params=params)
+
+
+def run_time(exe, data, repeat):
+    dev = tvm.cpu(0)
+    vm_exec = tvm.runtime.vm.VirtualMachine(exe, dev)
+    vm_exec.set_input("main", data)
+    evaluator = vm_exec.module.time_evaluator("invoke", dev, number=5, repeat=repeat)
+    return np.median(evaluator("main").results) * 1e3
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--network",
+        type=str,
+        choices=["resnet-18", "resnet-34", "resnet-50", "vgg-16", "vgg-19", "densenet-121",
+                 "inception_v3", "mobilenet", "squeezenet_v1.0", "squeezenet_v1.1"],
+        default="resnet-18",
+    )
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--hot-fraction", type=float, default=0.05)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    mod, params, input_shape, _ = get_network(args.network, batch_size=1)
+    data = np.random.uniform(size=input_shape).astype("float32")
+
+    # 1. profile the default build and record the time of each kernel
+    exe = compile_network(mod, params, args.target, {})
+    baseline = run_time(exe, data, args.repeat)
+    profile = utils.tempdir().relpath("profile.json")
+    report = profiler_vm.VirtualMachineProfiler(exe, tvm.cpu(0)).profile(data, func_name="main")
+    save_kernel_profile(report, profile)
+
+    # 2. rebuild, measuring the loop parameter variants of the hot kernels
+    config = {
+        "tir.ProfileGuidedLoopParams": {
+            "profile": profile,
+            "hot_fraction": args.hot_fraction,
+            "target": args.target,
+        }
+    }
+    tuned = run_time(compile_network(mod, params, args.target, config), data, args.repeat)
+    print("%-16s %14s %14s %10s" % ("network", "default (ms)", "pgo (ms)", "speedup"))
+    print("%-16s %14.3f %14.3f %9.2fx" % (args.network, baseline, tuned, baseline / tuned))
@@ -0,0 +1,101 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the activation memory planned for the graph executor with and without
+the memory-aware reordering of the operators.
+see README.md for the usage of this script.
+"""
+import argparse
+import json
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import testing
+
+from util import get_network
+
+
+def get_unet(batch_size, image_size=256, depth=4, channels=16):
+    """A U-Net, whose skip connections keep the encoder outputs alive until the decoder."""
+    data = relay.var("data", shape=(batch_size, 3, image_size, image_size))
+    x, skips = data, []
+    for i in range(depth):
+        x = testing.layers.conv2d(
+            x, channels=channels << i, kernel_size=(3, 3), padding=(1, 1), name="enc%d" % i
+        )
+        x = relay.nn.relu(x)
+        skips.append(x)
+        x = relay.nn.max_pool2d(x, pool_size=(2, 2), strides=(2, 2))
+    for i in reversed(range(depth)):
+        x = relay.nn.upsampling(x, scale_h=2, scale_w=2)
+        x = relay.concatenate([x, skips[i]], axis=1)
+        x = testing.layers.conv2d(
+            x, channels=channels << i, kernel_size=(3, 3), padding=(1, 1), name="dec%d" % i
+        )
+        x = relay.nn.relu(x)
+    func = relay.Function(relay.analysis.free_vars(x), x)
+    return testing.create_workload(func)
+
+
+def planned_bytes(graph_json):
+    """The bytes of the storage planned for the outputs of the operators."""
+    graph = json.loads(graph_json)
+    attrs = graph["attrs"]
+    inputs = set(graph["arg_nodes"])
+    sizes = {}
+    for nid, (sid, shape, dtype) in enumerate(
+        zip(attrs["storage_id"][1], attrs["shape"][1], attrs["dltype"][1])
+    ):
+        if nid in inputs:
+            continue
+        nbytes = int(np.prod(shape)) * np.dtype(dtype).itemsize
+        sizes[sid] = max(sizes.get(sid, 0), nbytes)
+    return sum(sizes.values())
+
+
+def build(mod, params, target, reorder):
+    required = ["ReorderForMemory"] if reorder else []
+    config = {"relay.ReorderForMemory.report": True}
+    with tvm.transform.PassContext(opt_level=3, required_pass=required, config=config):
+        return relay.build(mod, target=target, params=params)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--network",
+        type=str,
+        choices=["unet", "resnet-50", "inception_v3", "densenet-121", "squeezenet_v1.1"],
+        default="unet",
+    )
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--target", type=str, default="llvm")
+    args = parser.parse_args()
+
+    if args.network == "unet":
+        mod, params = get_unet(args.batch_size)
+    else:
+        mod, params, _, _ = get_network(args.network, batch_size=args.batch_size)
+
+    base = planned_bytes(build(mod, params, args.target, False).get_graph_json())
+    reordered = planned_bytes(build(mod, params, args.target, True).get_graph_json())
+    print("%-16s %16s %16s %10s" % ("network", "default (MB)", "reordered (MB)", "saving"))
+    print(
+        "%-16s %16.2f %16.2f %9.1f%%"
+        % (args.network, base / 2 ** 20, reordered / 2 ** 20, 100.0 * (1 - reordered / base))
+    )
@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark automatic software prefetching on memory-bound operators.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te, topi
+
+
+def embedding(vocab, dim, n):
+    weight = te.placeholder((vocab, dim), name="weight")
+    indices = te.placeholder((n,), dtype="int32", name="indices")
+    out = topi.take(weight, indices, axis=0)
+    s = te.create_schedule(out.op)
+    s[out].parallel(s[out].op.axis[0])
+    return s, [weight, indices, out]
+
+
+def depthwise_conv2d(size, channel, kernel):
+    data = te.placeholder((1, size, size, channel), name="data")
+    weight = te.placeholder((kernel, kernel, channel, 1), name="weight")
+    out = topi.nn.depthwise_conv2d_nhwc(data, weight, 1, kernel // 2, 1)
+    s = te.create_schedule(out.op)
+    s[out.op.input_tensors[0]].compute_inline()
+    n, h, w, c = s[out].op.axis
+    kh, kw = s[out].op.reduce_axis
+    # channel outer, the innermost loop walks the rows with a stride of `channel` elements
+    s[out].reorder(n, c, h, kh, kw, w)
+    s[out].parallel(c)
+    return s, [data, weight, out]
+
+
+def random_array(tensor, high):
+    shape = [int(x) for x in tensor.shape]
+    if tensor.dtype == "int32":
+        return np.random.randint(0, high, size=shape).astype(tensor.dtype)
+    return np.random.uniform(size=shape).astype(tensor.dtype)
+
+
+def benchmark(workload, target, repeat, **kwargs):
+    s, args = workload(**kwargs)
+    f = tvm.build(s, args, target)
+    dev = tvm.cpu(0)
+    high = kwargs.get("vocab", 1)
+    arrays = [tvm.nd.array(random_array(t, high), dev) for t in args]
+    evaluator = f.time_evaluator(f.entry_name, dev, number=10, repeat=repeat)
+    return np.median(evaluator(*arrays).results) * 1e3
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--latency", type=int, default=200, help="memory latency in cycles")
+    parser.add_argument("--vocab", type=int, default=200000)
+    parser.add_argument("--dim", type=int, default=128)
+    parser.add_argument("--lookups", type=int, default=8192)
+    parser.add_argument("--size", type=int, default=112)
+    parser.add_argument("--channel", type=int, default=64)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    prefetch_target = "%s -software-prefetch=1 -prefetch-latency=%d" % (args.target, args.latency)
+    workloads = [
+        ("embedding", embedding, dict(vocab=args.vocab, dim=args.dim, n=args.lookups)),
+        ("depthwise", depthwise_conv2d, dict(size=args.size, channel=args.channel, kernel=3)),
+    ]
+    print("%-12s %12s %14s" % ("workload", "base (ms)", "prefetch (ms)"))
+    for name, workload, kwargs in workloads:
+        base = benchmark(workload, args.target, args.repeat, **kwargs)
+        prefetch = benchmark(workload, prefetch_target, args.repeat, **kwargs)
+        print("%-12s %12.4f %14.4f" % (name, base, prefetch))
@@ -156,6 +156,10 @@ set(USE_OPENMP none)
 # Whether use contrib.random in runtime
 set(USE_RANDOM ON)
 
+# Whether to collect hardware counters (cycles, instructions, cache misses, ...)
+# in the profiler of the graph executor and vm using Linux perf_event_open
+set(USE_PERF_EVENT OFF)
+
 # Whether use NNPack
 set(USE_NNPACK OFF)
 
@@ -74,6 +74,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_SORT="${USE_SORT}"
     TVM_INFO_USE_NNPACK="${USE_NNPACK}"
     TVM_INFO_USE_RANDOM="${USE_RANDOM}"
+    TVM_INFO_USE_PERF_EVENT="${USE_PERF_EVENT}"
     TVM_INFO_USE_MICRO_STANDALONE_RUNTIME="${USE_MICRO_STANDALONE_RUNTIME}"
     TVM_INFO_USE_CPP_RPC="${USE_CPP_RPC}"
     TVM_INFO_USE_TFLITE="${USE_TFLITE}"
@@ -33,6 +33,7 @@
 
 #include <tvm/auto_scheduler/compute_dag.h>
 #include <tvm/auto_scheduler/measure.h>
+#include <tvm/runtime/ndarray.h>
 
 #include <string>
 #include <vector>
@@ -116,6 +117,21 @@ void GetPerStoreFeaturesFromMeasurePairs(const Array<MeasureInput>& inputs,
                                          std::vector<float>* normalized_throughputs,
                                          std::vector<int>* task_ids);
 
+/*!
+ * \brief Pack the per-store features of n states into a single contiguous feature tensor.
+ * The per-state vectors are copied in parallel and released right after they are copied.
+ * They cannot be extracted into the tensor directly, since the number of rows of a state is
+ * only known after it is lowered.
+ * \param features The per-store features returned by GetPerStoreFeaturesFrom*
+ * \param max_n_bufs The maximum number of extracted buffers for one statement
+ * \param row_offsets The returned int32 tensor of shape [n + 1]. The feature vectors of
+ * state i are the rows [row_offsets[i], row_offsets[i + 1]) of the returned tensor
+ * \return A float32 tensor of shape [row_offsets[n], vec_len]. A state that failed during
+ * lowering occupies a single row of zeros
+ */
+runtime::NDArray PackPerStoreFeatures(std::vector<std::vector<float> >* features, int max_n_bufs,
+                                      runtime::NDArray* row_offsets);
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
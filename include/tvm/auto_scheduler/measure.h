@@ -340,9 +340,25 @@ class LocalBuilderNode : public ProgramBuilderNode {
  public:
   /*! \brief Build function. */
   String build_func;
+  /*!
+   * \brief The directory to keep the built artifacts in for reuse.
+   * An empty string disables the artifact cache.
+   */
+  String cache_dir;
+  /*! \brief The cached build results, keyed by the cache key of the MeasureInput. */
+  std::unordered_map<std::string, BuildResult> artifact_cache;
 
   Array<BuildResult> Build(const Array<MeasureInput>& inputs, int verbose) final;
 
+  /*!
+   * \brief Get the key of a MeasureInput in the artifact cache.
+   * Two inputs get the same key iff they lower to the same program for the same target,
+   * i.e. they have the same workload, target, layout rewrite option and transform steps.
+   * \param input The MeasureInput.
+   * \return The cache key.
+   */
+  static std::string GetCacheKey(const MeasureInput& input);
+
   static constexpr const char* _type_key = "auto_scheduler.LocalBuilder";
   TVM_DECLARE_FINAL_OBJECT_INFO(LocalBuilderNode, ProgramBuilderNode);
 };
@@ -359,8 +375,11 @@ class LocalBuilder : public ProgramBuilder {
    * This will be used in a wrapper of the multiprocessing.Process.join().
    * \param n_parallel The number of threads used to build in parallel.
    * \param build_func The name of the registered build function.
+   * \param cache_dir The directory to keep the built artifacts in for reuse.
+   * An empty string disables the artifact cache.
    */
-  LocalBuilder(int timeout, int n_parallel, const String& build_func);
+  LocalBuilder(int timeout, int n_parallel, const String& build_func,
+               const String& cache_dir = "");
 
   TVM_DEFINE_OBJECT_REF_METHODS(LocalBuilder, ProgramBuilder, LocalBuilderNode);
 };
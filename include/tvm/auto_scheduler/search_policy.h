@@ -112,6 +112,39 @@ class PreloadMeasuredStates : public SearchCallback {
                                         PreloadMeasuredStatesNode);
 };
 
+/*! \brief Transfer the best measured states of similar workloads from a log file.
+ * This can warm-start the search of a task with the schedules of other tasks
+ * that have the same compute DAG structure but different shapes. */
+class PreloadTransferredStatesNode : public SearchCallbackNode {
+ public:
+  /*! \brief The name of the record log file. */
+  String filename;
+  /*! \brief The maximum number of states to transfer. */
+  int num_states;
+
+  void Callback(SearchPolicyNode* policy) final;
+
+  static constexpr const char* _type_key = "auto_scheduler.PreloadTransferredStates";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PreloadTransferredStatesNode, SearchCallbackNode);
+};
+
+/*!
+ * \brief Managed reference to PreloadTransferredStatesNode.
+ * \sa PreloadTransferredStatesNode
+ */
+class PreloadTransferredStates : public SearchCallback {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param filename The name of the record log file.
+   * \param num_states The maximum number of states to transfer.
+   */
+  PreloadTransferredStates(String filename, int num_states);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(PreloadTransferredStates, SearchCallback,
+                                        PreloadTransferredStatesNode);
+};
+
 /*! \brief Attribute keys of ops used for SearchPolicy. */
 struct SearchPolicyKey {
   /*! \brief Always apply unroll to the inner most iterator of the specificed iterators. */
@@ -168,6 +201,25 @@ class SearchPolicyNode : public Object {
    */
   void PreloadMeasuredStates(const String& log_file);
 
+  /*!
+   * \brief Set a log file to transfer the best states of similar workloads from.
+   * The log file is read lazily by GetTransferredStates, so the records of the tasks that are
+   * tuned earlier in the same tuning run can be transferred as well.
+   * \param log_file The name of the record log file.
+   * \param num_states The maximum number of states to transfer.
+   */
+  void PreloadTransferredStates(const String& log_file, int num_states);
+
+  /*!
+   * \brief Get the states transferred from similar workloads.
+   * A workload is similar to the one of this search task if it has the same compute DAG
+   * structure (the hash part of the workload key) but different shapes. The transform steps of
+   * the best records of the closest workloads are replayed on the init state of this task, with
+   * the split factors adapted to the new loop extents.
+   * \return The transferred states. They are all valid states of this search task.
+   */
+  Array<State> GetTransferredStates();
+
   /*!
    * \brief Call SearchCallback with the current SearchPolicyNode
    * \param callbacks SearchCallback to be called.
@@ -189,6 +241,14 @@ class SearchPolicyNode : public Object {
   std::vector<State> measured_states_vector_;
   /*! \brief The throughputs of already measured states */
   std::vector<float> measured_states_throughputs_;
+  /*! \brief The log file to transfer states of similar workloads from. */
+  String transfer_log_file_;
+  /*! \brief The maximum number of states to transfer. */
+  int num_transfer_states_{0};
+  /*! \brief Whether the transferred states have been loaded. */
+  bool transfer_loaded_{false};
+  /*! \brief The states transferred from similar workloads. */
+  Array<State> transferred_states_;
 };
 
 /*!
@@ -147,6 +147,12 @@ constexpr const char* kPartitionedFromPattern = "PartitionedFromPattern";
 
 /*! \brief Mark the function as only composed of reshape operations. */
 constexpr const char* kReshapeOnly = "relay.reshape_only";
+
+/*! \brief Mark the function as independent reductions packed by HorizontalFuseOps. */
+constexpr const char* kHorizontallyFused = "relay.horizontally_fused";
+
+/*! \brief Mark the function as a reduction chained into its consumer by FuseOps. */
+constexpr const char* kChainedReductions = "relay.chained_reductions";
 }  // namespace attr
 
 }  // namespace relay
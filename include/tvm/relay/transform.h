@@ -107,12 +107,26 @@ TVM_DLL Pass SplitArgs(int max_function_args);
 /*!
  * \brief Fuse operations into expr into seperate functions.
  *
+ * The pass config option "relay.FuseOps.cost_model" selects the fusion objective: the
+ * pattern rules, or the pattern rules with each fusion priced by a cost model.
+ *
  * \param fuse_opt_level Optimization level. If it is -1 it will be inferred from pass context.
  *
  * \return The pass.
  */
 TVM_DLL Pass FuseOps(int fuse_opt_level = -1);
 
+/*!
+ * \brief Pack the calls to independent small fused functions at the same dependency level
+ * into calls to primitive functions returning the tuple of their outputs, each lowered to one
+ * kernel. The injective functions and the reductions are packed apart.
+ *
+ * The pass is configured by the pass config option "relay.HorizontalFuseOps".
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass HorizontalFuseOps();
+
 /*!
  * \brief The inverse operation of FuseOps. It transforms a fused program returned by
  * FuseOps into the program before FuseOps. (i.e. x == DefuseOps(FuseOps(x)))
@@ -224,6 +238,30 @@ TVM_DLL Pass SimplifyInference();
  */
 TVM_DLL Pass FastMath();
 
+/*!
+ * \brief Reorder the calls of dataflow functions to lower the peak of live bytes.
+ *
+ * The calls are bound with lets in the order found, which the graph and AOT executors follow
+ * instead of the post DFS order of the graph.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass ReorderForMemory();
+
+/*!
+ * \brief Recompute cheap let-bound values before their late uses instead of keeping them
+ * alive, until the estimated peak memory of the functions fits in a budget.
+ *
+ * The values recomputed are the elementwise, broadcast and injective operators, which include
+ * the batch normalization of inference once simplified. The pass is meant for the functions
+ * returned by the gradient passes, whose backward section uses the forward activations.
+ *
+ * \param memory_budget The peak memory allowed in bytes.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass Rematerialize(int64_t memory_budget);
+
 /*!
  * \brief Find Dynamic ops and make them static
  *
@@ -242,6 +280,10 @@ TVM_DLL Pass DynamicToStatic();
  * type information filled in, as well as it's checked type field
  * populated with the result type.
  *
+ * When the pass config option "relay.InferType.incremental" is true, the
+ * functions of the module which are typed and whose calls agree with the types
+ * of the functions they call are not checked again. It is false by default.
+ *
  * \return The pass.
  */
 TVM_DLL Pass InferType();
@@ -330,6 +372,19 @@ TVM_DLL Pass CanonicalizeOps();
  */
 TVM_DLL Pass AlterOpLayout();
 
+/*!
+ * \brief Select the NCHWc blocking of the NCHW convolutions of a function together.
+ *
+ * The kernel time of each candidate blocking comes from the conv2d_NCHWc records of an
+ * autotvm log, or from a default model, and the layout transforms between the convolutions
+ * are priced by their bytes. The assignment minimizing the total is solved on the graph of
+ * the convolutions, and the convolutions are rewritten like in AlterOpLayout. The pass is
+ * configured by the pass config option "relay.SelectGlobalLayout".
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass SelectGlobalLayout();
+
 /*!
  * \brief Do layout rewrite according to the tile structure created by auto-scheduler.
  * \return The pass
@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/crt/simd_emulation.h
+ * \brief Portable emulation of the SIMD intrinsics emitted by the C host code
+ *  generator, for the Arm NEON, Arm DSP and RISC-V packed SIMD instruction sets.
+ *
+ *  The generated code includes this header instead of the headers of the
+ *  compiler when it is compiled with TVM_SIMD_EMULATION defined, so the code
+ *  generated for a microcontroller can be tested on the host. It requires the
+ *  vector extension of GCC or Clang, and only covers the intrinsics used by the
+ *  code generator.
+ */
+
+#ifndef TVM_RUNTIME_CRT_SIMD_EMULATION_H_
+#define TVM_RUNTIME_CRT_SIMD_EMULATION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+/* Arm NEON, 128-bit vectors. */
+
+#define TVM_SIMD_EMULATE_NEON_COMMON(T, E, N, SFX)                                 \
+  typedef E T __attribute__((vector_size(16)));                                   \
+  static inline T vld1q_##SFX(const E* ptr) {                                     \
+    T v;                                                                          \
+    memcpy(&v, ptr, sizeof(v));                                                   \
+    return v;                                                                     \
+  }                                                                               \
+  static inline void vst1q_##SFX(E* ptr, T v) { memcpy(ptr, &v, sizeof(v)); }     \
+  static inline T vdupq_n_##SFX(E x) {                                            \
+    T v;                                                                          \
+    for (int i = 0; i < N; ++i) v[i] = x;                                         \
+    return v;                                                                     \
+  }                                                                               \
+  static inline T vaddq_##SFX(T a, T b) { return a + b; }                         \
+  static inline T vsubq_##SFX(T a, T b) { return a - b; }                         \
+  static inline T vmulq_##SFX(T a, T b) { return a * b; }                         \
+  static inline T vmlaq_##SFX(T acc, T a, T b) { return acc + a * b; }            \
+  static inline T vminq_##SFX(T a, T b) {                                         \
+    T v;                                                                          \
+    for (int i = 0; i < N; ++i) v[i] = a[i] < b[i] ? a[i] : b[i];                 \
+    return v;                                                                     \
+  }                                                                               \
+  static inline T vmaxq_##SFX(T a, T b) {                                         \
+    T v;                                                                          \
+    for (int i = 0; i < N; ++i) v[i] = a[i] > b[i] ? a[i] : b[i];                 \
+    return v;                                                                     \
+  }
+
+#define TVM_SIMD_EMULATE_NEON_INT(T, E, N, SFX, LO, HI)                            \
+  TVM_SIMD_EMULATE_NEON_COMMON(T, E, N, SFX)                                      \
+  static inline T vqaddq_##SFX(T a, T b) {                                        \
+    T v;                                                                          \
+    for (int i = 0; i < N; ++i) {                                                 \
+      int64_t x = (int64_t)a[i] + (int64_t)b[i];                                  \
+      v[i] = (E)(x < (LO) ? (LO) : x > (HI) ? (HI) : x);                          \
+    }                                                                             \
+    return v;                                                                     \
+  }                                                                               \
+  static inline T vqsubq_##SFX(T a, T b) {                                        \
+    T v;                                                                          \
+    for (int i = 0; i < N; ++i) {                                                 \
+      int64_t x = (int64_t)a[i] - (int64_t)b[i];                                  \
+      v[i] = (E)(x < (LO) ? (LO) : x > (HI) ? (HI) : x);                          \
+    }                                                                             \
+    return v;                                                                     \
+  }
+
+TVM_SIMD_EMULATE_NEON_COMMON(float32x4_t, float, 4, f32)
+TVM_SIMD_EMULATE_NEON_INT(int8x16_t, int8_t, 16, s8, INT8_MIN, INT8_MAX)
+TVM_SIMD_EMULATE_NEON_INT(int16x8_t, int16_t, 8, s16, INT16_MIN, INT16_MAX)
+TVM_SIMD_EMULATE_NEON_INT(int32x4_t, int32_t, 4, s32, INT32_MIN, INT32_MAX)
+TVM_SIMD_EMULATE_NEON_INT(uint8x16_t, uint8_t, 16, u8, 0, UINT8_MAX)
+TVM_SIMD_EMULATE_NEON_INT(uint16x8_t, uint16_t, 8, u16, 0, UINT16_MAX)
+TVM_SIMD_EMULATE_NEON_INT(uint32x4_t, uint32_t, 4, u32, 0, UINT32_MAX)
+
+/* Arm DSP and RISC-V packed SIMD, vectors of 8-bit or 16-bit lanes in 32 bits. */
+
+enum { kTVMSIMDAdd, kTVMSIMDSub, kTVMSIMDMin, kTVMSIMDMax };
+
+static inline uint32_t TVMSIMDEmulateLanes(uint32_t a, uint32_t b, int bits, int is_signed,
+                                           int op, int saturate) {
+  uint32_t mask = (1u << bits) - 1;
+  int64_t lo = is_signed ? -((int64_t)1 << (bits - 1)) : 0;
+  int64_t hi = is_signed ? ((int64_t)1 << (bits - 1)) - 1 : ((int64_t)1 << bits) - 1;
+  uint32_t ret = 0;
+  for (int i = 0; i < 32; i += bits) {
+    int64_t x = (a >> i) & mask;
+    int64_t y = (b >> i) & mask;
+    if (is_signed) {
+      x = x > hi ? x - ((int64_t)1 << bits) : x;
+      y = y > hi ? y - ((int64_t)1 << bits) : y;
+    }
+    int64_t v = op == kTVMSIMDAdd   ? x + y
+                : op == kTVMSIMDSub ? x - y
+                : op == kTVMSIMDMin ? (x < y ? x : y)
+                                    : (x > y ? x : y);
+    if (saturate) v = v < lo ? lo : v > hi ? hi : v;
+    ret |= ((uint32_t)v & mask) << i;
+  }
+  return ret;
+}
+
+typedef int32_t int8x4_t;
+typedef uint32_t uint8x4_t;
+typedef int32_t int16x2_t;
+typedef uint32_t uint16x2_t;
+
+#define TVM_SIMD_EMULATE_PACKED(NAME, T, BITS, SIGNED, OP, SATURATE)                    \
+  static inline T NAME(T a, T b) {                                                      \
+    return (T)TVMSIMDEmulateLanes((uint32_t)a, (uint32_t)b, BITS, SIGNED, OP, SATURATE); \
+  }
+
+TVM_SIMD_EMULATE_PACKED(__sadd8, int8x4_t, 8, 1, kTVMSIMDAdd, 0)
+TVM_SIMD_EMULATE_PACKED(__ssub8, int8x4_t, 8, 1, kTVMSIMDSub, 0)
+TVM_SIMD_EMULATE_PACKED(__qadd8, int8x4_t, 8, 1, kTVMSIMDAdd, 1)
+TVM_SIMD_EMULATE_PACKED(__qsub8, int8x4_t, 8, 1, kTVMSIMDSub, 1)
+TVM_SIMD_EMULATE_PACKED(__uadd8, uint8x4_t, 8, 0, kTVMSIMDAdd, 0)
+TVM_SIMD_EMULATE_PACKED(__usub8, uint8x4_t, 8, 0, kTVMSIMDSub, 0)
+TVM_SIMD_EMULATE_PACKED(__uqadd8, uint8x4_t, 8, 0, kTVMSIMDAdd, 1)
+TVM_SIMD_EMULATE_PACKED(__uqsub8, uint8x4_t, 8, 0, kTVMSIMDSub, 1)
+TVM_SIMD_EMULATE_PACKED(__sadd16, int16x2_t, 16, 1, kTVMSIMDAdd, 0)
+TVM_SIMD_EMULATE_PACKED(__ssub16, int16x2_t, 16, 1, kTVMSIMDSub, 0)
+TVM_SIMD_EMULATE_PACKED(__qadd16, int16x2_t, 16, 1, kTVMSIMDAdd, 1)
+TVM_SIMD_EMULATE_PACKED(__qsub16, int16x2_t, 16, 1, kTVMSIMDSub, 1)
+TVM_SIMD_EMULATE_PACKED(__uadd16, uint16x2_t, 16, 0, kTVMSIMDAdd, 0)
+TVM_SIMD_EMULATE_PACKED(__usub16, uint16x2_t, 16, 0, kTVMSIMDSub, 0)
+TVM_SIMD_EMULATE_PACKED(__uqadd16, uint16x2_t, 16, 0, kTVMSIMDAdd, 1)
+TVM_SIMD_EMULATE_PACKED(__uqsub16, uint16x2_t, 16, 0, kTVMSIMDSub, 1)
+
+TVM_SIMD_EMULATE_PACKED(__rv_add8, unsigned long, 8, 0, kTVMSIMDAdd, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_sub8, unsigned long, 8, 0, kTVMSIMDSub, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_kadd8, unsigned long, 8, 1, kTVMSIMDAdd, 1)
+TVM_SIMD_EMULATE_PACKED(__rv_ksub8, unsigned long, 8, 1, kTVMSIMDSub, 1)
+TVM_SIMD_EMULATE_PACKED(__rv_ukadd8, unsigned long, 8, 0, kTVMSIMDAdd, 1)
+TVM_SIMD_EMULATE_PACKED(__rv_uksub8, unsigned long, 8, 0, kTVMSIMDSub, 1)
+TVM_SIMD_EMULATE_PACKED(__rv_smin8, unsigned long, 8, 1, kTVMSIMDMin, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_smax8, unsigned long, 8, 1, kTVMSIMDMax, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_umin8, unsigned long, 8, 0, kTVMSIMDMin, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_umax8, unsigned long, 8, 0, kTVMSIMDMax, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_add16, unsigned long, 16, 0, kTVMSIMDAdd, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_sub16, unsigned long, 16, 0, kTVMSIMDSub, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_kadd16, unsigned long, 16, 1, kTVMSIMDAdd, 1)
+TVM_SIMD_EMULATE_PACKED(__rv_ksub16, unsigned long, 16, 1, kTVMSIMDSub, 1)
+TVM_SIMD_EMULATE_PACKED(__rv_ukadd16, unsigned long, 16, 0, kTVMSIMDAdd, 1)
+TVM_SIMD_EMULATE_PACKED(__rv_uksub16, unsigned long, 16, 0, kTVMSIMDSub, 1)
+TVM_SIMD_EMULATE_PACKED(__rv_smin16, unsigned long, 16, 1, kTVMSIMDMin, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_smax16, unsigned long, 16, 1, kTVMSIMDMax, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_umin16, unsigned long, 16, 0, kTVMSIMDMin, 0)
+TVM_SIMD_EMULATE_PACKED(__rv_umax16, unsigned long, 16, 0, kTVMSIMDMax, 0)
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_SIMD_EMULATION_H_
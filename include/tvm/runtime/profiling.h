@@ -160,7 +160,11 @@ class ReportNode : public Object {
    * Each element is a mapping from metric name to value. Some metrics that
    * appear in every call are "Name" (the function name), "Argument Shapes",
    * and "Duration (us)". Values are one of `String`, `PercentNode`,
-   * `DurationNode`, or `CountNode`.
+   * `DurationNode`, `CountNode`, or `RatioNode`.
+   *
+   * Calls with "FLOPs" and "Bytes" estimates also get the achieved "GFLOPS"
+   * and "GB/s", and "Roofline (%)" if the peak throughput of the hardware was
+   * given to the `Profiler`.
    */
   Array<Map<String, ObjectRef>> calls;
   /*! \brief Metrics collected for the entire run of the model on a per-device basis.
@@ -176,6 +180,14 @@ class ReportNode : public Object {
    * Note that this does not include `device_metrics`, it only includes per-call metrics.
    */
   String AsCSV() const;
+  /*! \brief Output `calls` and `device_metrics` in JSON format.
+   *
+   * The output is a JSON object with the keys "calls" and "device_metrics".
+   * Each metric is either a string or an object of the form `{"count": ...}`,
+   * `{"microseconds": ...}`, `{"percent": ...}` or `{"ratio": ...}`, depending
+   * on its type.
+   */
+  String AsJSON() const;
   /*! \brief Create a human readable table of profiling metrics.
    *  \param aggregate Whether or not to join multiple calls to the same op into a single line.
    *  \param sort Whether or not to sort call frames by descending duration. If
@@ -200,6 +212,49 @@ class Report : public ObjectRef {
   TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(Report, ObjectRef, ReportNode);
 };
 
+/*! \brief Interface for user defined profiling metric collection.
+ *
+ * Users can register their own collector by subclassing this class and
+ * passing it to the `Profiler`. A collector is started right before the timer
+ * of every `StartCall` and stopped right after the timer of the matching
+ * `StopCall`, so collection overhead is not included in the duration.
+ */
+class MetricCollectorNode : public Object {
+ public:
+  /*! \brief Initialization call. Called before profiling begins.
+   * \param devs The devices the profiler will be running on.
+   */
+  virtual void Init(const std::vector<Device>& devs) = 0;
+  /*! \brief Start collecting metrics for a function call.
+   * \param dev The device the call will be run on.
+   * \returns An object used to maintain the state of the metric collection.
+   * This object will be passed to the corresponding `Stop` call. If the device
+   * is not supported, this function should return a nullptr ObjectRef.
+   */
+  virtual ObjectRef Start(Device dev) = 0;
+  /*! \brief Stop collecting metrics.
+   * \param obj The object created by the corresponding `Start` call.
+   * \returns A set of metric names and the associated values. Values must be
+   * one of `DurationNode`, `PercentNode`, `CountNode`, `RatioNode` or `StringObj`.
+   */
+  virtual Map<String, ObjectRef> Stop(ObjectRef obj) = 0;
+
+  virtual ~MetricCollectorNode() {}
+
+  static constexpr const char* _type_key = "runtime.profiling.MetricCollector";
+  TVM_DECLARE_BASE_OBJECT_INFO(MetricCollectorNode, Object);
+};
+
+/*! \brief Wrapper for `MetricCollectorNode`.
+ *
+ * \sa MetricCollectorNode
+ */
+class MetricCollector : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(MetricCollector, ObjectRef,
+                                                    MetricCollectorNode);
+};
+
 /*! Information about a single function or operator call. */
 struct CallFrame {
   /*! Device on which the call was made */
@@ -210,6 +265,10 @@ struct CallFrame {
   Timer timer;
   /*! Extra performance metrics */
   std::unordered_map<std::string, ObjectRef> extra_metrics;
+  /*! User defined metric collectors. Each pair is the MetricCollector and its
+   * associated data (returned from MetricCollectorNode::Start).
+   */
+  std::vector<std::pair<MetricCollector, ObjectRef>> extra_collectors;
 };
 
 /*! Runtime profiler for function and/or operator calls. Used in the graph
@@ -232,6 +291,18 @@ struct CallFrame {
  */
 class Profiler {
  public:
+  /*! \brief Construct a profiler.
+   * \param collectors Additional metric collectors. Their metrics are
+   * attached to every call as extra columns of the report.
+   * \param peak_gflops Peak compute throughput of the hardware in GFLOPS, 0 if unknown.
+   * \param peak_gbps Peak memory bandwidth of the hardware in GB/s, 0 if unknown.
+   *
+   * The peaks are used to compute the percent of the roofline reached by
+   * calls that carry "FLOPs" and "Bytes" metrics.
+   */
+  explicit Profiler(Array<MetricCollector> collectors = {}, double peak_gflops = 0,
+                    double peak_gbps = 0)
+      : collectors_(collectors), peak_gflops_(peak_gflops), peak_gbps_(peak_gbps) {}
   /*! \brief Start the profiler.
    * \param devs The list of devices the profiler will be running on. Should
    *             include all devices used by profiled operators.
@@ -273,7 +344,16 @@ class Profiler {
   bool IsRunning() const { return !global_timers_.empty(); }
 
  private:
+  /*! \brief Add GFLOPS, GB/s and percent of roofline to a call with FLOPs and Bytes metrics.
+   * \param us The duration of the call in microseconds.
+   * \param row The metrics of the call.
+   */
+  void AddRooflineMetrics(double us, std::unordered_map<String, ObjectRef>* row) const;
+
   std::vector<std::pair<Device, Timer>> global_timers_;
+  Array<MetricCollector> collectors_;
+  double peak_gflops_;
+  double peak_gbps_;
   std::vector<CallFrame> calls_;
   std::stack<CallFrame> in_flight_;
 };
@@ -323,6 +403,22 @@ class CountNode : public Object {
   TVM_DECLARE_FINAL_OBJECT_INFO(CountNode, Object);
 };
 
+/* A ratio of two things, e.g. a throughput. Ratios are aggregated as an average weighted by
+ * duration. */
+class RatioNode : public Object {
+ public:
+  /* The ratio as a double precision floating point number. */
+  double ratio;
+
+  /* \brief Construct a new ratio.
+   * \param a The ratio.
+   */
+  explicit RatioNode(double a) : ratio(a) {}
+
+  static constexpr const char* _type_key = "runtime.profiling.Ratio";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RatioNode, Object);
+};
+
 /*! \brief String representation of an array or NDArray shapes
  *  \param shapes Array of NDArrays to get the shapes of.
  *  \return A textual representation of the shapes. For example: `float32[2], int64[1, 2]`.
@@ -34,6 +34,7 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -42,6 +43,20 @@ namespace vm {
 
 struct VMFunction;
 
+/*!
+ * \brief The variants of a kernel specialized for fixed extents of its dynamic
+ *  input dimensions, the VM selects one of them from the input shapes at call time.
+ */
+struct ShapeBucketDispatch {
+  /*! \brief The (flattened argument, axis) positions of the dynamic input dimensions. */
+  std::vector<std::pair<Index, Index>> dynamic_dims;
+  /*!
+   * \brief The extent of all dynamic dimensions for each variant, with the
+   *  packed index of the variant.
+   */
+  std::vector<std::pair<Index, Index>> variants;
+};
+
 /*!
  * \brief The executable emitted by the VM compiler.
  *
@@ -52,6 +67,7 @@ struct VMFunction;
  *  - Constant section, storing the constant pool.
  *  - Primitive name section, containing the function name of the primitive ops
  *  used by the virtual machine.
+ *  - Shape bucket section, containing the specialized variants of the primitive ops.
  *  - Code section, handling the VM functions and bytecode.
  */
 class Executable : public ModuleNode {
@@ -186,6 +202,8 @@ class Executable : public ModuleNode {
   std::unordered_map<std::string, Index> primitive_map;
   /*! \brief The structural hashes of the operators in this function. */
   std::map<Index, Map<String, ObjectRef>> op_attrs;
+  /*! \brief A map from the packed index of a generic kernel to its specialized variants. */
+  std::map<Index, ShapeBucketDispatch> shape_buckets;
   /*! \brief The virtual machine's function table. */
   std::vector<VMFunction> functions;
   /*! \brief The device type for each constant. */
@@ -213,6 +231,13 @@ class Executable : public ModuleNode {
    */
   void SavePrimitiveOpNames(dmlc::Stream* strm);
 
+  /*!
+   * \brief Save the shape bucket dispatch tables.
+   *
+   *  \param strm The input stream.
+   */
+  void SaveShapeBucketSection(dmlc::Stream* strm);
+
   /*!
    * \brief Save the vm functions.
    *
@@ -241,6 +266,13 @@ class Executable : public ModuleNode {
    */
   void LoadPrimitiveOpNames(dmlc::Stream* strm);
 
+  /*!
+   * \brief Load the shape bucket dispatch tables.
+   *
+   * \param strm The input stream.
+   */
+  void LoadShapeBucketSection(dmlc::Stream* strm);
+
   /*!
    * \brief Load the vm functions.
    *
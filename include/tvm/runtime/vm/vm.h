@@ -238,6 +238,16 @@ class VirtualMachine : public runtime::ModuleNode {
   virtual void InvokePacked(Index packed_index, const PackedFunc& func, Index arg_count,
                             Index output_size, const std::vector<ObjectRef>& args);
 
+  /*!
+   * \brief Select the variant of a PackedFunction specialized for the shapes of the arguments.
+   *
+   * \param packed_index The offset of the generic PackedFunction in all functions.
+   * \param args Arguments to the PackedFunction.
+   *
+   * \return The offset of the specialized variant, or packed_index if no variant matches.
+   */
+  Index SelectShapeBucket(Index packed_index, const std::vector<ObjectRef>& args) const;
+
   /*!
    * \brief Initialize the virtual machine for a set of devices.
    * \param devices The set of TVM devices.
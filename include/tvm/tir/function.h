@@ -240,6 +240,17 @@ constexpr const char* kIsEntryFunc = "tir.is_entry_func";
  */
 constexpr const char* kLinkedParams = "tir.linked_params";
 
+/*!
+ * \brief Per-function loop unrolling and vectorization parameters, they
+ *  override the ones of the PassContext.
+ *
+ * Type: Map<String, ObjectRef>, with the optional keys "auto_max_step",
+ *  "auto_max_extent" (Integer), "explicit_unroll" and "predicated_tail" (Bool).
+ *
+ * \sa tvm::tir::transform::ProfileGuidedLoopParams
+ */
+constexpr const char* kLoopParams = "tir.loop_params";
+
 }  // namespace attr
 }  // namespace tir
 }  // namespace tvm
@@ -1224,6 +1224,11 @@ constexpr const char* coproc_scope = "coproc_scope";
 constexpr const char* coproc_uop_scope = "coproc_uop_scope";
 /*! \brief Mark the scope as volatile access for certain handle. */
 constexpr const char* volatile_scope = "volatile_scope";
+/*!
+ * \brief Mark the stores to certain handle in the scope as non-temporal,
+ *  the written data is not expected to be read again soon and can bypass the cache.
+ */
+constexpr const char* nontemporal_store = "nontemporal_store";
 /*!
  * \brief Mark the scope as generated by extern primitive.
  *  such scope can contain arbitrary ir program and we need to be careful
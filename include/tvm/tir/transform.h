@@ -63,6 +63,17 @@ TVM_DLL Pass CreatePrimFuncPass(
  */
 TVM_DLL Pass InjectPrefetch();
 
+/*!
+ * \brief Insert prefetch instructions for the strided and indirect streaming
+ *  accesses of loops in functions bound to an llvm target with software-prefetch set.
+ *
+ *  The prefetch distance is derived from the estimated cost of the loop body
+ *  and the prefetch-latency attribute of the target.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSoftwarePrefetch();
+
 // TODO(tvm-team): consolidate configs to the PassContext
 /*!
  * \brief Flatten the multi-dimensional read/write
@@ -153,6 +164,29 @@ TVM_DLL Pass StorageRewrite();
  */
 TVM_DLL Pass UnrollLoop();
 
+/*!
+ * \brief Pick the loop unrolling and vectorization parameters of the kernels
+ *  that are hot in a profile, by building and measuring a few variants on the host.
+ *
+ *  The pass is configured by the "tir.ProfileGuidedLoopParams" PassContext option
+ *  and annotates the functions with tir::attr::kLoopParams.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass ProfileGuidedLoopParams();
+
+/*!
+ * \brief Lower the parallel loops that only accumulate into one element.
+ *
+ *  Each chunk of the loop accumulates into a private partial result, the
+ *  partial results are combined after the barrier of the parallel group.
+ *  The number of chunks is bounded by the "tir.parallel_reduce_chunks"
+ *  PassContext option, a non-positive value disables the pass.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass LowerParallelReduction();
+
 /*!
  * \brief Remove No Op from the Stmt.
  *
@@ -357,6 +391,15 @@ TVM_DLL Pass PointerValueTypeRewrite();
  */
 TVM_DLL Pass HoistIfThenElse();
 
+/*!
+ * \brief Mark the stores to output buffers that are only written by contiguous
+ *  vector stores and are at least tir.nontemporal_store_threshold bytes large
+ *  as non-temporal, so that they do not evict useful data from the cache.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass AnnotateNontemporalStore();
+
 /*!
  * \brief Lower block init stmt into IfThenElse stmts
  * \return The pass.
@@ -55,6 +55,7 @@ from .search_policy import (
     EmptyPolicy,
     SketchPolicy,
     PreloadMeasuredStates,
+    PreloadTransferredStates,
     PreloadCustomSketchRule,
 )
 from .task_scheduler import TaskScheduler
@@ -25,7 +25,10 @@ import numpy as np
 
 from tvm.autotvm.tuner.metric import max_curve
 from .cost_model import PythonBasedModel
-from ..feature import get_per_store_features_from_measure_pairs, get_per_store_features_from_states
+from ..feature import (
+    get_per_store_features_from_measure_pairs,
+    get_per_store_feature_tensor_from_states,
+)
 from ..measure_record import RecordReader
 
 xgb = None
@@ -229,18 +232,16 @@ class XGBModel(PythonBasedModel):
         scores: List[float]
             The predicted scores for all states
         """
-        features = get_per_store_features_from_states(states, task)
+        features, row_offsets = get_per_store_feature_tensor_from_states(states, task)
         if self.bst is not None and len(self.inputs) > self.num_warmup_sample:
-            dtest, pack_ids = feature_to_pack_sum_xgbmatrix(features)
+            dtest, pack_ids = feature_tensor_to_pack_sum_xgbmatrix(features, row_offsets)
             raw_preds = self.bst.predict(dtest)
             ret = predict_throughput_pack_sum(raw_preds, pack_ids)
         else:
             ret = np.random.uniform(0, 1, (len(states),))
 
         # Predict -inf for invalid states that failed to be lowered.
-        for idx, feature in enumerate(features):
-            if feature.min() == feature.max() == 0:
-                ret[idx] = float("-inf")
+        ret[invalid_state_mask(features, row_offsets)] = float("-inf")
 
         return ret
 
@@ -280,17 +281,15 @@ class XGBModel(PythonBasedModel):
         To implement this format, we also store int as float, so we can store all numbers
         into a single float array.
         """
-        features = get_per_store_features_from_states(states, task)
+        features, row_offsets = get_per_store_feature_tensor_from_states(states, task)
         if self.bst is not None and len(self.inputs) > self.num_warmup_sample:
-            dtest, pack_ids = feature_to_pack_sum_xgbmatrix(features)
+            dtest, pack_ids = feature_tensor_to_pack_sum_xgbmatrix(features, row_offsets)
             raw_preds = self.bst.predict(dtest)
             breakdown = predict_throughput_pack_sum(raw_preds, pack_ids)
-            stage_scores = [[] for _ in range(len(states))]
-            for pred, pack_id in zip(raw_preds, pack_ids):
-                stage_scores[pack_id].append(pred)
-            for idx, stage_score in enumerate(stage_scores):
+            stage_scores = np.split(raw_preds, row_offsets[1:-1])
+            for stage_score in stage_scores:
                 breakdown = np.append(breakdown, len(stage_score))
-                breakdown = np.concatenate((breakdown, np.array(stage_score)))
+                breakdown = np.concatenate((breakdown, stage_score))
         else:
             breakdown = np.concatenate(
                 (
@@ -302,9 +301,7 @@ class XGBModel(PythonBasedModel):
             )
 
         # Predict 0 for invalid states that failed to be lowered.
-        for idx, feature in enumerate(features):
-            if feature.min() == feature.max() == 0:
-                breakdown[idx] = float("-inf")
+        breakdown[: len(states)][invalid_state_mask(features, row_offsets)] = float("-inf")
 
         return breakdown
 
@@ -368,6 +365,43 @@ def feature_to_pack_sum_xgbmatrix(xs):
     return xgb.DMatrix(np.array(x_flatten)), pack_ids
 
 
+def feature_tensor_to_pack_sum_xgbmatrix(features, row_offsets):
+    """Convert a packed feature tensor to a xgbmatrx in pack-sum format
+    Parameters
+    ----------
+    features: np.ndarray
+        The feature vectors of all statements of all states, of shape [n_rows, vec_len]
+    row_offsets: np.ndarray
+        The row offsets of each state in `features`, of shape [n_states + 1]
+    Returns
+    -------
+    dmatrix: xgb.DMatrix
+        The DMatrix
+    pack_ids: np.ndarray
+        pack ids information
+    """
+    pack_ids = np.repeat(np.arange(len(row_offsets) - 1), np.diff(row_offsets))
+    return xgb.DMatrix(features), pack_ids
+
+
+def invalid_state_mask(features, row_offsets):
+    """Find the states that failed to be lowered in a packed feature tensor
+    Parameters
+    ----------
+    features: np.ndarray
+        The feature vectors of all statements of all states, of shape [n_rows, vec_len]
+    row_offsets: np.ndarray
+        The row offsets of each state in `features`, of shape [n_states + 1]
+    Returns
+    -------
+    mask: np.ndarray
+        A boolean mask that is True for states whose features are all zeros
+    """
+    zero_rows = ~features.any(axis=1)
+    # every state owns at least one row, so all segments of reduceat are non-empty
+    return np.logical_and.reduceat(zero_rows, row_offsets[:-1])
+
+
 def pack_sum_xgbmatrix(xs, ys, gids=None, weights=None):
     """Convert (feature, label) pairs into a xgb matrix with pack-sum format
     Parameters
@@ -238,6 +238,43 @@ def get_per_store_features_from_states(
     return unpack_feature(byte_arr)[0]
 
 
+def get_per_store_feature_tensor_from_states(
+    states: List[Union[State, StateObject]], task: "SearchTask", max_n_bufs: Optional[int] = None
+) -> Tuple[np.ndarray, np.ndarray]:
+    """Get per-store features from states as a single packed feature tensor.
+
+    Compared with :code:`get_per_store_features_from_states`, the features of all states
+    are packed into one contiguous float32 array on the c++ side, so no per-state unpacking
+    is needed in python. This is the format consumed by the cost models for prediction.
+
+    Parameters
+    ----------
+    states: List[Union[State, StateObject]]
+        The input states
+    task: SearchTask
+        The search task of the input states
+    max_n_bufs: Optional[int]
+        The maximum number of extracted buffers for one statement
+
+    Returns
+    -------
+    features: np.ndarray
+        Feature vectors of all statements of all states, of shape [n_rows, vec_len]
+    row_offsets: np.ndarray
+        Int32 array of shape [len(states) + 1]. The feature vectors of states[i] are
+        features[row_offsets[i]:row_offsets[i + 1]]. A state that failed during lowering
+        occupies a single row of zeros.
+    """
+    if isinstance(states[0], State):
+        state_objects = [s.state_object for s in states]
+    elif isinstance(states[0], StateObject):
+        state_objects = states
+    features, row_offsets = _ffi_api.GetPerStoreFeatureTensorFromStates(
+        state_objects, task, max_n_bufs or DEFAULT_MAX_N_BUFS
+    )
+    return features.numpy(), row_offsets.numpy()
+
+
 def get_per_store_feature_names(max_n_bufs: Optional[int] = None) -> List[str]:
     """Get the name of every element in the feature vector. Use this for debug and inspection.
 
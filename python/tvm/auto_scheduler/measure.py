@@ -42,8 +42,10 @@ import tvm._ffi
 from tvm.runtime import Object, module, ndarray
 from tvm.driver import build_module
 from tvm.ir import transform
+from tvm.autotvm.env import AutotvmGlobalScope, reset_global_scope
 from tvm.autotvm.measure.measure_methods import set_cuda_target_arch
 from tvm.contrib import tar, ndk
+from tvm.contrib.popen_pool import PopenPoolExecutor, StatusKind
 from tvm.target import Target
 
 
@@ -328,9 +330,19 @@ class LocalBuilder(ProgramBuilder):
         If is 'default', use default build function
         If is 'ndk', use function for android ndk
         If is callable, use it as custom build function, expect lib_format field.
+    cache_dir: Optional[str] = None
+        The directory to keep successfully built artifacts in. Programs that are measured
+        again (e.g. the same state in a later round) reuse the cached artifact instead of
+        being rebuilt. If is None, the artifact cache is disabled.
     """
 
-    def __init__(self, timeout=15, n_parallel=multiprocessing.cpu_count(), build_func="default"):
+    def __init__(
+        self,
+        timeout=15,
+        n_parallel=multiprocessing.cpu_count(),
+        build_func="default",
+        cache_dir=None,
+    ):
         if build_func == "default":
             BuildFunc.name = "default"
             BuildFunc.build_func = tar.tar
@@ -343,8 +355,11 @@ class LocalBuilder(ProgramBuilder):
         else:
             raise ValueError("Invalid build_func" + build_func)
 
+        if cache_dir is not None:
+            os.makedirs(cache_dir, exist_ok=True)
+
         self.__init_handle_by_constructor__(
-            _ffi_api.LocalBuilder, timeout, n_parallel, BuildFunc.name
+            _ffi_api.LocalBuilder, timeout, n_parallel, BuildFunc.name, cache_dir or ""
         )
 
 
@@ -646,35 +661,53 @@ def _timed_func(inp_serialized, build_func, verbose):
 
 def local_build_worker(args):
     """
-    Build function of LocalBuilder to be ran in the Builder thread pool.
+    Build function of LocalBuilder to be ran in the Builder process pool.
 
     Parameters
     ----------
-    args: Tuple[MeasureInput, str, int, int]
-        inputs, build-func, time, verbose args passed to local_builder_build
+    args: Tuple[str, callable, int]
+        The serialized MeasureInput, the build function and the verbosity level.
 
     Returns
     -------
-    res : BuildResult
-        The build result of this Builder thread.
+    res : Tuple
+        The arguments of the BuildResult of this MeasureInput.
     """
-    inp, build_func, timeout, verbose = args
-    assert build_func == BuildFunc.name, (
-        "BuildFunc.name: " + BuildFunc.name + ", but args is: " + build_func
-    )
-    build_func = BuildFunc.build_func
+    inp, build_func, verbose = args
+    return _timed_func(inp, build_func, verbose)
 
-    res = call_func_with_timeout(timeout, _timed_func, args=(inp, build_func, verbose))
-    if isinstance(res, TimeoutError):
-        if verbose >= 1:
-            print(".T", end="", flush=True)  # Build timeout
-        res = None, [], MeasureErrorNo.BUILD_TIMEOUT, None, timeout
-    elif isinstance(res, Exception):
-        if verbose >= 1:
-            print(".E", end="", flush=True)  # Build error
-        res = None, [], MeasureErrorNo.COMPILE_HOST, str(res), timeout
 
-    return res
+class _BuildExecutor:
+    """The process pool of LocalBuilder.
+
+    The worker processes are kept alive across build batches, so the cost of starting
+    a python interpreter and importing tvm is only paid once per worker. They start
+    with a copy of the AutotvmGlobalScope of this process (e.g. the cuda target arch
+    set by set_cuda_target_arch), and the pool is restarted when the scope changes.
+    """
+
+    executor = None
+    n_parallel = None
+    timeout = None
+    global_scope = None
+
+    @staticmethod
+    def get(n_parallel, timeout):
+        scope = AutotvmGlobalScope.current
+        global_scope = {k: v for k, v in scope.__dict__.items() if k != "_old"}
+        if (
+            _BuildExecutor.executor is None
+            or _BuildExecutor.n_parallel != n_parallel
+            or _BuildExecutor.timeout != timeout
+            or _BuildExecutor.global_scope != global_scope
+        ):
+            _BuildExecutor.executor = PopenPoolExecutor(
+                n_parallel, timeout, reset_global_scope, (scope,)
+            )
+            _BuildExecutor.n_parallel = n_parallel
+            _BuildExecutor.timeout = timeout
+            _BuildExecutor.global_scope = global_scope
+        return _BuildExecutor.executor
 
 
 @tvm._ffi.register_func("auto_scheduler.local_builder.build")
@@ -687,10 +720,9 @@ def local_builder_build(inputs, timeout, n_parallel, build_func="default", verbo
     inputs : List[MeasureInput]
         The MeasureInputs to be built.
     timeout : int
-        The timeout limit (in second) for each build thread.
-        This is used in a wrapper of the multiprocessing.Process.join().
+        The timeout limit (in second) for each build.
     n_parallel : int
-        Number of threads used to build in parallel.
+        Number of processes used to build in parallel.
     build_func : str = 'default'
         The name of build function to process the built module.
     verbose: int = 1
@@ -701,31 +733,69 @@ def local_builder_build(inputs, timeout, n_parallel, build_func="default", verbo
     res : List[BuildResult]
         The build results of these MeasureInputs.
     """
-    # This pool is not doing computationally intensive work, so we can use threads
-    pool = multiprocessing.pool.ThreadPool(n_parallel)
-    tuple_res = pool.map(
+    assert build_func == BuildFunc.name, (
+        "BuildFunc.name: " + BuildFunc.name + ", but args is: " + build_func
+    )
+    executor = _BuildExecutor.get(n_parallel, timeout)
+    tuple_res = executor.map_with_error_catching(
         local_build_worker,
         [
             (
                 i.serialize(),
-                build_func,
-                timeout,
+                BuildFunc.build_func,
                 verbose,
             )
             for i in inputs
         ],
     )
-    pool.terminate()
-    pool.join()
-    del pool
 
     results = []
     for res in tuple_res:
-        results.append(BuildResult(*res))
+        if res.status == StatusKind.COMPLETE:
+            results.append(BuildResult(*res.value))
+        elif res.status == StatusKind.TIMEOUT:
+            if verbose >= 1:
+                print(".T", end="", flush=True)  # Build timeout
+            results.append(BuildResult(None, [], MeasureErrorNo.BUILD_TIMEOUT, None, timeout))
+        else:
+            if verbose >= 1:
+                print(".E", end="", flush=True)  # Build error
+            results.append(
+                BuildResult(None, [], MeasureErrorNo.COMPILE_HOST, str(res.value), timeout)
+            )
 
     return results
 
 
+@tvm._ffi.register_func("auto_scheduler.local_builder.copy_artifact")
+def local_builder_copy_artifact(filename, dirname):
+    """
+    Copy a built artifact for the artifact cache of LocalBuilder.
+
+    Parameters
+    ----------
+    filename : str
+        The artifact to be copied.
+    dirname : str
+        The directory to copy the artifact into.
+        If is empty, the artifact is copied into a new temporary directory, which is
+        removed by the runner after the measurement.
+
+    Returns
+    -------
+    res : str
+        The filename of the copy.
+    """
+    if not dirname:
+        dirname = tempfile.mkdtemp()
+    else:
+        # Give each cached artifact its own file name
+        dirname = tempfile.mkdtemp(dir=dirname)
+    new_filename = os.path.join(dirname, os.path.basename(filename))
+    shutil.copyfile(filename, new_filename)
+    return new_filename
+
+
 TASK_INPUT_CHECK_FUNC_REGISTRY = {}
 
 
@@ -61,6 +61,34 @@ class PreloadMeasuredStates(SearchCallback):
         self.__init_handle_by_constructor__(_ffi_api.PreloadMeasuredStates, filename)
 
 
+@tvm._ffi.register_object("auto_scheduler.PreloadTransferredStates")
+class PreloadTransferredStates(SearchCallback):
+    """A SearchCallback to transfer the best measured states of similar workloads
+    from the log file to a search policy.
+
+    A workload is similar if it has the same compute DAG structure but different shapes
+    (e.g., the same operator with a different spatial size). The transform steps of the
+    best records of the closest workloads are replayed on this task, with split factors
+    adapted to the new loop extents, and the resulting states join the initial population
+    of the search.
+
+    The log file is read at the first search round, so the records of tasks tuned earlier
+    in the same tuning run are also used.
+
+    Parameters
+    ----------
+    filename : str
+        The name of the record file.
+    num_states : int = 16
+        The maximum number of states to transfer.
+    """
+
+    def __init__(self, filename, num_states=16):
+        self.__init_handle_by_constructor__(
+            _ffi_api.PreloadTransferredStates, filename, num_states
+        )
+
+
 @tvm._ffi.register_object("auto_scheduler.PreloadCustomSketchRule")
 class PreloadCustomSketchRule(SearchCallback):
     """
@@ -173,6 +201,7 @@ class SketchPolicy(SearchPolicy):
         Possible callbacks:
 
           - auto_scheduler.PreloadMeasuredStates
+          - auto_scheduler.PreloadTransferredStates
           - auto_scheduler.PreloadCustomSketchRule
     """
 
@@ -273,3 +302,16 @@ class SketchPolicy(SearchPolicy):
         """
         states = _ffi_api.SketchPolicyEvolutionarySearch(self, init_populations, out_size)
         return states
+
+    def transferred_states(self):
+        """Get the states transferred from similar workloads by PreloadTransferredStates.
+        This python interface is mainly used for debugging and testing.
+        The actual search is all done in c++.
+
+        Returns
+        -------
+        states: List[State]
+            The transferred states
+        """
+        states = _ffi_api.SearchPolicyGetTransferredStates(self)
+        return states
@@ -29,7 +29,12 @@ import logging
 
 import numpy as np
 
-from .search_policy import SearchPolicy, SketchPolicy, PreloadMeasuredStates
+from .search_policy import (
+    SearchPolicy,
+    SketchPolicy,
+    PreloadMeasuredStates,
+    PreloadTransferredStates,
+)
 from .cost_model import RandomModel, XGBModel
 from .utils import array_mean
 from .measure import ProgramMeasurer
@@ -48,6 +53,7 @@ def make_search_policies(
     load_model_file=None,
     load_log_file=None,
     adapative_training=False,
+    transfer_log_file=None,
 ):
     """Make a list of search policies for a list of search tasks.
     It creates one policy per task.
@@ -74,6 +80,9 @@ def make_search_policies(
     adapative_training: bool = False
         Option used by XGBModel to reduce the model training frequency when there're too
         many logs.
+    transfer_log_file: Optional[str]
+        Transfer the best states of similar workloads from this file to warm-start the
+        search of each task. See `auto_scheduler.PreloadTransferredStates`.
 
     Returns
     -------
@@ -103,18 +112,20 @@ def make_search_policies(
             raise ValueError("Invalid search policy: " + search_policy)
 
         if policy_type == "sketch":
+            init_search_callbacks = []
             if load_log_file:
                 # use the log file to restore the status of search policies.
-                init_search_callbacks = [PreloadMeasuredStates(load_log_file)]
-            else:
-                init_search_callbacks = None
+                init_search_callbacks.append(PreloadMeasuredStates(load_log_file))
+            if transfer_log_file:
+                # warm-start the search with the states of similar workloads.
+                init_search_callbacks.append(PreloadTransferredStates(transfer_log_file))
             search_policies = [
                 SketchPolicy(
                     task,
                     cost_model,
                     params=search_policy_params,
                     verbose=verbose,
-                    init_search_callbacks=init_search_callbacks,
+                    init_search_callbacks=init_search_callbacks or None,
                 )
                 for task in tasks
             ]
@@ -202,6 +213,10 @@ class TaskScheduler:
     callbacks: Optional[List[TaskSchedulerCallback]]
         The task scheduler callbacks that will be called before and after tuning a task.
         If None, PrintTableInfo and LogEstimatedLatency callback will be used.
+    transfer_log_file: Optional[str]
+        Transfer the best states of similar workloads (same compute DAG structure, different
+        shapes) from this file to warm-start the search of each task. This can be the log file
+        of the current tuning run, so tasks reuse the schedules of similar tasks tuned before.
     """
 
     def __init__(
@@ -217,6 +232,7 @@ class TaskScheduler:
         gamma: float = 0.5,
         backward_window_size: int = 3,
         callbacks=None,
+        transfer_log_file: str = None,
     ):
         self.tasks = tasks
         if objective_func:  # use custom objective function
@@ -230,6 +246,7 @@ class TaskScheduler:
         self.strategy = strategy
         self.load_log_file = load_log_file
         self.load_model_file = load_model_file
+        self.transfer_log_file = transfer_log_file
         self.alpha = alpha
         self.beta = beta
         self.gamma = gamma
@@ -348,6 +365,7 @@ class TaskScheduler:
             self.load_model_file,
             self.load_log_file,
             adapative_training,
+            self.transfer_log_file,
         )
 
         # do a round robin first to warm up
@@ -30,3 +30,13 @@ class AutotvmGlobalScope(object):
 
 
 GLOBAL_SCOPE = AutotvmGlobalScope()
+
+
+def reset_global_scope(global_scope):
+    """Reset the global autotvm scope to a copy of another one.
+
+    Used to initialize the worker processes of a PopenPoolExecutor, which do
+    not inherit the state of the parent process.
+    """
+    GLOBAL_SCOPE.__dict__.update({k: v for k, v in global_scope.__dict__.items() if k != "_old"})
+    AutotvmGlobalScope.current = GLOBAL_SCOPE
@@ -268,12 +268,24 @@ class GraphModuleDebug(graph_executor.GraphModule):
         ret = self._run_individual(number, repeat, min_repeat_ms)
         return ret.strip(",").split(",") if ret else []
 
-    def profile(self, **input_dict):
+    def profile(self, collectors=None, peak_gflops=None, peak_gbps=None, **input_dict):
         """Run forward execution of the graph and collect overall and per-op
         performance metrics.
 
         Parameters
         ----------
+        collectors : Optional[Sequence[MetricCollector]]
+            Extra metrics to collect, e.g. hardware counters from
+            :py:class:`tvm.runtime.profiling.PerfEventCollector`.
+
+        peak_gflops : Optional[float]
+            Peak compute throughput of the device in GFLOPS. Together with
+            `peak_gbps` it is used to report the percent of the roofline
+            reached by each operator.
+
+        peak_gbps : Optional[float]
+            Peak memory bandwidth of the device in GB/s.
+
         input_dict : dict of str to NDArray
             List of input values to be feed to
         Return
@@ -284,7 +296,7 @@ class GraphModuleDebug(graph_executor.GraphModule):
         if input_dict:
             self.set_input(**input_dict)
 
-        return self._profile()
+        return self._profile(collectors or [], peak_gflops or 0.0, peak_gbps or 0.0)
 
     def exit(self):
         """Exits the dump folder and all its contents"""
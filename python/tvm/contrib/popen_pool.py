@@ -84,10 +84,21 @@ class PopenWorker:
 
     PopenWorker provides a low-level
     API to interact with a separate process via Popen.
+
+    Parameters
+    ----------
+    initializer: callable or None
+        A callable initializer, or None. It is called in the process each time
+        the process is started, including when it is restarted after a timeout.
+
+    initargs: Tuple[object]
+        A tuple of args for the initializer
     """
 
-    def __init__(self):
+    def __init__(self, initializer=None, initargs=()):
         self._proc = None
+        self._initializer = initializer
+        self._initargs = initargs
 
     def __del__(self):
         try:
@@ -153,6 +164,10 @@ class PopenWorker:
         self._reader = os.fdopen(main_read, "rb")
         self._writer = os.fdopen(main_write, "wb")
 
+        if self._initializer is not None:
+            self.send(self._initializer, self._initargs)
+            self.recv()
+
     def join(self, timeout=None):
         """Join the current process worker before it terminates.
 
@@ -269,12 +284,20 @@ class PopenPoolExecutor:
 
     timeout : float
         Timeout value for each function submit.
+
+    initializer: callable or None
+        A callable initializer, or None, called in each worker process when it starts.
+
+    initargs: Tuple[object]
+        A tuple of args for the initializer
     """
 
-    def __init__(self, max_workers, timeout=None):
+    def __init__(self, max_workers, timeout=None, initializer=None, initargs=()):
         # Use an internal thread pool to send to popen workers
         self._threadpool = concurrent.futures.ThreadPoolExecutor(max_workers=max_workers)
         self._timeout = timeout
+        self._initializer = initializer
+        self._initargs = initargs
         self._worker_map = {}
         self._lock = threading.Lock()
 
@@ -293,7 +316,7 @@ class PopenPoolExecutor:
         self._lock.acquire()
         tid = threading.get_ident()
         if tid not in self._worker_map:
-            proc = PopenWorker()
+            proc = PopenWorker(self._initializer, self._initargs)
             self._worker_map[tid] = proc
         else:
             proc = self._worker_map[tid]
@@ -200,6 +200,7 @@ def _build_for_device(input_mod, target, target_host):
                 or f.attrs["calling_conv"].value != CallingConv.DEVICE_KERNEL_LAUNCH
             ),
             tvm.tir.transform.Apply(lambda f: f.with_attr("target", target_host)),
+            tvm.tir.transform.InjectSoftwarePrefetch(),
             tvm.tir.transform.LowerTVMBuiltin(),
             tvm.tir.transform.LowerDeviceStorageAccessInfo(),
             tvm.tir.transform.LowerCustomDatatypes(),
@@ -0,0 +1,320 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=unused-argument, not-context-manager
+"""Select the dense and conv2d layers to convert to block sparse and their block shape
+
+Unlike ``bsr_dense`` and ``bsr_conv2d``, which convert every weight over a sparsity
+threshold with one block shape, this module measures the density of the nonzero blocks of
+each constant weight for a list of candidate block shapes, estimates the speedup of the
+block sparse kernel over the dense one on the target, and converts the layers whose best
+candidate pays with that block shape.
+"""
+import numpy as np
+import scipy.sparse as sp
+
+import tvm
+from tvm import relay
+
+from .utils import _run_opt_pass
+
+DEFAULT_BLOCK_SIZES = ((1, 1), (4, 1), (8, 1), (16, 1), (32, 1), (4, 4), (8, 8), (16, 16))
+
+
+def block_density(weight, block_size):
+    """The fraction of the blocks of a weight with a nonzero element.
+
+    Parameters
+    ----------
+    weight : numpy.ndarray
+        A 2D weight, whose shape is divisible by the block size.
+    block_size : Tuple(int, int)
+        The block shape.
+
+    Returns
+    -------
+    density : float
+        The fraction of the nonzero blocks.
+    """
+    bs_r, bs_c = block_size
+    rows, cols = weight.shape
+    blocks = weight.reshape(rows // bs_r, bs_r, cols // bs_c, bs_c)
+    return np.count_nonzero(np.any(blocks != 0, axis=(1, 3))) / blocks[:, 0, :, 0].size
+
+
+def _vector_lanes(target):
+    """The float32 lanes of the vector unit of the target."""
+    target = tvm.target.Target(target)
+    if target.kind.name == "cuda":
+        return 32
+    mcpu = str(target.attrs.get("mcpu", ""))
+    if "avx512" in mcpu or mcpu in ("cascadelake", "icelake-server"):
+        return 16
+    if "avx2" in mcpu or mcpu in ("haswell", "skylake", "znver2"):
+        return 8
+    return 4
+
+
+def estimate_speedup(density, block_size, lanes, sparse_efficiency=0.5):
+    """Estimate the speedup of the block sparse kernel over the dense one.
+
+    The dense kernel runs at full efficiency. The block sparse kernel only computes the
+    nonzero blocks, but reads one index per block, and fills the vector lanes with the
+    elements of a block, so small blocks run at a fraction of the efficiency.
+
+    Parameters
+    ----------
+    density : float
+        The fraction of the nonzero blocks.
+    block_size : Tuple(int, int)
+        The block shape.
+    lanes : int
+        The lanes of the vector unit of the target.
+    sparse_efficiency : float
+        The efficiency of the block sparse kernel with full blocks, relative to the dense one.
+
+    Returns
+    -------
+    speedup : float
+        The estimated time of the dense kernel over the one of the block sparse kernel.
+    """
+    block_elems = block_size[0] * block_size[1]
+    efficiency = sparse_efficiency * min(1.0, block_elems / lanes)
+    sparse_cost = density * (1.0 + 1.0 / block_elems) / efficiency
+    return 1.0 / max(sparse_cost, 1e-9)
+
+
+def _find_layers(func, params, layout):
+    """Find the dense and 1x1 conv2d layers with a constant weight.
+
+    Returns a dict from the weight name to the kind of the layer, the number of rows of its
+    input matrix and the 2D weight of shape (output channels, input channels).
+    """
+    func = _run_opt_pass(func, relay.transform.InferType())
+    layers, uses = {}, {}
+
+    def visit(node):
+        if not isinstance(node, relay.Call) or not isinstance(node.op, tvm.ir.Op):
+            return
+        if node.op.name not in ("nn.dense", "nn.conv2d") or len(node.args) < 2:
+            return
+        weight = node.args[1]
+        if not isinstance(weight, relay.Var) or weight.name_hint not in params:
+            return
+        name = weight.name_hint
+        uses[name] = uses.get(name, 0) + 1
+        w_np = params[name].numpy()
+        data_shape = [int(d) for d in node.args[0].checked_type.shape]
+        if node.op.name == "nn.dense":
+            # nn.sparse_dense only takes a 2D input.
+            if len(data_shape) == 2:
+                layers[name] = ("dense", data_shape[0], w_np)
+            return
+        attrs = node.attrs
+        # nn.sparse_conv2d only computes the 1x1 convolutions without stride and padding.
+        if (
+            attrs.data_layout != layout
+            or attrs.groups != 1
+            or any(int(x) != 1 for x in list(attrs.strides) + list(attrs.dilation))
+            or any(int(x) != 0 for x in attrs.padding)
+        ):
+            return
+        if layout == "NHWC":
+            if w_np.shape[0] != 1 or w_np.shape[1] != 1:
+                return
+            w_np = w_np.reshape(w_np.shape[2], w_np.shape[3]).T
+            rows = data_shape[0] * data_shape[1] * data_shape[2]
+        else:
+            if w_np.shape[2] != 1 or w_np.shape[3] != 1:
+                return
+            w_np = w_np.reshape(w_np.shape[0], w_np.shape[1])
+            rows = data_shape[0] * data_shape[2] * data_shape[3]
+        layers[name] = ("conv2d", rows, w_np)
+
+    relay.analysis.post_order_visit(func.body, visit)
+    # A weight shared by several layers keeps its dense form for the others.
+    return {name: layer for name, layer in layers.items() if uses[name] == 1}
+
+
+def _measure_speedup(rows, weight, sparse_weight, target, repeat):
+    """Measure the time of the dense kernel over the one of the block sparse kernel."""
+    # pylint: disable=import-outside-toplevel
+    from tvm.contrib import graph_executor
+
+    dev = tvm.device(tvm.target.Target(target).kind.name, 0)
+    data = relay.var("data", shape=(rows, weight.shape[1]), dtype="float32")
+    bsr = (
+        relay.const(sparse_weight.data),
+        relay.const(sparse_weight.indices),
+        relay.const(sparse_weight.indptr),
+    )
+    times = []
+    for out in [relay.nn.dense(data, relay.const(weight)), relay.nn.sparse_dense(data, bsr)]:
+        mod = tvm.IRModule.from_expr(relay.Function([data], out))
+        with tvm.transform.PassContext(opt_level=3):
+            lib = relay.build(mod, target=target)
+        module = graph_executor.GraphModule(lib["default"](dev))
+        module.set_input("data", np.random.uniform(size=(rows, weight.shape[1])).astype("float32"))
+        ftimer = module.module.time_evaluator("run", dev, number=10, repeat=repeat)
+        times.append(np.median(ftimer().results))
+    return times[0] / times[1]
+
+
+def _register_task_inputs(kind, weight, block_size, sparse_weight, sparse_data):
+    """Register the BSR weight for the sparse tasks of the auto-scheduler."""
+    # pylint: disable=import-outside-toplevel
+    from tvm.auto_scheduler.search_task import (
+        register_task_input_buffer,
+    )  # lazily import to avoid recursive dependency
+
+    prefix = "sparse_%s_bsr_%d_%d_%d_%d_%d_%d_" % (
+        kind,
+        weight.shape[0],
+        weight.shape[1],
+        block_size[0],
+        block_size[1],
+        sparse_weight.indices.shape[0],
+        sparse_weight.indptr.shape[0],
+    )
+    for suffix, value in [
+        ("W_data", sparse_data),
+        ("W_indices", sparse_weight.indices),
+        ("W_indptr", sparse_weight.indptr),
+    ]:
+        register_task_input_buffer(
+            "default", prefix + suffix, tvm.runtime.ndarray.array(value), overwrite=True
+        )
+
+
+def convert(
+    func,
+    params,
+    target="llvm",
+    block_sizes=DEFAULT_BLOCK_SIZES,
+    min_speedup=1.2,
+    measure=False,
+    layout="NHWC",
+    sparse_efficiency=0.5,
+    repeat=3,
+):
+    """Convert the dense and 1x1 conv2d layers whose block sparse form pays to block sparse
+
+    For each constant weight, the density of the nonzero blocks is measured for each
+    candidate block shape dividing the weight, and the speedup of the block sparse kernel is
+    estimated from it. The layer is converted with the candidate of the best speedup, when
+    it is at least ``min_speedup``. With ``measure``, the best candidate is built and timed
+    against the dense kernel on the host instead, which must then be the target.
+
+    Parameters
+    ----------
+    func : relay.Expr
+        Expr will be optimized to sparse operation
+    params : Dict[Srting, tvm.nd.array]
+        Parameters of the Expr, the converted weights are replaced by their BSR arrays
+    target : str or tvm.target.Target
+        The target the speedup is estimated or measured for
+    block_sizes : List[Tuple(int, int)]
+        The candidate block shapes
+    min_speedup : float
+        Minimal speedup of the block sparse kernel for converting a layer
+    measure : bool
+        Whether to measure the speedup of the best candidate on the host
+    layout : str
+        Layout of the conv2d layers to convert
+    sparse_efficiency : float
+        The efficiency of the block sparse kernel with full blocks relative to the dense one,
+        used by the estimate
+    repeat : int
+        The repeats of a measurement
+
+    Returns
+    -------
+    new_func: relay.Expr
+        Mutated Expr with sparse operations
+
+    params: Dict[Srting, tvm.nd.array]
+        New params with BSR matrix for mutated Expr
+
+    report: List[Dict]
+        For each layer considered, its weight name, kind, shape, sparsity, best block size
+        with its density and speedup, and whether it was converted
+    """
+    lanes = _vector_lanes(target)
+    report = []
+    converted = {"dense": ([], []), "conv2d": ([], [])}
+    for name, (kind, rows, w_np) in _find_layers(func, params, layout).items():
+        best = None
+        for block_size in block_sizes:
+            if w_np.shape[0] % block_size[0] or w_np.shape[1] % block_size[1]:
+                continue
+            density = block_density(w_np, block_size)
+            speedup = estimate_speedup(density, block_size, lanes, sparse_efficiency)
+            if best is None or speedup > best[2]:
+                best = (tuple(block_size), density, speedup)
+        if best is None:
+            continue
+        block_size, density, speedup = best
+        sparse_weight = sp.bsr_matrix(w_np, blocksize=block_size)
+        if measure:
+            speedup = _measure_speedup(rows, w_np, sparse_weight, target, repeat)
+        report.append(
+            {
+                "name": name,
+                "kind": kind,
+                "shape": w_np.shape,
+                "sparsity": 1.0 - np.count_nonzero(w_np) / w_np.size,
+                "block_size": block_size,
+                "block_density": density,
+                "speedup": speedup,
+                "converted": speedup >= min_speedup,
+            }
+        )
+        if speedup < min_speedup:
+            continue
+        sparse_data = sparse_weight.data
+        # nn.sparse_conv2d takes the data of the blocks of one column without that dim.
+        if kind == "conv2d" and block_size[1] == 1:
+            sparse_data = sparse_data.reshape(sparse_data.shape[0], block_size[0])
+        del params[name]
+        params[name + ".data"] = tvm.nd.array(sparse_data)
+        params[name + ".indices"] = tvm.nd.array(sparse_weight.indices)
+        params[name + ".indptr"] = tvm.nd.array(sparse_weight.indptr)
+        converted[kind][0].append(name)
+        converted[kind][1].append(
+            list(sparse_data.shape)
+            + list(sparse_weight.indices.shape)
+            + list(sparse_weight.indptr.shape)
+        )
+        _register_task_inputs(kind, w_np, block_size, sparse_weight, sparse_data)
+
+    new_func = func
+    names, shapes = converted["dense"]
+    if names:
+        new_func = _run_opt_pass(
+            new_func,
+            relay.transform.DenseToSparse(
+                tvm.runtime.convert(names), tvm.runtime.convert(shapes)
+            ),
+        )
+    names, shapes = converted["conv2d"]
+    if names:
+        new_func = _run_opt_pass(
+            new_func,
+            relay.transform.Conv2dToSparse(
+                tvm.runtime.convert(names), tvm.runtime.convert(shapes), layout
+            ),
+        )
+    return new_func, params, report
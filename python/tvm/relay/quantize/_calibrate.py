@@ -90,14 +90,67 @@ def collect_stats(mod, dataset, chunk_by=-1):
         yield [np.concatenate(output).reshape(-1) for output in outputs]
 
 
+def stream_stats(mod, dataset, mode, num_bins=8001, num_quantized_bins=255, percentile=0.99999):
+    """Stream the calibration dataset through the profile graph, and find the scales
+    of the quantization points from their histograms.
+
+    The statistics are updated in place for each batch by parallel kernels, so the
+    outputs of the batches are not kept. The dataset is iterated twice, first for the
+    range of each point, then for its histogram, so it should be re-iterable or a
+    callable returning a new iterable. A one-shot iterator, e.g. a generator, is kept
+    in memory for the second pass.
+
+    Parameters
+    ----------
+    mod: Module
+        The simulation graph after annotation.
+
+    dataset: Iterable[NDArray] or Callable[[], Iterable[NDArray]]
+        The calibration dataset.
+
+    mode: str
+        'kl_divergence' or 'percentile'.
+
+    Returns
+    -------
+    ret: list of float
+        The scale of each quantization point.
+    """
+    logging.info("streaming statistics for calibration...")
+    runtime = _get_profile_runtime(mod)
+    num_outputs = runtime.get_num_outputs()
+    stats = _quantize.CalibrationStats(num_outputs, num_bins)
+    if not callable(dataset) and iter(dataset) is dataset:
+        logging.warning("the calibration dataset is an iterator, keeping it for the second pass")
+        dataset = list(dataset)
+    for histogram in [False, True]:
+        num_batches = 0
+        for batch in dataset() if callable(dataset) else dataset:
+            runtime.set_input(**batch)
+            runtime.run()
+            outputs = [runtime.get_output(i) for i in range(num_outputs)]
+            _quantize.UpdateCalibrationStats(stats, outputs, histogram)
+            num_batches += 1
+        if num_batches == 0:
+            raise ValueError(
+                "The calibration dataset is empty in the %s pass, it must be re-iterable"
+                % ("histogram" if histogram else "range")
+            )
+    logging.info("finding threshold with %s for calibration...", mode)
+    scales = _quantize.FindCalibrationScales(stats, mode, num_quantized_bins, percentile)
+    return [scale.value for scale in scales]
+
+
 def _kl_scale(mod, dataset):
     cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with kl for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_kl, samples))
+    if cfg.calibrate_streaming:
+        scales = stream_stats(mod, dataset, "kl_divergence")
+    else:
+        scales = []
+        for samples in collect_stats(mod, dataset, cfg.calibrate_chunk_by):
+            logging.info("finding threshold with kl for calibration...")
+            with mp.Pool() as pool:
+                scales += list(pool.map(_find_scale_by_kl, samples))
 
     def func(_):
         scale = scales[func.scale_idx]
@@ -118,12 +171,14 @@ def _find_scale_by_percentile(arr, percentile=0.99999):
 
 def _percentile_scale(mod, dataset):
     cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with percentile for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_percentile, samples))
+    if cfg.calibrate_streaming:
+        scales = stream_stats(mod, dataset, "percentile")
+    else:
+        scales = []
+        for samples in collect_stats(mod, dataset, cfg.calibrate_chunk_by):
+            logging.info("finding threshold with percentile for calibration...")
+            with mp.Pool() as pool:
+                scales += list(pool.map(_find_scale_by_percentile, samples))
 
     def func(_):
         scale = scales[func.scale_idx]
@@ -86,6 +86,7 @@ class QConfig(Object):
         "debug_enabled_ops": None,
         "rounding": "UPWARD",
         "calibrate_chunk_by": -1,
+        "calibrate_streaming": False,
         "partition_conversions": "disabled",
     }
 
@@ -180,6 +181,12 @@ def qconfig(**kwargs):
     rounding: "UPWARD" or "TONEAREST"
         Rounding direction for fixed point multiplications.
 
+    calibrate_streaming: boolean
+        Whether to stream the calibration dataset through the profile graph and update
+        the histograms of the quantization points in place, in parallel, instead of
+        keeping the outputs of all the batches. The dataset is iterated twice, and the
+        percentile mode is then precise to a bin of the histogram.
+
     partition_conversions: 'disabled', 'enabled', or 'fully_integral'
         If set to 'enabled' or 'fully_integral', partitions a quantized
         result into a module containing
@@ -0,0 +1,182 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Select the precision of each layer of a graph under an output error tolerance."""
+import json
+import logging
+
+import numpy as np
+
+import tvm
+from . import _ffi_api
+from . import mixed_precision  # pylint: disable=unused-import
+from .transform import InferType, ToMixedPrecision
+
+logger = logging.getLogger("mixed_precision")
+
+
+def _lower(mod, mixed_precision_type, keep_fp32_layers):
+    config = {"relay.ToMixedPrecision.keep_fp32_layers": sorted(keep_fp32_layers)}
+    with tvm.transform.PassContext(config=config):
+        return ToMixedPrecision(mixed_precision_type, missing_op_mode=2)(mod)
+
+
+def _build(mod, params, target, debug=False):
+    # pylint: disable=import-outside-toplevel
+    from tvm import relay
+    from tvm.contrib import graph_executor
+    from tvm.contrib.debugger import debug_executor
+
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target=target, params=params)
+    dev = tvm.device(str(target), 0)
+    if debug:
+        return debug_executor.create(lib.get_graph_json(), lib.get_lib(), dev)
+    return graph_executor.GraphModule(lib["default"](dev))
+
+
+def _outputs(module, dataset):
+    outputs = []
+    for batch in dataset:
+        module.set_input(**batch)
+        module.run()
+        outputs.append(
+            [
+                module.get_output(i).numpy().astype("float32")
+                for i in range(module.get_num_outputs())
+            ]
+        )
+    return outputs
+
+
+def _error(outputs, reference):
+    """The largest relative L2 error of an output over the dataset."""
+    error = 0.0
+    for batch, ref_batch in zip(outputs, reference):
+        for out, ref in zip(batch, ref_batch):
+            error = max(error, np.linalg.norm(out - ref) / max(np.linalg.norm(ref), 1e-12))
+    return error
+
+
+def _layer_times(module, layers, dataset):
+    """The time of each layer in FP32 from a profile of the graph, the kernels of the layers
+    are matched in order by the name of their op. Without a match, the times are estimated
+    by the multiply-accumulates of the layers."""
+    report = module.profile(**dataset[0])
+    names = [layer.op.name.split(".")[-1] for layer in layers]
+    times = []
+    for call in json.loads(report.json())["calls"]:
+        if len(times) < len(names) and names[len(times)] in call.get("Name", ""):
+            times.append(call["Duration (us)"]["microseconds"])
+    if len(times) == len(layers):
+        return times
+    logger.warning("cannot match the profiled kernels with the layers, estimate their time")
+    times = []
+    for layer in layers:
+        out_shape = [int(d) for d in layer.checked_type.shape]
+        weight_shape = [int(d) for d in layer.args[1].checked_type.shape]
+        times.append(float(np.prod(out_shape) * np.prod(weight_shape[1:])))
+    return times
+
+
+def search_mixed_precision(
+    mod,
+    params,
+    dataset,
+    tolerance,
+    mixed_precision_type="float16",
+    target="llvm",
+    speedup=2.0,
+):
+    """Lower the precision of the layers of a graph greedily, as long as the output error on
+    a calibration dataset stays within a tolerance.
+
+    The layers are the calls to the ops registered as MIXED_PRECISION_ALWAYS, e.g. the
+    convolutions and the dense layers. The sensitivity of each layer is the output error when
+    only that layer is lowered, and its gain is its FP32 time from a profile of the graph times
+    ``1 - 1 / speedup``. The layers are lowered by decreasing ratio of the gain to the
+    sensitivity, a layer is kept in FP32 when the measured error with it lowered goes over the
+    tolerance. The other ops follow their layers as in :py:func:`ToMixedPrecision`.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The FP32 module.
+
+    params : dict of str to NDArray
+        The parameters of the module.
+
+    dataset : list of dict of str to numpy.ndarray
+        The calibration dataset, the inputs of each batch.
+
+    tolerance : float
+        The largest relative L2 error allowed on an output of the module.
+
+    mixed_precision_type : str
+        The lower precision, "float16" or "bfloat16".
+
+    target : str or tvm.target.Target
+        The target of the builds measuring the error and profiling the layers.
+
+    speedup : float
+        The estimated speedup of a layer in the lower precision.
+
+    Returns
+    -------
+    mod : tvm.IRModule
+        The module with the selected layers in the lower precision.
+
+    report : list of dict
+        The precision selected for each layer, with its op, its sensitivity and its estimated
+        gain in microseconds.
+    """
+    mod = InferType()(mod)
+    layers = list(_ffi_api.MixedPrecisionLayers(mod["main"], mixed_precision_type))
+    all_layers = set(range(len(layers)))
+    reference = _outputs(_build(mod, params, target), dataset)
+    times = _layer_times(_build(mod, params, target, debug=True), layers, dataset)
+
+    def measure(lowered):
+        lowered_mod = _lower(mod, mixed_precision_type, all_layers - set(lowered))
+        return _error(_outputs(_build(lowered_mod, params, target), dataset), reference)
+
+    sensitivity = [measure([i]) for i in range(len(layers))]
+    gains = [t * (1 - 1 / speedup) for t in times]
+    order = sorted(range(len(layers)), key=lambda i: -gains[i] / max(sensitivity[i], 1e-12))
+
+    lowered, error = [], 0.0
+    for i in order:
+        # A layer over the tolerance on its own cannot fit, skip it without a build.
+        if sensitivity[i] > tolerance:
+            continue
+        candidate_error = measure(lowered + [i])
+        if candidate_error <= tolerance:
+            lowered.append(i)
+            error = candidate_error
+    logger.info("%d of %d layers lowered, output error %g", len(lowered), len(layers), error)
+
+    report = []
+    for i, layer in enumerate(layers):
+        report.append(
+            {
+                "layer": i,
+                "op": layer.op.name,
+                "precision": mixed_precision_type if i in lowered else "float32",
+                "sensitivity": sensitivity[i],
+                "gain_us": gains[i],
+            }
+        )
+    return _lower(mod, mixed_precision_type, all_layers - set(lowered)), report
@@ -91,6 +91,10 @@ class FunctionPass(tvm.ir.transform.Pass):
 def InferType():
     """Infer the type of an expr.
 
+    When the config option ``relay.InferType.incremental`` is set to True, the
+    functions of the module which keep valid types from a previous inference
+    are not checked again. The option is False by default.
+
     Returns
     -------
     ret : tvm.transform.Pass
@@ -196,6 +200,49 @@ def FastMath():
     return _ffi_api.FastMath()
 
 
+def ReorderForMemory():
+    """Reorder the calls of dataflow functions to lower the peak of live bytes.
+
+    The graph and AOT executors run the calls in the post DFS order of the graph by
+    default. This pass searches for a topological order with a lower peak of live
+    bytes, and binds the calls with lets in that order, which the executors follow.
+    Set the pass config option ``relay.ReorderForMemory.report`` to log the peak
+    before and after the reordering.
+
+    The pass is at opt_level 4. It runs on the fused functions of a build when
+    it is enabled.
+
+    Returns
+    -------
+    ret: tvm.transform.Pass
+        The registered pass that reorders the calls.
+    """
+    return _ffi_api.ReorderForMemory()
+
+
+def Rematerialize(memory_budget):
+    """Recompute cheap let-bound values before their late uses instead of keeping
+    them alive, until the estimated peak memory of the functions fits in a budget.
+
+    The functions returned by :py:func:`gradient` keep the forward activations alive
+    until the backward section uses them. While the peak of the live bytes is over
+    the budget, the pass recomputes an elementwise, broadcast or injective value that
+    is live but unused at the peak right before its next use. Run
+    :py:func:`SimplifyInference` first to make the batch normalization elementwise.
+
+    Parameters
+    ----------
+    memory_budget : int
+        The peak memory allowed in bytes.
+
+    Returns
+    -------
+    ret: tvm.transform.Pass
+        The registered pass that recomputes the values.
+    """
+    return _ffi_api.Rematerialize(memory_budget)
+
+
 def CanonicalizeOps():
     """Canonicalize special operators to basic operators.
     This can simplify followed analysis, e.g. expanding bias_add to
@@ -260,6 +307,12 @@ def FoldConstantExpr(expr, mod):
 def FoldConstant():
     """Fold the constant expressions in a Relay program.
 
+    The folding is configured by the ``relay.FoldConstant`` PassContext option.
+    With ``{"batch": True}``, the maximal constant subgraphs are collected in one
+    traversal and evaluated together, at most ``batch_size`` of them at a time,
+    with their kernels built into one module. ``{"report": True}`` logs the number
+    of folded subgraphs and the time spent evaluating them.
+
     Returns
     -------
     ret : tvm.transform.Pass
@@ -271,6 +324,15 @@ def FoldConstant():
 def FuseOps(fuse_opt_level=-1):
     """Fuse operators in an expr to a larger operator according to some rules.
 
+    The pass config option ``relay.FuseOps.cost_model`` takes a dict with the
+    fields ``objective`` (``"pattern"``, the default, or ``"cost"``), ``launch_bytes``,
+    ``cache_bytes``, ``max_inputs``, ``fuse_reductions`` and ``report``. With the
+    ``"cost"`` objective, each fusion is priced by the memory traffic it saves minus
+    the inlined values it recomputes, and a group is also fused into the group
+    consuming all its outputs when it pays. Chaining a reduction into the reduction
+    consuming it is only enabled by ``fuse_reductions``, since only the x86 schedules
+    support it.
+
     Parameters
     ----------
     fuse_opt_level : int
@@ -285,6 +347,28 @@ def FuseOps(fuse_opt_level=-1):
     return _ffi_api.FuseOps(fuse_opt_level)
 
 
+def HorizontalFuseOps():
+    """Pack independent small fused operators into one primitive function.
+
+    The calls to fused functions at the same dependency level do not depend on each
+    other. The pass packs them into calls to primitive functions returning the tuple
+    of their outputs, each lowered to one kernel that computes the outputs in turn,
+    which saves the dispatch of the executor for each small operator. The injective
+    functions and the reductions are packed apart. Run it after :py:func:`FuseOps`.
+
+    The pass is at opt_level 4. It runs in a build with a single target when it is
+    enabled. The pass config option ``relay.HorizontalFuseOps`` takes a dict with the
+    fields ``max_group_size``, the maximum number of functions packed together, and
+    ``max_bytes``, the maximum output bytes of a function to pack.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass that packs the fused operators.
+    """
+    return _ffi_api.HorizontalFuseOps()
+
+
 def DefuseOps():
     """The inverse operation of FuseOps. It transforms a fused program returned by FuseOps into the
     program before FuseOps. (i.e., x == DefuseOps(FuseOps(x)))
@@ -419,6 +503,28 @@ def AlterOpLayout():
     return _ffi_api.AlterOpLayout()
 
 
+def SelectGlobalLayout():
+    """Select the NCHWc blocking of the NCHW convolutions of each function together,
+    instead of one convolution at a time like :py:func:`AlterOpLayout`.
+
+    The candidate blockings of a convolution are priced by the conv2d_NCHWc records of
+    an autotvm log, or by a default model, and a layout_transform costs the bytes it
+    moves. The pass minimizes the total cost over the graph of the convolutions, exactly
+    on chains and approximately on DAGs, and rewrites the convolutions to
+    ``nn.contrib_conv2d_NCHWc`` and ``nn.contrib_depthwise_conv2d_NCHWc``.
+
+    The pass config option ``relay.SelectGlobalLayout`` takes a dict with the fields
+    ``log_file``, ``block_sizes``, ``peak_gflops``, ``bandwidth_gbps`` and
+    ``vector_lanes``.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass that selects the layouts of the convolutions.
+    """
+    return _ffi_api.SelectGlobalLayout()
+
+
 class LayoutConfig(object):
     """A structure for customizing the ConvertLayout pass."""
 
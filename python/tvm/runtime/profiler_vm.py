@@ -50,7 +50,9 @@ class VirtualMachineProfiler(vm.VirtualMachine):
         warnings.warn("get_stat has been removed, use profile instead")
         return ""
 
-    def profile(self, *args, func_name="main", **kwargs):
+    def profile(
+        self, *args, func_name="main", collectors=None, peak_gflops=None, peak_gbps=None, **kwargs
+    ):
         """Profile a function call.
 
         Parameters
@@ -58,6 +60,18 @@ class VirtualMachineProfiler(vm.VirtualMachine):
         func_name : str
             The name of the function.
 
+        collectors : Optional[Sequence[MetricCollector]]
+            Extra metrics to collect, e.g. hardware counters from
+            :py:class:`tvm.runtime.profiling.PerfEventCollector`.
+
+        peak_gflops : Optional[float]
+            Peak compute throughput of the device in GFLOPS. Together with
+            `peak_gbps` it is used to report the percent of the roofline
+            reached by each operator.
+
+        peak_gbps : Optional[float]
+            Peak memory bandwidth of the device in GB/s.
+
         args : list[tvm.runtime.NDArray] or list[np.ndarray]
             The arguments to the function.
 
@@ -71,4 +85,4 @@ class VirtualMachineProfiler(vm.VirtualMachine):
         """
         if args or kwargs:
             self.set_input(func_name, *args, **kwargs)
-        return self._profile(func_name)
+        return self._profile(func_name, collectors or [], peak_gflops or 0.0, peak_gbps or 0.0)
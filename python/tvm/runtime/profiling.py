@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """Registration of profiling objects in python."""
+import json
+import os
 
 from .. import _ffi
 from . import Object
@@ -46,3 +48,75 @@ class Report(Object):
             `calls` in CSV format.
         """
         return AsCSV(self)
+
+    def json(self):
+        """Convert this profiling report into JSON format.
+
+        Unlike :py:meth:`csv`, this includes both `calls` and `device_metrics`.
+
+        Returns
+        -------
+        json : str
+            The report in JSON format.
+        """
+        return AsJSON(self)
+
+
+@_ffi.register_object("runtime.profiling.MetricCollector")
+class MetricCollector(Object):
+    """Interface for user defined profiling metric collection."""
+
+
+@_ffi.register_object("runtime.profiling.PerfEventCollector")
+class PerfEventCollector(MetricCollector):
+    """Collects hardware performance counters on CPU using Linux perf_event_open.
+
+    The counters are attached to every operator call as extra columns of the
+    profiling report. TVM must be built with `USE_PERF_EVENT` and the kernel
+    must allow unprivileged access to the counters (see
+    `/proc/sys/kernel/perf_event_paranoid`).
+
+    Parameters
+    ----------
+    events : Optional[Sequence[str]]
+        The events to count. Supported events are "cycles", "instructions",
+        "cache-references", "cache-misses", "branches" and "branch-misses".
+        Defaults to cycles, instructions, cache misses and branch misses.
+    """
+
+    def __init__(self, events=None):
+        if events is None:
+            events = ["cycles", "instructions", "cache-misses", "branch-misses"]
+        # looked up lazily since the collector only exists when built with USE_PERF_EVENT
+        ctor = _ffi.get_global_func("runtime.profiling.PerfEventCollector")
+        self.__init_handle_by_constructor__(ctor, list(events))
+
+
+def save_kernel_profile(report, path):
+    """Accumulate the time spent in each kernel of a profiling report into a kernel profile.
+
+    The profile is a JSON object mapping kernel names to their total time in
+    microseconds. When `path` already exists the times are added to it, so a
+    profile can gather several runs. It is read by the
+    :py:func:`tvm.tir.transform.ProfileGuidedLoopParams` pass through the
+    ``tir.ProfileGuidedLoopParams`` PassContext option.
+
+    Parameters
+    ----------
+    report : Report
+        The report, from the ``profile`` method of the VM or graph executor profilers.
+
+    path : str
+        The path of the kernel profile.
+    """
+    profile = {}
+    if os.path.exists(path):
+        with open(path) as f:
+            profile = json.load(f)
+    for call in json.loads(report.json())["calls"]:
+        duration = call.get("Duration (us)")
+        if "Name" not in call or duration is None:
+            continue
+        profile[call["Name"]] = profile.get(call["Name"], 0.0) + duration["microseconds"]
+    with open(path, "w") as f:
+        json.dump(profile, f, indent=2, sort_keys=True)
@@ -1287,4 +1287,18 @@ def terminate_self():
     sys.exit(-1)
 
 
+TEST_GLOBAL_STATE = None
+
+
+def initializer(state):
+    """Testing function to set a global state of the worker process."""
+    global TEST_GLOBAL_STATE  # pylint: disable=global-statement
+    TEST_GLOBAL_STATE = state
+
+
+def after_initializer():
+    """Testing function to return the global state set by initializer."""
+    return TEST_GLOBAL_STATE
+
+
 tvm._ffi._init_api("testing", __name__)
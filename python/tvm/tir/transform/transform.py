@@ -73,6 +73,22 @@ def InjectPrefetch():
     return _ffi_api.InjectPrefetch()
 
 
+def InjectSoftwarePrefetch():
+    """Insert prefetch instructions for the strided and indirect streaming
+    accesses of loops in functions bound to an llvm target with the
+    software-prefetch attribute set.
+
+    The prefetch distance is derived from the estimated cost of the loop body
+    and the prefetch-latency attribute of the target (in cycles).
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePrefetch()
+
+
 def StorageFlatten(cache_line_size, create_bound_attribute=False):
     """Flatten the multi-dimensional read/write to 1D.
 
@@ -218,6 +234,37 @@ def UnrollLoop():
     return _ffi_api.UnrollLoop()
 
 
+def ProfileGuidedLoopParams():
+    """Pick the loop unrolling and vectorization parameters of the kernels
+    that are hot in a profile, by building and measuring a few variants on the host.
+
+    The pass is configured by the ``tir.ProfileGuidedLoopParams`` PassContext option,
+    see :py:func:`tvm.runtime.profiling.save_kernel_profile` to record a profile.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.ProfileGuidedLoopParams()
+
+
+def LowerParallelReduction():
+    """Lower the parallel loops that only accumulate into one element.
+
+    Each chunk of the loop accumulates into a private partial result, the
+    partial results are combined after the barrier of the parallel group.
+    The number of chunks is bounded by the ``tir.parallel_reduce_chunks``
+    PassContext option, a non-positive value disables the pass.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.LowerParallelReduction()
+
+
 def RemoveNoOp():
     """Remove No Op from the Stmt.
 
@@ -560,6 +607,23 @@ def HoistIfThenElse(variant=None):
         return _ffi_api.HoistIfThenElse()
 
 
+def AnnotateNontemporalStore():
+    """Mark the stores to output buffers that are only written by contiguous
+    vector stores as non-temporal, so that they do not evict useful data from
+    the cache.
+
+    Only buffers of at least the number of bytes given by the PassContext
+    config "tir.nontemporal_store_threshold" (32MB by default, 0 disables the
+    pass) are marked.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.AnnotateNontemporalStore()
+
+
 def LowerInitBlock():
     """Lower block init stmt into IfThenElse stmts
 
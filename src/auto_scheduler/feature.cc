@@ -1585,6 +1585,46 @@ TVMByteArray SerializeFeatures(std::vector<std::vector<float>>&& features,
   return TVMByteArray{out_data->data(), total_bytes};
 }
 
+runtime::NDArray PackPerStoreFeatures(std::vector<std::vector<float>>* features, int max_n_bufs,
+                                      runtime::NDArray* row_offsets) {
+  std::vector<std::string> names;
+  GetPerStoreFeatureName(max_n_bufs, &names);
+  const int64_t vec_len = static_cast<int64_t>(names.size());
+  const int64_t n = static_cast<int64_t>(features->size());
+
+  // Compute the row offsets with a prefix sum over the number of statements of each state.
+  // Every feature vector is laid out as {float n_stmts; float feature_vecs[n_stmts][vec_len]}.
+  *row_offsets = runtime::NDArray::Empty({n + 1}, DLDataType{kDLInt, 32, 1}, {kDLCPU, 0});
+  int32_t* offsets = static_cast<int32_t*>((*row_offsets)->data);
+  offsets[0] = 0;
+  for (int64_t i = 0; i < n; ++i) {
+    const std::vector<float>& fea = (*features)[i];
+    int n_stmts = fea.empty() ? 0 : static_cast<int>(fea[0] + 0.5);
+    if (n_stmts > 0) {
+      ICHECK_EQ(fea.size(), 1 + n_stmts * vec_len) << "The length of feature vector is wrong.";
+    }
+    // failed during lowering, keep a single row of zeros for this state
+    offsets[i + 1] = offsets[i] + std::max(n_stmts, 1);
+  }
+
+  runtime::NDArray ret = runtime::NDArray::Empty({static_cast<int64_t>(offsets[n]), vec_len},
+                                                 DLDataType{kDLFloat, 32, 1}, {kDLCPU, 0});
+  float* data = static_cast<float*>(ret->data);
+  // The rows of a state are only known once it is lowered, so the extracted vectors are
+  // copied, each one is released as soon as it is packed to bound the peak memory.
+  support::parallel_for(0, static_cast<int>(n), [features, offsets, data, vec_len](int i) {
+    std::vector<float>& fea = (*features)[i];
+    float* dst = data + static_cast<int64_t>(offsets[i]) * vec_len;
+    if (fea.size() > 1) {
+      memcpy(dst, fea.data() + 1, sizeof(float) * (fea.size() - 1));
+    } else {
+      std::fill(dst, dst + vec_len, 0.0f);
+    }
+    std::vector<float>().swap(fea);
+  });
+  return ret;
+}
+
 TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeaturesFromFile")
     .set_body([](TVMArgs args, TVMRetValue* ret) {
       std::string filename = args[0];
@@ -1640,6 +1680,16 @@ TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeaturesFromStates")
                                std::move(task_ids), &byte_data);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeatureTensorFromStates")
+    .set_body_typed([](const Array<State>& states, const SearchTask& task, int max_n_bufs) {
+      std::vector<std::vector<float>> features;
+      GetPerStoreFeaturesFromStates(states, task, 0, max_n_bufs, &features);
+
+      runtime::NDArray row_offsets;
+      runtime::NDArray tensor = PackPerStoreFeatures(&features, max_n_bufs, &row_offsets);
+      return Array<runtime::NDArray>{tensor, row_offsets};
+    });
+
 TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeatureNames")
     .set_body([](TVMArgs args, TVMRetValue* ret) {
       int max_n_bufs = args[0];
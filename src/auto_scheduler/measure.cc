@@ -22,10 +22,13 @@
  * \brief Distributed measurement infrastructure to measure the runtime costs of tensor programs.
  */
 
+#include <dmlc/json.h>
 #include <tvm/auto_scheduler/measure.h>
+#include <tvm/auto_scheduler/transform_step.h>
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <sstream>
 
 #include "search_policy/empty_policy.h"
 #include "search_policy/sketch_policy.h"
@@ -106,23 +109,120 @@ MeasureResult MeasureResultNode::copy() const {
 }
 
 /********** LocalBuilder **********/
-LocalBuilder::LocalBuilder(int timeout, int n_parallel, const String& build_func) {
+LocalBuilder::LocalBuilder(int timeout, int n_parallel, const String& build_func,
+                           const String& cache_dir) {
   auto node = make_object<LocalBuilderNode>();
   node->timeout = timeout;
   node->n_parallel = n_parallel;
   node->build_func = build_func;
+  node->cache_dir = cache_dir;
   data_ = std::move(node);
 }
 
+std::string LocalBuilderNode::GetCacheKey(const MeasureInput& input) {
+  const SearchTask& task = input->task;
+  std::ostringstream os;
+  os << task->workload_key << ";" << task->target->str() << ";";
+  if (task->target_host.defined()) {
+    os << task->target_host->str();
+  }
+  os << ";" << static_cast<int>(task->layout_rewrite_option) << ";";
+
+  // The transform steps fully determine the program of a state, serialize them in the same
+  // format as the tuning records
+  dmlc::JSONWriter writer(&os);
+  writer.BeginArray(false);
+  for (const auto& step : input->state->transform_steps) {
+    writer.WriteArraySeperator();
+    writer.BeginArray(false);
+    step->WriteToRecord(&writer);
+    writer.EndArray();
+  }
+  writer.EndArray();
+  return os.str();
+}
+
 Array<BuildResult> LocalBuilderNode::Build(const Array<MeasureInput>& inputs, int verbose) {
-  if (const auto* f = runtime::Registry::Get("auto_scheduler.local_builder.build")) {
-    Array<BuildResult> results = (*f)(inputs, timeout, n_parallel, build_func, verbose);
+  const auto* build = runtime::Registry::Get("auto_scheduler.local_builder.build");
+  if (build == nullptr) {
+    LOG(FATAL) << "auto_scheduler.local_builder.build is not registered. "
+               << "This is a function registered in Python, "
+               << "make sure the TVM Python runtime has been loaded successfully.";
+  }
+  if (cache_dir.empty()) {
+    Array<BuildResult> results = (*build)(inputs, timeout, n_parallel, build_func, verbose);
     return results;
   }
-  LOG(FATAL) << "auto_scheduler.local_builder.build is not registered. "
-             << "This is a function registered in Python, "
-             << "make sure the TVM Python runtime has been loaded successfully.";
-  throw;
+
+  const auto* copy_artifact = runtime::Registry::Get("auto_scheduler.local_builder.copy_artifact");
+  ICHECK(copy_artifact != nullptr) << "auto_scheduler.local_builder.copy_artifact is not "
+                                   << "registered. This is a function registered in Python, "
+                                   << "make sure the TVM Python runtime has been loaded "
+                                   << "successfully.";
+
+  // Only build the inputs that are neither in the cache nor duplicated in this batch
+  std::vector<std::string> keys;
+  std::unordered_map<std::string, size_t> miss_index;
+  Array<MeasureInput> misses;
+  keys.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    keys.push_back(GetCacheKey(input));
+    const std::string& key = keys.back();
+    if (!artifact_cache.count(key) && !miss_index.count(key)) {
+      miss_index[key] = misses.size();
+      misses.push_back(input);
+    }
+  }
+
+  Array<BuildResult> miss_results;
+  if (!misses.empty()) {
+    miss_results = (*build)(misses, timeout, n_parallel, build_func, verbose);
+    ICHECK_EQ(miss_results.size(), misses.size());
+  }
+
+  // Keep a private copy of every successful build in the cache directory, because the runner
+  // removes the artifacts it has measured
+  for (const auto& kv : miss_index) {
+    const BuildResult& res = miss_results[kv.second];
+    if (res->error_no == static_cast<int>(MeasureErrorNO::kNoError)) {
+      String cached_file = (*copy_artifact)(res->filename, cache_dir);
+      artifact_cache[kv.first] =
+          BuildResult(cached_file, res->args, res->error_no, res->error_msg, res->time_cost);
+    }
+  }
+
+  Array<BuildResult> results;
+  results.reserve(inputs.size());
+  std::unordered_set<std::string> returned;
+  int hit_ct = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto miss_it = miss_index.find(keys[i]);
+    if (miss_it != miss_index.end() && returned.insert(keys[i]).second) {
+      // The first occurrence of a newly built input gets the artifact built for it
+      results.push_back(miss_results[miss_it->second]);
+      continue;
+    }
+    auto cache_it = artifact_cache.find(keys[i]);
+    if (cache_it == artifact_cache.end()) {
+      // A duplicate of an input that failed to build in this batch
+      results.push_back(miss_results[miss_it->second]);
+      continue;
+    }
+    // Hand a fresh copy of the cached artifact to the runner
+    auto t_begin = std::chrono::high_resolution_clock::now();
+    const BuildResult& cached = cache_it->second;
+    String filename = (*copy_artifact)(cached->filename, "");
+    double time_cost = std::chrono::duration_cast<std::chrono::duration<double>>(
+                           std::chrono::high_resolution_clock::now() - t_begin)
+                           .count();
+    results.push_back(
+        BuildResult(filename, cached->args, cached->error_no, cached->error_msg, time_cost));
+    hit_ct++;
+  }
+
+  StdCout(verbose, 2) << "LocalBuilder: built " << misses.size() << " programs, reused "
+                      << hit_ct << " cached artifacts." << std::endl;
+  return results;
 }
 
 /********** LocalRunner **********/
@@ -403,8 +503,9 @@ TVM_REGISTER_GLOBAL("auto_scheduler.ProgramRunnerRun")
                        int verbose) { return runner->Run(inputs, build_results, verbose); });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.LocalBuilder")
-    .set_body_typed([](int timeout, int n_parallel, const String& build_func) {
-      return LocalBuilder(timeout, n_parallel, build_func);
+    .set_body_typed([](int timeout, int n_parallel, const String& build_func,
+                       const String& cache_dir) {
+      return LocalBuilder(timeout, n_parallel, build_func, cache_dir);
     });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.LocalRunner")
@@ -26,6 +26,14 @@
 #include <tvm/auto_scheduler/search_policy.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../../support/utils.h"
 #include "utils.h"
 
 namespace tvm {
@@ -34,6 +42,7 @@ namespace auto_scheduler {
 TVM_REGISTER_OBJECT_TYPE(SearchCallbackNode);
 TVM_REGISTER_OBJECT_TYPE(SearchPolicyNode);
 TVM_REGISTER_OBJECT_TYPE(PreloadMeasuredStatesNode);
+TVM_REGISTER_OBJECT_TYPE(PreloadTransferredStatesNode);
 
 void SearchPolicyNode::PreloadMeasuredStates(const String& log_file) {
   RecordReader reader = RecordReader(log_file);
@@ -81,6 +90,170 @@ void SearchPolicyNode::PreloadMeasuredStates(const String& log_file) {
   }
 }
 
+/*!
+ * \brief Decode a workload key "[func_name/hash, args ...]" to the name and the flattened
+ * arguments. This follows `decode_workload_key` in python/tvm/auto_scheduler/utils.py.
+ */
+static std::pair<std::string, std::vector<std::string>> DecodeWorkloadKey(
+    const std::string& workload_key) {
+  std::string flat;
+  for (char c : workload_key) {
+    if (c != '[' && c != ']' && c != ' ') {
+      flat.push_back(c);
+    }
+  }
+  std::vector<std::string> items = support::Split(flat, ',');
+  if (items.empty()) {
+    return std::make_pair(workload_key, std::vector<std::string>());
+  }
+  std::string name = items[0];
+  items.erase(items.begin());
+  return std::make_pair(name, items);
+}
+
+/*!
+ * \brief Compute the shape distance of a candidate workload to the target workload.
+ * Two workloads are compatible if they have the same name/hash and the same non-integer
+ * arguments. The distance of compatible workloads is the sum of the absolute log ratios of
+ * their integer arguments, so 0 means identical workloads.
+ * \return The distance, or infinity if the workloads are not compatible.
+ */
+static double WorkloadDistance(
+    const std::pair<std::string, std::vector<std::string>>& target,
+    const std::pair<std::string, std::vector<std::string>>& candidate) {
+  if (target.first != candidate.first || target.second.size() != candidate.second.size()) {
+    return std::numeric_limits<double>::infinity();
+  }
+  double dis = 0.0;
+  for (size_t i = 0; i < target.second.size(); ++i) {
+    const std::string& target_arg = target.second[i];
+    const std::string& arg = candidate.second[i];
+    if (support::IsNumber(target_arg) && support::IsNumber(arg)) {
+      int64_t target_value = std::stoll(target_arg);
+      int64_t value = std::stoll(arg);
+      if (target_value > 0 && value > 0) {
+        dis += std::fabs(std::log(static_cast<double>(target_value) / value));
+        continue;
+      }
+    }
+    if (target_arg != arg) {
+      return std::numeric_limits<double>::infinity();
+    }
+  }
+  return dis;
+}
+
+/*!
+ * \brief Adapt the split factors of a split step to a new extent.
+ * The factors are chosen from the innermost level outwards, each one as the largest divisor of
+ * the remaining extent that does not exceed the original factor.
+ */
+static Array<Optional<Integer>> AdaptSplitLengths(const SplitStepNode* ps, int64_t extent) {
+  std::vector<Optional<Integer>> lengths(ps->lengths.begin(), ps->lengths.end());
+  int64_t remaining = extent;
+  for (size_t i = 0; i < lengths.size(); ++i) {
+    size_t idx = ps->inner_to_outer ? lengths.size() - 1 - i : i;
+    if (!lengths[idx]) {
+      continue;
+    }
+    int64_t factor = std::max<int64_t>(1, std::min(GetIntImm(lengths[idx].value()), remaining));
+    while (remaining % factor != 0) {
+      factor--;
+    }
+    lengths[idx] = Integer(static_cast<int>(factor));
+    remaining /= factor;
+  }
+  return Array<Optional<Integer>>(lengths.begin(), lengths.end());
+}
+
+/*!
+ * \brief Replay transform steps recorded for another workload on the init state of a task.
+ * \return The replayed state, or an undefined state if the steps do not fit this task.
+ */
+static State ReplayTransferredSteps(const ComputeDAG& dag, const Array<Step>& steps) {
+  State state = dag->init_state;
+  try {
+    for (const auto& step : steps) {
+      Step new_step = step;
+      if (auto ps = step.as<SplitStepNode>()) {
+        // Split extents are only known for the iterators before compute_at, infer the bound of
+        // the partial state if it is not available
+        if (!state->stages[ps->stage_id]->iters[ps->iter_id]->range.defined()) {
+          state = dag.InferBound(state);
+        }
+        const Iterator& it = state->stages[ps->stage_id]->iters[ps->iter_id];
+        if (it->range.defined() && it->range->extent->IsInstance<IntImmNode>()) {
+          int64_t extent = GetIntImm(it->range->extent);
+          new_step = SplitStep(ps->stage_id, ps->iter_id, it->range->extent,
+                               AdaptSplitLengths(ps, extent), ps->inner_to_outer);
+        }
+      }
+      state.CopyOnWrite()->transform_steps.push_back(new_step);
+      StepApplyToState(new_step, &state, dag);
+    }
+    return dag.InferBound(state);
+  } catch (Error& e) {
+    return State();
+  }
+}
+
+void SearchPolicyNode::PreloadTransferredStates(const String& log_file, int num_states) {
+  transfer_log_file_ = log_file;
+  num_transfer_states_ = num_states;
+  transfer_loaded_ = false;
+  transferred_states_.clear();
+}
+
+Array<State> SearchPolicyNode::GetTransferredStates() {
+  if (transfer_loaded_ || transfer_log_file_.empty() || num_transfer_states_ <= 0) {
+    return transferred_states_;
+  }
+  transfer_loaded_ = true;
+
+  RecordReader reader = RecordReader(transfer_log_file_);
+  const auto& res = reader->ReadLines(-1);
+  const auto& target_key = DecodeWorkloadKey(search_task->workload_key);
+
+  // Collect the valid records of compatible workloads, ordered by their shape distance to this
+  // task and then by the measured time cost
+  std::vector<std::tuple<double, double, size_t>> candidates;
+  for (size_t i = 0; i < res.first.size(); ++i) {
+    const auto& inp = res.first[i];
+    if (res.second[i]->error_no != static_cast<int>(MeasureErrorNO::kNoError) ||
+        inp->task->workload_key == search_task->workload_key ||
+        inp->task->target->kind->name != search_task->target->kind->name) {
+      continue;
+    }
+    double dis = WorkloadDistance(target_key, DecodeWorkloadKey(inp->task->workload_key));
+    if (std::isinf(dis)) {
+      continue;
+    }
+    candidates.emplace_back(dis, FloatArrayMean(res.second[i]->costs), i);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  std::unordered_set<std::string> transferred_strs;
+  for (const auto& candidate : candidates) {
+    if (static_cast<int>(transferred_states_.size()) >= num_transfer_states_) {
+      break;
+    }
+    const auto& inp = res.first[std::get<2>(candidate)];
+    State state = ReplayTransferredSteps(search_task->compute_dag, inp->state->transform_steps);
+    if (!state.defined()) {
+      continue;
+    }
+    std::string state_str = state.ToStr();
+    if (!measured_states_set_.count(state_str) && transferred_strs.insert(state_str).second) {
+      transferred_states_.push_back(std::move(state));
+    }
+  }
+
+  StdCout(verbose) << "SearchPolicy: Transferred " << transferred_states_.size()
+                   << " states of similar workloads from " << transfer_log_file_ << " for "
+                   << search_task->workload_key << std::endl;
+  return transferred_states_;
+}
+
 void SearchPolicyNode::RunCallbacks(const Array<SearchCallback>& callbacks) {
   for (const auto& callback : callbacks) {
     callback->Callback(this);
@@ -97,6 +270,17 @@ void PreloadMeasuredStatesNode::Callback(SearchPolicyNode* policy) {
   policy->PreloadMeasuredStates(filename);
 }
 
+PreloadTransferredStates::PreloadTransferredStates(String filename, int num_states) {
+  auto node = make_object<PreloadTransferredStatesNode>();
+  node->filename = std::move(filename);
+  node->num_states = num_states;
+  data_ = std::move(node);
+}
+
+void PreloadTransferredStatesNode::Callback(SearchPolicyNode* policy) {
+  policy->PreloadTransferredStates(filename, num_states);
+}
+
 TVM_REGISTER_GLOBAL("auto_scheduler.SearchPolicyRunCallbacks")
     .set_body_typed([](SearchPolicy policy, Optional<Array<SearchCallback>> callbacks) {
       if (callbacks) {
@@ -119,5 +303,13 @@ TVM_REGISTER_GLOBAL("auto_scheduler.PreloadMeasuredStates").set_body_typed([](St
   return PreloadMeasuredStates(filename);
 });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.PreloadTransferredStates")
+    .set_body_typed([](String filename, int num_states) {
+      return PreloadTransferredStates(filename, num_states);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.SearchPolicyGetTransferredStates")
+    .set_body_typed([](SearchPolicy policy) { return policy->GetTransferredStates(); });
+
 }  // namespace auto_scheduler
 }  // namespace tvm
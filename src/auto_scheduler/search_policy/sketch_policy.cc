@@ -86,6 +86,8 @@ SketchPolicy::SketchPolicy(SearchTask task, CostModel program_cost_model,
     // Candidates:
     // - auto_scheduler.PreloadMeasuredStates: Load already measured states to
     //   `measured_states_set_`, `measured_states_vector_` and `measured_states_throughputs_`.
+    // - auto_scheduler.PreloadTransferredStates: Set the log file to transfer the states of
+    //   similar workloads from. They join the initial population of the search.
     // - auto_scheduler.PreloadCustomSketchRule: Add user custom sketch rules to `sketch_rules`,
     //   these rules will be processed prior to the default rules.
     node->RunCallbacks(init_search_callbacks.value());
@@ -299,16 +301,32 @@ Array<State> SketchPolicyNode::SearchOneRound(int num_random_states, Array<State
   Array<State> init_population = SampleInitPopulation(sketch_cache_);
 
   // 3. Perform evolutionary search.
-  // Also insert already measured good states to the initial population
+  // Also insert already measured good states and the states transferred from similar workloads
+  // to the initial population
   std::vector<int> indices = Argsort(measured_states_throughputs_);
   for (int i = 0; i < num_use_measured; i++) {
     init_population.push_back(measured_states_vector_[indices[i]]);
   }
+  Array<State> transferred_states = GetTransferredStates();
+  for (const auto& state : transferred_states) {
+    init_population.push_back(state);
+  }
   // Sample some random states for eps-greedy
   if (num_random_states > 0 && random_states != nullptr) {
     *random_states = RandomSampleStates(init_population, &rand_gen, num_random_states);
   }
-  return EvolutionarySearch(init_population, num_measure_per_iter_ * 2);
+  Array<State> best_states = EvolutionarySearch(init_population, num_measure_per_iter_ * 2);
+
+  if (measured_states_vector_.empty() && !transferred_states.empty()) {
+    // The cost model cannot rank the transferred states before the first measurement,
+    // so put them in front of the states picked by the evolutionary search
+    Array<State> out_states = transferred_states;
+    for (const auto& state : best_states) {
+      out_states.push_back(state);
+    }
+    return out_states;
+  }
+  return best_states;
 }
 
 Array<State> SketchPolicyNode::GenerateSketches() {
@@ -227,6 +227,7 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition, bool for
   pass_list.push_back(tir::transform::BF16Legalize());
   pass_list.push_back(tir::transform::NarrowDataType(32));
   pass_list.push_back(tir::transform::Simplify());
+  pass_list.push_back(tir::transform::LowerParallelReduction());
 
   // Add user-defined phase-1 passes
   pass_list.insert(pass_list.end(), user_lower_phase1.begin(), user_lower_phase1.end());
@@ -236,6 +237,7 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition, bool for
     pass_list.push_back(tir::transform::LoopPartition());
   }
 
+  pass_list.push_back(tir::transform::ProfileGuidedLoopParams());
   pass_list.push_back(tir::transform::VectorizeLoop(!disable_vectorize));
   pass_list.push_back(tir::transform::InjectVirtualThread());
   pass_list.push_back(tir::transform::InjectDoubleBuffer());
@@ -250,6 +252,7 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition, bool for
   pass_list.push_back(tir::transform::RemoveNoOp());
   pass_list.push_back(tir::transform::RewriteUnsafeSelect());
   pass_list.push_back(tir::transform::HoistIfThenElse());
+  pass_list.push_back(tir::transform::AnnotateNontemporalStore());
 
   // Add user-defined phase-3 passes
   pass_list.insert(pass_list.end(), user_lower_phase3.begin(), user_lower_phase3.end());
@@ -402,6 +405,7 @@ std::pair<IRModule, IRModule> SplitDevHostFuncs(IRModule mod_mixed, const Target
                CallingConv::kDeviceKernelLaunch;
       }),
       BindTarget(target_host),
+      tir::transform::InjectSoftwarePrefetch(),
       tir::transform::LowerTVMBuiltin(),
       tir::transform::LowerCustomDatatypes(),
       tir::transform::LowerIntrin(),
@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <list>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "compile_engine.h"
@@ -131,7 +132,13 @@ class AOTOnDemandAllocator : public ExprVisitor {
 
   void VisitExpr_(const IfNode* op) final { LOG(FATAL) << "if is not supported."; }
 
-  void VisitExpr_(const LetNode* op) final { LOG(FATAL) << "let is not supported."; }
+  void VisitExpr_(const LetNode* op) final {
+    // The let binds a call to the order it runs in, the variable aliases its storage.
+    storage_device_map_[op->var] = GetStorage(op->value);
+    Expr expr = GetRef<Expr>(op);
+    storage_device_map_[expr] = GetStorage(op->body);
+    AssignReturnSid(expr);
+  }
 
  private:
   void AssignReturnSid(Expr e) {
@@ -518,6 +525,7 @@ class AOTExecutorCodegen : public ExprVisitor {
 
   void VisitExpr_(const VarNode* op) override {
     Expr expr = GetRef<Expr>(op);
+    if (let_bound_vars_.count(expr)) return;
     StorageInfo& sinfo = storage_device_map_[expr];
 
     // If the Var node is an output node we need to copy the content of the variable to the output
@@ -566,8 +574,10 @@ class AOTExecutorCodegen : public ExprVisitor {
   }
 
   void VisitExpr_(const LetNode* op) override {
-    // TODO(giuseros): support Let nodes in AOT
-    CHECK(false) << "Let not yet implemented in AOT";
+    // The value is written in the storage of the variable, which is never copied.
+    let_bound_vars_.insert(op->var);
+    VisitExpr(op->value);
+    VisitExpr(op->body);
   }
   void VisitExpr_(const TupleGetItemNode* op) override { VisitExpr(op->tuple); }
   void VisitExpr_(const OpNode* op) override {
@@ -678,6 +688,8 @@ class AOTExecutorCodegen : public ExprVisitor {
   std::unordered_map<std::string, runtime::NDArray> params_;
   /*! \brief mapping between expression and parameters */
   Map<Expr, String> params_by_expr_;
+  /*! \brief the variables bound by lets, which alias the storage of their values */
+  std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> let_bound_vars_;
   /*! \brief mapping between parameter names ("p0", "p1", etc..) and storage identifiers*/
   std::unordered_map<std::string, int64_t> param_storage_ids_;
 
@@ -420,8 +420,20 @@ class RelayBuildModule : public runtime::ModuleNode {
     // and vendor-provided libraries. So we don't handle for now.
     relay_module = transform::Inline()(relay_module);
     relay_module = transform::InferType()(relay_module);
+
+    // Pack the independent small fused operators into one kernel each, to save their dispatch.
+    Pass horizontal_pass = transform::HorizontalFuseOps();
+    if (targets_.size() == 1 && pass_ctx.PassEnabled(horizontal_pass->Info())) {
+      relay_module = horizontal_pass(relay_module);
+    }
     relay_module = transform::LabelOps()(relay_module);
 
+    // Reorder the fused calls to lower the peak memory, the executors run them in the new order.
+    Pass reorder_pass = transform::ReorderForMemory();
+    if (pass_ctx.PassEnabled(reorder_pass->Info())) {
+      relay_module = reorder_pass(relay_module);
+    }
+
     ICHECK(relay_module.defined());
 
     return relay_module;
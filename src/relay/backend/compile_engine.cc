@@ -41,6 +41,7 @@
 #include <limits>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -107,6 +108,11 @@ class ScheduleGetter : public backend::MemoizedExprTranslator<Array<te::Tensor>>
   CachedFunc Create(const Function& prim_func) {
     auto cache_node = make_object<CachedFuncNode>();
     cache_node->target = target_;
+    // The independent reductions packed by HorizontalFuseOps share the reduce schedule, and so
+    // do the reductions chained by FuseOps on x86, the only target whose schedules chain them.
+    multiple_reductions_ = prim_func->HasNonzeroAttr(attr::kHorizontallyFused) ||
+                           (prim_func->HasNonzeroAttr(attr::kChainedReductions) &&
+                            target_->kind->name == "llvm");
     for (Var param : prim_func->params) {
       Array<tvm::te::Tensor> inputs;
       if (const auto* ttype = param->checked_type().as<TensorTypeNode>()) {
@@ -247,7 +253,9 @@ class ScheduleGetter : public backend::MemoizedExprTranslator<Array<te::Tensor>>
 
     int op_pattern = fpattern[op];
     if (!use_auto_scheduler_ && op_pattern >= kCommReduce) {
-      ICHECK(!anchor_op_.defined() || anchor_op_pattern_ < kCommReduce)
+      ICHECK(!anchor_op_.defined() || anchor_op_pattern_ < kCommReduce ||
+             (multiple_reductions_ && op_pattern == kCommReduce &&
+              anchor_op_pattern_ == kCommReduce))
           << "Cannot apply TOPI schedule to a primitive function with two complicated ops"
           << " anchor=" << anchor_op_ << " current=" << op;
     }
@@ -314,6 +322,8 @@ class ScheduleGetter : public backend::MemoizedExprTranslator<Array<te::Tensor>>
   std::ostringstream readable_name_stream_;
   Array<te::Operation> scalars_;
   bool use_auto_scheduler_;
+  // Whether the function may hold several reductions sharing the reduce schedule
+  bool multiple_reductions_{false};
   // Cache device copy op for equivalence checking to reduce registry lookup
   // overhead for each invocation of call node when retrieving schedules.
   const Op& device_copy_op_;
@@ -632,6 +642,42 @@ class CompileEngineImpl : public CompileEngineNode {
     return value->packed_func;
   }
 
+  void JITBatch(const Array<CCacheKey>& keys) final {
+    auto mangle_fn = [](String name) { return name; };
+    // The functions to build for a target, they are built into one module.
+    struct Batch {
+      Target target;
+      IRModule funcs;
+      std::vector<CCacheValue> values;
+    };
+    std::unordered_map<std::string, Batch> batches;
+    std::unordered_set<const CCacheValueNode*> seen;
+    for (const CCacheKey& key : keys) {
+      if (key->source_func->GetAttr<String>(attr::kCompiler).defined()) continue;
+      CCacheValue value = LowerInternal(key, mangle_fn);
+      if (value->packed_func != nullptr || !seen.insert(value.operator->()).second) continue;
+      Batch& batch = batches[key->target->str()];
+      if (!batch.funcs.defined()) {
+        batch.target = key->target;
+        batch.funcs = IRModule();
+      }
+      batch.funcs->Update(value->cached_func->funcs);
+      batch.values.push_back(value);
+    }
+    for (auto& kv : batches) {
+      Batch& batch = kv.second;
+      tvm::runtime::Module m;
+      if (const auto* f = runtime::Registry::Get("relay.backend.build")) {
+        m = (*f)(batch.funcs, batch.target);
+      } else {
+        m = build(batch.funcs, batch.target, Target(nullptr));
+      }
+      for (CCacheValue& value : batch.values) {
+        value->packed_func = m.GetFunction(value->cached_func->func_name);
+      }
+    }
+  }
+
   CachedFunc LowerShapeFunc(const CCacheKey& key) final {
     return LowerShapeFuncInternal(key)->cached_func;
   }
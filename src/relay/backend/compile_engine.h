@@ -209,6 +209,12 @@ class CompileEngineNode : public Object {
    * \return The result.
    */
   virtual PackedFunc JIT(const CCacheKey& key) = 0;
+  /*!
+   * \brief Just in time compile the functions that are not compiled yet into one module,
+   *  so a later JIT of any of the keys returns without building.
+   * \param keys The keys to the cached functions.
+   */
+  virtual void JITBatch(const Array<CCacheKey>& keys) = 0;
   /*!
    * \brief Lower the shape function.
    * \param key The key to the cached function.
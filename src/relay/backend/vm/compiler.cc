@@ -247,6 +247,74 @@ int GetFallbackDevice() {
   return fallback_dev->value;
 }
 
+/*!
+ * \brief Collect the dynamic dimensions of the inputs of a primitive function.
+ * \param func The primitive function.
+ * \return The (flattened argument, axis) position of each dynamic dimension.
+ */
+std::vector<std::pair<Index, Index>> DynamicInputDims(const Function& func) {
+  std::vector<std::pair<Index, Index>> dims;
+  Index arg = 0;
+  for (const auto& param : func->params) {
+    for (const auto& ttype : FlattenTupleType(param->checked_type())) {
+      for (size_t axis = 0; axis < ttype->shape.size(); ++axis) {
+        if (ttype->shape[axis].as<AnyNode>()) {
+          dims.emplace_back(arg, static_cast<Index>(axis));
+        }
+      }
+      ++arg;
+    }
+  }
+  return dims;
+}
+
+/*!
+ * \brief Specialize a primitive function for a fixed extent of all its dynamic input dimensions.
+ * \param func The primitive function.
+ * \param extent The extent given to the dynamic dimensions.
+ * \return The specialized function, or NullOpt if it does not type check.
+ */
+Optional<Function> SpecializeDynamicShape(const Function& func, int64_t extent) {
+  auto specialize = [extent](const TensorType& ttype) {
+    Array<PrimExpr> shape;
+    for (const auto& dim : ttype->shape) {
+      shape.push_back(dim.as<AnyNode>() ? PrimExpr(IntImm(DataType::Int(32), extent)) : dim);
+    }
+    return TensorType(shape, ttype->dtype);
+  };
+  Array<Var> params;
+  tvm::Map<Var, Expr> bind_map;
+  for (const auto& param : func->params) {
+    Type type;
+    if (const auto* tt = param->checked_type().as<TensorTypeNode>()) {
+      type = specialize(GetRef<TensorType>(tt));
+    } else if (const auto* tuple = param->checked_type().as<TupleTypeNode>()) {
+      Array<Type> fields;
+      for (const auto& field : tuple->fields) {
+        const auto* ft = field.as<TensorTypeNode>();
+        if (ft == nullptr) return NullOpt;
+        fields.push_back(specialize(GetRef<TensorType>(ft)));
+      }
+      type = TupleType(fields);
+    } else {
+      return NullOpt;
+    }
+    Var var(param->name_hint(), type);
+    params.push_back(var);
+    bind_map.Set(param, var);
+  }
+  Function spec(params, Bind(func->body, bind_map), Type(), {}, func->attrs);
+  try {
+    auto mod = transform::InferType()(IRModule::FromExpr(spec));
+    return Downcast<Function>(mod->Lookup("main"));
+  } catch (const Error& e) {
+    DLOG(INFO) << "Cannot specialize " << func << " for extent " << extent << ": " << e.what();
+    return NullOpt;
+  }
+}
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.shape_buckets", Array<Integer>);
+
 class VMFunctionCompiler : ExprFunctor<void(const Expr& expr)> {
  public:
   VMFunctionCompiler(VMCompilerContext* context, TargetsMap targets, Target target_host,
@@ -573,10 +641,53 @@ class VMFunctionCompiler : ExprFunctor<void(const Expr& expr)> {
     // Extract functions attrs
     op_attrs[op_index] = func->attrs->dict;
 
+    if (!func->GetAttr<String>(attr::kCompiler).defined()) {
+      EmitShapeBuckets(func, target, op_index);
+    }
+
     Emit(Instruction::InvokePacked(op_index, argument_registers.size(), output_tuple->fields.size(),
                                    argument_registers));
   }
 
+  /*!
+   * \brief Lower the variants of a dynamic kernel specialized for the configured shape buckets.
+   * \param func The primitive function.
+   * \param target The target of the kernel.
+   * \param op_index The packed index of the generic kernel.
+   */
+  void EmitShapeBuckets(const Function& func, const Target& target, Index op_index) {
+    auto buckets = transform::PassContext::Current()->GetConfig<Array<Integer>>(
+        "relay.backend.shape_buckets", Array<Integer>());
+    if (buckets.value().empty() || context_->shape_buckets.count(op_index)) return;
+    ShapeBucketDispatch dispatch;
+    dispatch.dynamic_dims = DynamicInputDims(func);
+    if (dispatch.dynamic_dims.empty()) return;
+    for (const Integer& bucket : buckets.value()) {
+      int64_t extent = bucket->value;
+      auto spec = SpecializeDynamicShape(func, extent);
+      if (!spec.defined()) continue;
+      auto mangle_fn = [extent](String name) {
+        return name + "_bucket" + std::to_string(extent);
+      };
+      auto cfunc = engine_->Lower(CCacheKey(spec.value(), target), mangle_fn);
+      ICHECK_EQ(cfunc->funcs->functions.size(), 1);
+      auto pfunc = Downcast<tir::PrimFunc>((*cfunc->funcs->functions.begin()).second);
+      Index variant_index;
+      if (context_->seen_funcs.find(pfunc) == context_->seen_funcs.end()) {
+        variant_index = context_->cached_funcs.size();
+        context_->cached_funcs.push_back(cfunc);
+        context_->seen_funcs[pfunc] = variant_index;
+      } else {
+        variant_index = context_->seen_funcs[pfunc];
+      }
+      op_attrs[variant_index] = func->attrs->dict;
+      dispatch.variants.emplace_back(extent, variant_index);
+    }
+    if (!dispatch.variants.empty()) {
+      context_->shape_buckets[op_index] = dispatch;
+    }
+  }
+
   void VisitExpr_(const CallNode* call_node) {
     Expr op = call_node->op;
 
@@ -980,6 +1091,9 @@ void VMCompiler::Lower(IRModule mod, const TargetsMap& targets, const tvm::Targe
   for (const auto& cfunc : context_.cached_funcs) {
     exec_->primitive_map.insert({cfunc->func_name, primitive_index++});
   }
+
+  // update shape bucket dispatch tables
+  exec_->shape_buckets = context_.shape_buckets;
 }
 
 transform::Sequential MemoryOpt(tvm::Target host_target, TargetsMap targets) {
@@ -34,6 +34,7 @@
 #include <tvm/tir/function.h>
 
 #include <iostream>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -83,6 +84,8 @@ struct VMCompilerContext {
   std::vector<CachedFunc> cached_funcs;
   // The functions that have been lowered.
   std::unordered_map<tir::PrimFunc, size_t, ObjectPtrHash, ObjectPtrEqual> seen_funcs;
+  // The specialized variants of the dynamic kernels, keyed by the index of the generic kernel.
+  std::map<Index, runtime::vm::ShapeBucketDispatch> shape_buckets;
 };
 
 class VMCompiler : public runtime::ModuleNode {
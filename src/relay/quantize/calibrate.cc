@@ -26,8 +26,15 @@
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <vector>
 
 #include "./quantize.h"
 
@@ -214,6 +221,162 @@ TVM_REGISTER_GLOBAL("relay._quantize.FindScaleByKLMinimization")
       ret[0] = MinimizeKL(hist, hist_edges, num_bins, num_quantized_bins);
     });
 
+/*!
+ * \brief The statistics of the quantization points of a profile graph, updated in place
+ *  batch by batch instead of keeping the outputs of all the batches.
+ *
+ * The histograms need the range of each point over the whole dataset, so the dataset is
+ * streamed twice: the first pass updates the range and the second one the histograms.
+ */
+class CalibrationStatsNode : public Object {
+ public:
+  /*! \brief The number of bins of the histograms. */
+  int num_bins;
+  /*! \brief The maximum absolute value of each point. */
+  std::vector<float> max_abs;
+  /*! \brief The histogram of each point over (-max_abs, max_abs). */
+  std::vector<std::vector<int64_t>> hist;
+
+  void VisitAttrs(tvm::AttrVisitor* v) { v->Visit("num_bins", &num_bins); }
+
+  static constexpr const char* _type_key = "relay.quantize.CalibrationStats";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CalibrationStatsNode, Object);
+};
+
+class CalibrationStats : public ObjectRef {
+ public:
+  CalibrationStats(int num_points, int num_bins) {
+    auto n = make_object<CalibrationStatsNode>();
+    n->num_bins = num_bins;
+    n->max_abs.assign(num_points, 0.f);
+    n->hist.assign(num_points, std::vector<int64_t>(num_bins, 0));
+    data_ = std::move(n);
+  }
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CalibrationStats, ObjectRef, CalibrationStatsNode);
+};
+
+TVM_REGISTER_NODE_TYPE(CalibrationStatsNode);
+
+/*! \brief The histogram range of a point, np.histogram widens an empty range. */
+static float HistRange(float max_abs) { return max_abs > 0 ? max_abs : 0.5f; }
+
+/*!
+ * \brief Update the statistics with the outputs of the profile graph for a batch. The
+ *  outputs are split in chunks updated in parallel, and merged into the points under a lock.
+ * \param stats The statistics.
+ * \param outputs The output of each quantization point.
+ * \param histogram Whether to update the histograms, or the ranges.
+ */
+void UpdateCalibrationStats(CalibrationStats stats, Array<runtime::NDArray> outputs,
+                            bool histogram) {
+  constexpr int64_t kChunkSize = 1 << 16;
+  int num_points = stats->max_abs.size();
+  ICHECK_EQ(static_cast<int>(outputs.size()), num_points)
+      << "Expect the outputs of " << num_points << " points";
+  std::vector<runtime::NDArray> data;
+  std::vector<std::pair<int, int64_t>> chunks;
+  for (int i = 0; i < num_points; ++i) {
+    runtime::NDArray arr = outputs[i];
+    if (arr->device.device_type != kDLCPU) arr = arr.CopyTo(Device{kDLCPU, 0});
+    ICHECK(arr.DataType() == DataType::Float(32)) << "Expect float32 quantization points";
+    ICHECK(arr.IsContiguous());
+    int64_t size = runtime::GetDataSize(*arr.operator->()) / sizeof(float);
+    for (int64_t begin = 0; begin < size; begin += kChunkSize) chunks.emplace_back(i, begin);
+    data.push_back(arr);
+  }
+  int num_bins = stats->num_bins;
+  std::unique_ptr<std::mutex[]> locks(new std::mutex[num_points]);
+  support::parallel_for(0, chunks.size(), [&](int c) {
+    int i = chunks[c].first;
+    const float* ptr = static_cast<const float*>(data[i]->data) + chunks[c].second;
+    int64_t size = runtime::GetDataSize(*data[i].operator->()) / sizeof(float);
+    int64_t n = std::min(kChunkSize, size - chunks[c].second);
+    if (!histogram) {
+      float max_abs = 0.f;
+      for (int64_t k = 0; k < n; ++k) {
+        float x = std::fabs(ptr[k]);
+        max_abs = x > max_abs ? x : max_abs;
+      }
+      std::lock_guard<std::mutex> lock(locks[i]);
+      stats->max_abs[i] = std::max(stats->max_abs[i], max_abs);
+      return;
+    }
+    // The binning of np.histogram, the upper edge falls in the last bin.
+    double range = HistRange(stats->max_abs[i]);
+    double norm = num_bins / (2 * range);
+    std::vector<int64_t> local(num_bins, 0);
+    for (int64_t k = 0; k < n; ++k) {
+      double x = ptr[k];
+      if (!(x >= -range && x <= range)) continue;
+      int64_t bin = static_cast<int64_t>((x + range) * norm);
+      local[std::min<int64_t>(bin, num_bins - 1)] += 1;
+    }
+    std::lock_guard<std::mutex> lock(locks[i]);
+    std::vector<int64_t>& hist = stats->hist[i];
+    for (int b = 0; b < num_bins; ++b) hist[b] += local[b];
+  });
+}
+
+/*!
+ * \brief Find the scale of each quantization point from its histogram, in parallel.
+ * \param stats The statistics.
+ * \param mode "kl_divergence" or "percentile".
+ * \param num_quantized_bins The number of bins of the quantized distribution, for KL.
+ * \param percentile The percentile of the absolute values, found to the precision of a bin.
+ * \return The scales.
+ */
+Array<FloatImm> FindCalibrationScales(CalibrationStats stats, String mode,
+                                      int num_quantized_bins, double percentile) {
+  ICHECK(mode == "kl_divergence" || mode == "percentile") << "Unknown calibrate mode " << mode;
+  int num_points = stats->max_abs.size();
+  int num_bins = stats->num_bins;
+  std::vector<float> scales(num_points);
+  support::parallel_for(0, num_points, [&](int i) {
+    const std::vector<int64_t>& hist = stats->hist[i];
+    float range = HistRange(stats->max_abs[i]);
+    std::vector<float> hist_edges(num_bins + 1);
+    for (int b = 0; b <= num_bins; ++b) {
+      hist_edges[b] = -range + 2.0 * range * b / num_bins;
+    }
+    if (mode == "kl_divergence") {
+      std::vector<int> counts(num_bins);
+      for (int b = 0; b < num_bins; ++b) {
+        counts[b] = static_cast<int>(std::min<int64_t>(hist[b], std::numeric_limits<int>::max()));
+      }
+      scales[i] = MinimizeKL(counts, hist_edges, num_bins, num_quantized_bins);
+      return;
+    }
+    // Fold the histogram on the absolute values, and interpolate in the bin of the percentile.
+    int64_t total = std::accumulate(hist.begin(), hist.end(), int64_t(0));
+    double rank = static_cast<int64_t>(total * percentile);
+    int64_t seen = 0;
+    scales[i] = range;
+    for (int lo = (num_bins - 1) / 2, hi = num_bins / 2; hi < num_bins; --lo, ++hi) {
+      int64_t count = hist[hi] + (lo != hi ? hist[lo] : 0);
+      if (seen + count > rank) {
+        float begin = std::max(0.f, hist_edges[hi]);
+        scales[i] = begin + (hist_edges[hi + 1] - begin) * (rank - seen + 1) / count;
+        break;
+      }
+      seen += count;
+    }
+  });
+  Array<FloatImm> ret;
+  for (float scale : scales) ret.push_back(FloatImm(DataType::Float(32), scale));
+  return ret;
+}
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStats").set_body_typed([](int num_points,
+                                                                           int num_bins) {
+  return CalibrationStats(num_points, num_bins);
+});
+
+TVM_REGISTER_GLOBAL("relay._quantize.UpdateCalibrationStats")
+    .set_body_typed(UpdateCalibrationStats);
+
+TVM_REGISTER_GLOBAL("relay._quantize.FindCalibrationScales").set_body_typed(FindCalibrationScales);
+
 }  // namespace quantize
 }  // namespace relay
 }  // namespace tvm
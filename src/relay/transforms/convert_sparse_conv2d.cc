@@ -111,7 +111,7 @@ class Conv2dToSparseConv2dMutator : public ExprRewriter {
           Var weight_indices(prefix + ".indices", ws_indices_type);
           Var weight_indptr(prefix + ".indptr", ws_indptr_type);
           auto attrs = make_object<SparseConv2DAttrs>();
-          attrs->layout = std::move(layout_);
+          attrs->layout = layout_;
           return Call(sparse_conv2d_op_, {data, weight_data, weight_indices, weight_indptr},
                       Attrs(attrs));
         }
@@ -30,6 +30,12 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+#include <vector>
+
+#include "../backend/compile_engine.h"
 #include "pattern_utils.h"
 
 namespace tvm {
@@ -37,6 +43,35 @@ namespace relay {
 
 using FInterpreter = runtime::TypedPackedFunc<ObjectRef(Expr)>;
 
+/*! \brief Configuration of the constant folding. */
+struct FoldConstantConfigNode : public tvm::AttrsNode<FoldConstantConfigNode> {
+  bool batch;
+  int batch_size;
+  bool report;
+
+  TVM_DECLARE_ATTRS(FoldConstantConfigNode, "relay.transform.FoldConstantConfig") {
+    TVM_ATTR_FIELD(batch)
+        .describe(
+            "Collect the maximal constant subgraphs in one traversal and evaluate them together, "
+            "with their kernels built into one module")
+        .set_default(false);
+    TVM_ATTR_FIELD(batch_size)
+        .describe("Maximum number of subgraphs evaluated together in batch mode")
+        .set_default(1024);
+    TVM_ATTR_FIELD(report)
+        .describe("Log the number of folded subgraphs and the time spent evaluating them")
+        .set_default(false);
+  }
+};
+
+class FoldConstantConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(FoldConstantConfig, Attrs, FoldConstantConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(FoldConstantConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FoldConstant", FoldConstantConfig);
+
 class ConstantChecker : private ExprVisitor {
  public:
   // Check whether an expression is constant. The results are memoized.
@@ -76,8 +111,16 @@ TVM_REGISTER_GLOBAL("relay.analysis.check_constant").set_body_typed(ConstantChec
 // or make a more powerful partial evaluator.
 class ConstantFolder : public MixedModeMutator {
  public:
-  explicit ConstantFolder(IRModule module)
-      : module_(module),
+  /*!
+   * \brief Create a constant folder.
+   * \param module The module of the folded expressions.
+   * \param batch_size The maximum number of subgraphs evaluated together by
+   *  EvaluateDeferred, 0 evaluates each foldable call on its own.
+   */
+  explicit ConstantFolder(IRModule module, int batch_size = 0)
+      : batch_(batch_size > 0),
+        batch_size_(batch_size),
+        module_(module),
         device_copy_op_(Op::Get("device_copy")),
         shape_of_op_(Op::Get("shape_of")),
         vm_shape_of_op_(Op::Get("vm.shape_of")),
@@ -171,19 +214,25 @@ class ConstantFolder : public MixedModeMutator {
     if (const auto* call_node = call->op.as<OpNode>()) {
       Op op = GetRef<Op>(call_node);
       if ((fnoncomputational.count(op) && fnoncomputational[op]) || (call->op == device_copy_op_)) {
+        for (const Expr& arg : call->args) MarkDeferredEscape(arg);
         return GetRef<Call>(call);
       }
     }
 
     bool all_const_args = true;
     for (Expr arg : call->args) {
-      if (!checker_.Check(arg)) {
+      if (!IsFoldable(arg)) {
         all_const_args = false;
       }
     }
     if (all_const_args) {
+      if (batch_) {
+        for (const Expr& arg : call->args) MarkDeferredChild(arg);
+        return Defer(post);
+      }
       return ConstEvaluate(post);
     } else {
+      for (const Expr& arg : call->args) MarkDeferredEscape(arg);
       return post;
     }
   }
@@ -192,12 +241,118 @@ class ConstantFolder : public MixedModeMutator {
     op = post.as<TupleGetItemNode>();
     if (const auto* tuple = op->tuple.as<TupleNode>()) {
       return tuple->fields[op->index];
+    } else if (deferred_.count(op->tuple)) {
+      MarkDeferredChild(op->tuple);
+      return Defer(post);
     } else {
       return post;
     }
   }
 
+  /*! \return Whether evaluations were deferred by the last traversal. */
+  bool HasDeferred() const { return !deferred_order_.empty(); }
+
+  /*!
+   * \brief Evaluate the maximal deferred subgraphs together in one program,
+   *  and replace them by their values.
+   * \param expr The expression returned by the traversal.
+   * \return The expression with the values of the deferred subgraphs.
+   */
+  Expr EvaluateDeferred(const Expr& expr) {
+    Array<Expr> roots;
+    for (const Expr& e : deferred_order_) {
+      if (!deferred_children_.count(e) || deferred_escapes_.count(e)) roots.push_back(e);
+    }
+    deferred_.clear();
+    deferred_order_.clear();
+    deferred_children_.clear();
+    deferred_escapes_.clear();
+    if (roots.empty()) return expr;
+    Array<Expr> values;
+    for (size_t begin = 0; begin < roots.size(); begin += batch_size_) {
+      size_t end = std::min(roots.size(), begin + batch_size_);
+      Array<Expr> batch(roots.begin() + begin, roots.begin() + end);
+      const auto* batch_values = ConstEvaluate(Tuple(batch)).as<TupleNode>();
+      ICHECK(batch_values != nullptr && batch_values->fields.size() == batch.size());
+      values.insert(values.end(), batch_values->fields.begin(), batch_values->fields.end());
+    }
+    num_folded_ += roots.size();
+    return DeferredSubstitutor(roots, values).Mutate(expr);
+  }
+
+  /*! \brief Number of calls to the evaluator. */
+  int num_evaluations() const { return num_evaluations_; }
+  /*! \brief Number of subgraphs replaced by the values evaluated by EvaluateDeferred. */
+  int num_folded() const { return num_folded_; }
+  /*! \brief Time spent in the evaluator, in seconds. */
+  double evaluation_time() const { return evaluation_time_; }
+
  private:
+  /*! \brief Replace the deferred subgraphs by their values. */
+  class DeferredSubstitutor : public MixedModeMutator {
+   public:
+    DeferredSubstitutor(const Array<Expr>& roots, const Array<Expr>& values) {
+      for (size_t i = 0; i < roots.size(); ++i) {
+        memo_[roots[i]] = values[i];
+      }
+    }
+  };
+
+  // Whether an expression is constant, or will be once the deferred subgraphs are evaluated.
+  bool IsFoldable(const Expr& expr) {
+    if (!batch_) return checker_.Check(expr);
+    if (deferred_.count(expr)) return true;
+    if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const auto& field : tuple->fields) {
+        if (!IsFoldable(field)) return false;
+      }
+      return true;
+    }
+    return checker_.Check(expr);
+  }
+
+  Expr Defer(const Expr& expr) {
+    if (deferred_.insert(expr).second) {
+      deferred_order_.push_back(expr);
+    }
+    return expr;
+  }
+
+  // A deferred subgraph consumed by another one is not evaluated on its own.
+  void MarkDeferredChild(const Expr& expr) {
+    if (deferred_.count(expr)) {
+      deferred_children_.insert(expr);
+    } else if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const auto& field : tuple->fields) MarkDeferredChild(field);
+    }
+  }
+
+  // A deferred subgraph consumed by a call that is not folded is evaluated on its own,
+  // even when other deferred subgraphs consume it too. The ones only consumed by other
+  // expressions, e.g. let bindings, are evaluated by the next traversal.
+  void MarkDeferredEscape(const Expr& expr) {
+    if (deferred_.count(expr)) {
+      deferred_escapes_.insert(expr);
+    } else if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const auto& field : tuple->fields) MarkDeferredEscape(field);
+    }
+  }
+
+  // Whether the evaluations are deferred.
+  bool batch_;
+  // The maximum number of subgraphs evaluated together.
+  size_t batch_size_;
+  // The deferred foldable expressions, in post order.
+  std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> deferred_;
+  std::vector<Expr> deferred_order_;
+  // The deferred expressions consumed by other deferred expressions.
+  std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> deferred_children_;
+  // The deferred expressions consumed by calls that are not folded.
+  std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> deferred_escapes_;
+  // Statistics of the evaluations.
+  int num_evaluations_{0};
+  int num_folded_{0};
+  double evaluation_time_{0};
   // Internal constant checker
   ConstantChecker checker_;
   // Module
@@ -229,6 +384,7 @@ class ConstantFolder : public MixedModeMutator {
   }
   // Constant evaluate an expression.
   Expr ConstEvaluate(Expr expr) {
+    auto start = std::chrono::high_resolution_clock::now();
     std::vector<transform::Pass> passes = {transform::FuseOps(0), transform::ToANormalForm(),
                                            transform::InferType()};
     Function func;
@@ -256,8 +412,31 @@ class ConstantFolder : public MixedModeMutator {
     // needed for both execution and creation(due to JIT)
     With<PassContext> fresh_build_ctx(PassContext::Create());
 
+    if (batch_) {
+      // Build the kernels of the batch into one module, instead of one module per kernel.
+      // The program is in A-normal form, walk its bindings instead of recursing into it.
+      Array<CCacheKey> keys;
+      auto add_key = [&keys, &target](const Expr& e) {
+        const auto* func = e.as<FunctionNode>();
+        if (func != nullptr && func->HasNonzeroAttr(attr::kPrimitive)) {
+          keys.push_back(CCacheKey(GetRef<Function>(func), target));
+        }
+      };
+      for (const auto* let = entry_func->body.as<LetNode>(); let != nullptr;
+           let = let->body.as<LetNode>()) {
+        add_key(let->value);
+        if (const auto* call = let->value.as<CallNode>()) add_key(call->op);
+      }
+      CompileEngine::Global()->JITBatch(keys);
+    }
+
     FInterpreter executor = CreateInterpreter(mod, dev, target);
-    return ObjectToExpr(executor(expr));
+    Expr ret = ObjectToExpr(executor(expr));
+    ++num_evaluations_;
+    evaluation_time_ += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() -
+                                                      start)
+                            .count();
+    return ret;
   }
 
   // Evaluate a call to the shape_of operator for tensors with constant
@@ -370,7 +549,41 @@ class ConstantFolder : public MixedModeMutator {
 };
 
 Expr FoldConstant(const Expr& expr, const IRModule& mod) {
-  return ConstantFolder(mod).Mutate(expr);
+  auto cfg = transform::PassContext::Current()->GetConfig<FoldConstantConfig>(
+      "relay.FoldConstant", AttrsWithDefaultValues<FoldConstantConfig>());
+  auto start = std::chrono::high_resolution_clock::now();
+  Expr ret = expr;
+  int num_evaluations = 0, num_folded = 0;
+  double evaluation_time = 0;
+  if (!cfg.value()->batch) {
+    ConstantFolder folder(mod);
+    ret = folder.Mutate(expr);
+    num_evaluations = num_folded = folder.num_evaluations();
+    evaluation_time = folder.evaluation_time();
+  } else {
+    // The values of a batch may make more expressions foldable, e.g. through let
+    // bindings or conditions, fold again until nothing is deferred.
+    ICHECK_GT(cfg.value()->batch_size, 0) << "FoldConstant: batch_size must be positive";
+    bool deferred = true;
+    while (deferred) {
+      ConstantFolder folder(mod, cfg.value()->batch_size);
+      ret = folder.Mutate(ret);
+      deferred = folder.HasDeferred();
+      ret = folder.EvaluateDeferred(ret);
+      // shape_of and ndarray_size are still evaluated during the traversal.
+      num_evaluations += folder.num_evaluations();
+      num_folded += folder.num_folded();
+      evaluation_time += folder.evaluation_time();
+    }
+  }
+  if (cfg.value()->report) {
+    double total =
+        std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    LOG(INFO) << "FoldConstant: folded " << num_folded << " constant subgraphs with "
+              << num_evaluations << " evaluations in " << total * 1e3 << " ms, "
+              << evaluation_time * 1e3 << " ms of evaluation";
+  }
+  return ret;
 }
 
 TVM_REGISTER_GLOBAL("relay._transform.FoldConstantExpr").set_body_typed(FoldConstant);
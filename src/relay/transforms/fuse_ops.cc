@@ -30,6 +30,9 @@
 #include <tvm/relay/transform.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
+#include <functional>
+
 #include "../../support/arena.h"
 #include "pass_utils.h"
 #include "pattern_utils.h"
@@ -75,6 +78,19 @@ namespace relay {
       will still run correctly.
   - CommitFuse: mark all the nodes between source and post-dominator as the same group.
   - We use an Union-Find data structure to manage the groups.
+
+  With the "cost" objective of the relay.FuseOps.cost_model config option, each fusion is
+  also priced by a cost model, instead of capped by relay.FuseOps.max_depth:
+
+  - The gain is the memory traffic saved: the intermediate tensors no longer written and
+    read back, and a launch overhead for each kernel saved.
+  - The loss is the work of the inlined values recomputed by each of their consumers.
+  - A fusion with a non positive gain, or making a group with too many nodes or inputs
+    to schedule well, is refused.
+
+  After the dominator based phases, a last phase fuses a group into the group consuming
+  all its outputs when it pays, which also chains a reduction into the following
+  reduction or broadcast ops, e.g. the two reductions of a softmax.
 */
 using support::LinkedList;
 using support::LinkNode;
@@ -85,6 +101,45 @@ static const Op& stop_fusion_op = Op::Get("annotation.stop_fusion");
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.max_depth", Integer);
 
+struct FuseOpsCostModelConfigNode : public tvm::AttrsNode<FuseOpsCostModelConfigNode> {
+  String objective;
+  int64_t launch_bytes;
+  int64_t cache_bytes;
+  int max_inputs;
+  bool fuse_reductions;
+  bool report;
+
+  TVM_DECLARE_ATTRS(FuseOpsCostModelConfigNode, "relay.transform.FuseOpsCostModelConfig") {
+    TVM_ATTR_FIELD(objective)
+        .describe("The fusion objective, 'pattern' for the pattern rules or 'cost'")
+        .set_default("pattern");
+    TVM_ATTR_FIELD(launch_bytes)
+        .describe("The overhead of launching a kernel, in bytes of memory traffic")
+        .set_default(1 << 14);
+    TVM_ATTR_FIELD(cache_bytes)
+        .describe("The bytes of an intermediate tensor kept in cache inside a kernel")
+        .set_default(1 << 20);
+    TVM_ATTR_FIELD(max_inputs)
+        .describe("Maximum number of inputs of a fused function")
+        .set_default(16);
+    TVM_ATTR_FIELD(fuse_reductions)
+        .describe(
+            "Whether a reduction can be fused into the reduction consuming it, only the x86 "
+            "schedules compute chained reductions")
+        .set_default(false);
+    TVM_ATTR_FIELD(report).describe("Log the groups chosen").set_default(false);
+  }
+};
+
+class FuseOpsCostModelConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(FuseOpsCostModelConfig, Attrs,
+                                            FuseOpsCostModelConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(FuseOpsCostModelConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.cost_model", FuseOpsCostModelConfig);
+
 /*!
  * \brief Indexed data flow graph in forward direction.
  *  This is a temporary data structure used for operator fusion analysis.
@@ -507,8 +562,16 @@ DominatorTree DominatorTree::PostDom(support::Arena* arena, const IndexedForward
  */
 class GraphPartitioner {
  public:
-  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth)
-      : arena_(arena), opt_level_(opt_level), max_fuse_depth_(max_fuse_depth) {}
+  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth,
+                            const FuseOpsCostModelConfig& cost_model)
+      : arena_(arena),
+        opt_level_(opt_level),
+        max_fuse_depth_(max_fuse_depth),
+        cost_model_(cost_model),
+        use_cost_(cost_model->objective == "cost") {
+    ICHECK(use_cost_ || cost_model->objective == "pattern")
+        << "Unknown fusion objective " << cost_model->objective;
+  }
   /*!
    * \brief Group as a union find data structure.
    */
@@ -548,6 +611,8 @@ class GraphPartitioner {
      * \brief The number of nodes belonging to this group
      */
     uint32_t num_nodes{1};
+    /*! \brief Whether a reduction was chained into its consumer in this group. */
+    bool chained_reductions{false};
   };
   /*!
    * \brief Partition a graph.
@@ -562,8 +627,16 @@ class GraphPartitioner {
   int opt_level_;
   /*! \brief The maximum number of operations in one fused function */
   size_t max_fuse_depth_;
+  /*! \brief The configuration of the cost model. */
+  FuseOpsCostModelConfig cost_model_;
+  /*! \brief Whether the fusions are priced by the cost model. */
+  bool use_cost_;
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
+  /*! \brief The input nodes of each node, only used by the cost model. */
+  std::vector<std::vector<IndexedForwardGraph::Node*>> inputs_;
+  /*! \brief The nodes of each root group, only used by the cost model. */
+  std::unordered_map<Group*, std::vector<IndexedForwardGraph::Node*>> members_;
   /*! \brief internal field used for deduplication */
   std::unordered_set<IndexedForwardGraph::Node*> visited_;
   // Internal implelementation of CheckPath
@@ -622,7 +695,13 @@ class GraphPartitioner {
     if (child == parent) return;
     // update the number of nodes of the parent group
     parent->num_nodes += child->num_nodes;
+    parent->chained_reductions |= child->chained_reductions;
     child->parent = parent;
+    if (use_cost_) {
+      std::vector<IndexedForwardGraph::Node*>& nodes = members_[parent];
+      nodes.insert(nodes.end(), members_[child].begin(), members_[child].end());
+      members_.erase(child);
+    }
     // update anchor ref and pattern
     if (child->anchor_ref != nullptr) {
       ICHECK(parent->anchor_ref == nullptr);
@@ -696,6 +775,194 @@ class GraphPartitioner {
       }
       groups_[nid] = group_node;
     }
+    if (!use_cost_) return;
+    inputs_.resize(groups_.size());
+    for (size_t nid = 0; nid < groups_.size(); ++nid) {
+      auto* graph_node = graph.post_dfs_order[nid];
+      members_[groups_[nid]].push_back(graph_node);
+      for (auto* link = graph_node->outputs.head; link != nullptr; link = link->next) {
+        inputs_[link->value.node->index].push_back(graph_node);
+      }
+    }
+  }
+
+  /*! \return The bytes of the value of a node, or 0 if they are not known statically. */
+  static int64_t NodeBytes(const IndexedForwardGraph::Node* node) {
+    if (!node->ref->IsInstance<CallNode>()) return 0;
+    const auto* call = static_cast<const CallNode*>(node->ref);
+    std::function<int64_t(const Type&)> fbytes = [&](const Type& type) -> int64_t {
+      if (const auto* ttype = type.as<TensorTypeNode>()) {
+        int64_t size = (ttype->dtype.bits() * ttype->dtype.lanes() + 7) / 8;
+        for (const PrimExpr& dim : ttype->shape) {
+          const auto* extent = dim.as<IntImmNode>();
+          if (extent == nullptr) return 0;
+          size *= extent->value;
+        }
+        return size;
+      }
+      int64_t size = 0;
+      if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+        for (const Type& field : tuple_type->fields) size += fbytes(field);
+      }
+      return size;
+    };
+    return fbytes(call->checked_type_);
+  }
+
+  /*! \return Whether a node is inlined into its consumers by the schedules. */
+  static bool IsInlined(const IndexedForwardGraph::Node* node) {
+    return node->pattern <= kInjective && node->ref->IsInstance<CallNode>();
+  }
+
+  /*!
+   * \brief Estimate the work of recomputing an inlined node in a fused group, in bytes: its
+   *  value, the inlined nodes it is computed from and the inputs read.
+   */
+  int64_t RecomputeCost(IndexedForwardGraph::Node* node,
+                        const std::unordered_set<IndexedForwardGraph::Node*>& fused,
+                        std::unordered_map<IndexedForwardGraph::Node*, int64_t>* memo) {
+    auto it = memo->find(node);
+    if (it != memo->end()) return it->second;
+    int64_t cost = NodeBytes(node);
+    for (auto* input : inputs_[node->index]) {
+      bool inlined = fused.count(input) && IsInlined(input);
+      cost += inlined ? RecomputeCost(input, fused, memo) : NodeBytes(input);
+    }
+    (*memo)[node] = cost;
+    return cost;
+  }
+
+  /*!
+   * \brief Estimate the gain of fusing groups into a target group, in bytes of memory traffic.
+   * \param moved The root groups fused into the target.
+   * \param target The target group.
+   * \return The gain, or -1 if the fused group would have too many nodes or inputs.
+   */
+  int64_t FusionGain(const std::vector<Group*>& moved, Group* target) {
+    target = target->FindRoot();
+    std::unordered_set<IndexedForwardGraph::Node*> fused(members_[target].begin(),
+                                                          members_[target].end());
+    for (Group* group : moved) fused.insert(members_[group].begin(), members_[group].end());
+    if (fused.size() > max_fuse_depth_) return -1;
+    std::unordered_set<IndexedForwardGraph::Node*> inputs;
+    for (auto* node : fused) {
+      for (auto* input : inputs_[node->index]) {
+        if (!fused.count(input)) inputs.insert(input);
+      }
+    }
+    if (inputs.size() > static_cast<size_t>(cost_model_->max_inputs)) return -1;
+    int64_t gain = cost_model_->launch_bytes * static_cast<int64_t>(moved.size());
+    std::unordered_map<IndexedForwardGraph::Node*, int64_t> memo;
+    for (Group* group : moved) {
+      for (auto* node : members_[group]) {
+        int64_t num_outputs = 0;
+        bool internal = !node->extern_ref;
+        for (auto* link = node->outputs.head; link != nullptr; link = link->next) {
+          internal &= fused.count(link->value.node) != 0;
+          num_outputs += 1;
+        }
+        // The nodes whose value is still an output of the fused group save nothing.
+        if (!internal || num_outputs == 0) continue;
+        int64_t bytes = NodeBytes(node);
+        if (IsInlined(node)) {
+          gain += (1 + num_outputs) * bytes;
+          gain -= (num_outputs - 1) * RecomputeCost(node, fused, &memo);
+        } else if (bytes <= cost_model_->cache_bytes) {
+          // A reduction stays a stage of the kernel, its value is reused from the cache.
+          gain += (1 + num_outputs) * bytes;
+        }
+      }
+    }
+    return gain;
+  }
+
+  // Collect the nodes between src and sink, excluding sink.
+  void CollectNodesUptoSink_(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink,
+                             std::vector<Group*>* moved, Group* target) {
+    if (src == sink || visited_.count(src)) return;
+    visited_.insert(src);
+    Group* gnode = groups_[src->index]->FindRoot();
+    if (gnode != target && std::find(moved->begin(), moved->end(), gnode) == moved->end()) {
+      moved->push_back(gnode);
+    }
+    for (auto link = src->outputs.head; link != nullptr; link = link->next) {
+      CollectNodesUptoSink_(link->value.node, sink, moved, target);
+    }
+  }
+
+  /*! \brief Whether the cost model accepts fusing child to its post-dominator dom_parent. */
+  bool CostAllowsFuse(IndexedForwardGraph::Node* child, IndexedForwardGraph::Node* dom_parent) {
+    Group* target = groups_[dom_parent->index]->FindRoot();
+    std::vector<Group*> moved;
+    visited_.clear();
+    CollectNodesUptoSink_(child, dom_parent, &moved, target);
+    return FusionGain(moved, target) > 0;
+  }
+
+  /*! \brief Whether a group of the pattern can be fused into a consumer group in the last phase. */
+  bool CanChain(OpPatternKind producer, OpPatternKind consumer) const {
+    // The injective ops only inline into a reduction before it, which is not known here.
+    if (producer <= kBroadcast && consumer == kCommReduce) return true;
+    if (producer <= kInjective && consumer <= kInjective) return true;
+    // The reduce schedules compute a reduction fused before the output at the root.
+    return producer == kCommReduce && cost_model_->fuse_reductions &&
+           (consumer <= kBroadcast || consumer == kCommReduce);
+  }
+
+  /*!
+   * \brief Fuse each group into the group consuming all its outputs when the cost model
+   *  accepts it. The fused group stays convex since the other groups are not on a path
+   *  between the two.
+   */
+  void RunCostFuse(const IndexedForwardGraph& graph) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (size_t nid = 0; nid < groups_.size(); ++nid) {
+        auto* graph_node = graph.post_dfs_order[nid];
+        Group* group = groups_[nid]->FindRoot();
+        // Visit each group once, at its output node.
+        if (group->root_ref != graph_node->ref) continue;
+        if (group->pattern > kCommReduce || group->pattern == kOutEWiseFusable) continue;
+        Group* consumer = nullptr;
+        bool single_consumer = true;
+        for (auto* node : members_[group]) {
+          single_consumer &= !node->extern_ref;
+          for (auto* link = node->outputs.head; link != nullptr; link = link->next) {
+            Group* output = groups_[link->value.node->index]->FindRoot();
+            if (output == group) continue;
+            single_consumer &= consumer == nullptr || consumer == output;
+            consumer = output;
+          }
+        }
+        if (!single_consumer || consumer == nullptr) continue;
+        if (!CanChain(group->pattern, consumer->pattern)) continue;
+        if (FusionGain({group}, consumer) <= 0) continue;
+        OpPatternKind pattern = std::max(group->pattern, consumer->pattern);
+        MergeFromTo(group, consumer);
+        consumer->pattern = pattern;
+        consumer->chained_reductions |= group->pattern == kCommReduce;
+        changed = true;
+      }
+    }
+  }
+
+  /*! \brief Log the groups of more than one node. */
+  void ReportGroups(const IndexedForwardGraph& graph) {
+    std::ostringstream os;
+    size_t num_groups = 0;
+    for (size_t nid = 0; nid < groups_.size(); ++nid) {
+      Group* group = groups_[nid]->FindRoot();
+      if (group->root_ref != graph.post_dfs_order[nid]->ref) continue;
+      if (!group->root_ref->IsInstance<CallNode>()) continue;
+      const auto* call = static_cast<const CallNode*>(group->root_ref);
+      num_groups += 1;
+      if (group->num_nodes == 1) continue;
+      os << "\n  " << call->op << ": " << group->num_nodes << " nodes, pattern "
+         << group->pattern;
+    }
+    LOG(INFO) << "FuseOps: " << num_groups << " fused functions with the "
+              << cost_model_->objective << " objective" << os.str();
   }
 
   // execute the fusion algorithm.
@@ -714,8 +981,14 @@ class GraphPartitioner {
       size_t dom_parent_gindex = dom_node->parent->gnode->index;
 
       // refuse the fusion if too many ops are going to be fused together
-      if (CountFusedNodesWithNewChild(graph_node, dom_node->parent->gnode) > max_fuse_depth_)
+      if (use_cost_) {
+        // Skip if current node is already fused to the parent, there is nothing to price.
+        if (group_node->FindRoot() == groups_[dom_parent_gindex]->FindRoot()) continue;
+        if (!CostAllowsFuse(graph_node, dom_node->parent->gnode)) continue;
+      } else if (CountFusedNodesWithNewChild(graph_node, dom_node->parent->gnode) >
+                 max_fuse_depth_) {
         continue;
+      }
 
       if (phase == 2) {
         // Fuse injective ops into intermediate tuples, if any
@@ -803,16 +1076,20 @@ std::vector<GraphPartitioner::Group*> GraphPartitioner::Partition(
   for (int phase = 0; phase < 3; ++phase) {
     this->RunFuse(graph, post_dom_tree, phase);
   }
+  if (use_cost_) this->RunCostFuse(graph);
+  if (cost_model_->report) this->ReportGroups(graph);
   return std::move(groups_);
 }
 
 class FuseMutator : private MixedModeMutator {
  public:
   // Run the transform
-  Expr Transform(const Expr& body, int fuse_opt_level, size_t max_fuse_depth) {
+  Expr Transform(const Expr& body, int fuse_opt_level, size_t max_fuse_depth,
+                 const FuseOpsCostModelConfig& cost_model) {
     // setup the group map.
     auto graph = IndexedForwardGraph::Create(&arena_, body);
-    auto groups = GraphPartitioner(&arena_, fuse_opt_level, max_fuse_depth).Partition(graph);
+    auto groups =
+        GraphPartitioner(&arena_, fuse_opt_level, max_fuse_depth, cost_model).Partition(graph);
     for (size_t nid = 0; nid < graph.post_dfs_order.size(); ++nid) {
       ICHECK(graph.post_dfs_order[nid]->ref != nullptr);
       gmap_[graph.post_dfs_order[nid]->ref] = groups[nid];
@@ -981,6 +1258,9 @@ class FuseMutator : private MixedModeMutator {
     if (visitor.has_call && visitor.reshape_only) {
       func = WithAttr(std::move(func), attr::kReshapeOnly, tvm::Integer(visitor.reshape_only));
     }
+    if (group->chained_reductions) {
+      func = WithAttr(std::move(func), attr::kChainedReductions, tvm::Integer(1));
+    }
     return Call(func, ginfo.arguments, Attrs());
   }
 
@@ -1015,8 +1295,9 @@ class FuseMutator : private MixedModeMutator {
   }
 };
 
-Expr FuseOps(const Expr& expr, int fuse_opt_level, size_t max_fuse_depth, const IRModule& module) {
-  return FuseMutator().Transform(expr, fuse_opt_level, max_fuse_depth);
+Expr FuseOps(const Expr& expr, int fuse_opt_level, size_t max_fuse_depth,
+             const FuseOpsCostModelConfig& cost_model, const IRModule& module) {
+  return FuseMutator().Transform(expr, fuse_opt_level, max_fuse_depth, cost_model);
 }
 
 namespace transform {
@@ -1026,7 +1307,10 @@ Pass FuseOps(int fuse_opt_level) {
       [=](Function f, IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relay.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return Downcast<Function>(FuseOps(f, opt_level, max_fuse_depth.value(), m));
+        auto cost_model = pc->GetConfig<FuseOpsCostModelConfig>(
+            "relay.FuseOps.cost_model", AttrsWithDefaultValues<FuseOpsCostModelConfig>());
+        return Downcast<Function>(
+            FuseOps(f, opt_level, max_fuse_depth.value(), cost_model.value(), m));
       };
   return CreateFunctionPass(pass_func, 1, "FuseOps", {"InferType"});
 }
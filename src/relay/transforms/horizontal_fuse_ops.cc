@@ -0,0 +1,238 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file horizontal_fuse_ops.cc
+ * \brief Pack independent small fused operators into one primitive function.
+ *
+ * FuseOps only fuses an operator with its producers and consumers, and the
+ * CombineParallel passes only merge operators reading the same input. The
+ * small elementwise and reduction operators of the branches of a network are
+ * left as separate kernels, each paying the dispatch of the executor. This pass
+ * groups the calls to fused functions at the same dependency level, which are
+ * independent of each other, and replaces each group by a call to a primitive
+ * function returning the tuple of their outputs. The group is lowered to one
+ * kernel, computing the outputs one after the other.
+ */
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+
+struct HorizontalFuseOpsConfigNode : public tvm::AttrsNode<HorizontalFuseOpsConfigNode> {
+  int max_group_size;
+  int64_t max_bytes;
+
+  TVM_DECLARE_ATTRS(HorizontalFuseOpsConfigNode, "relay.transform.HorizontalFuseOpsConfig") {
+    TVM_ATTR_FIELD(max_group_size)
+        .describe("Maximum number of fused functions packed together")
+        .set_default(8);
+    TVM_ATTR_FIELD(max_bytes)
+        .describe("Maximum output bytes of a fused function to pack, larger ones are left alone")
+        .set_default(1 << 18);
+  }
+};
+
+class HorizontalFuseOpsConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(HorizontalFuseOpsConfig, Attrs,
+                                            HorizontalFuseOpsConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(HorizontalFuseOpsConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.HorizontalFuseOps", HorizontalFuseOpsConfig);
+
+/*! \brief Group the independent calls to fused functions and rewrite them. */
+class HorizontalFuser : private ExprMutator {
+ public:
+  explicit HorizontalFuser(const HorizontalFuseOpsConfig& cfg) : cfg_(cfg) {}
+
+  Function Run(const Function& func) {
+    PostOrderVisit(func->body, [this](const Expr& expr) { Visit(expr); });
+    // The levels are only meaningful in a dataflow graph.
+    if (!dataflow_) return func;
+    std::map<std::pair<int, int>, std::vector<const CallNode*>> groups;
+    for (const CallNode* call : calls_) {
+      int kind = Kind(call);
+      if (kind >= 0) groups[{levels_.at(call), kind}].push_back(call);
+    }
+    int num_groups = 0, num_calls = 0;
+    for (auto& kv : groups) {
+      std::vector<const CallNode*>& calls = kv.second;
+      for (size_t begin = 0; begin + 1 < calls.size(); begin += cfg_->max_group_size) {
+        size_t end = std::min(calls.size(), begin + cfg_->max_group_size);
+        if (end - begin < 2) break;
+        std::vector<const CallNode*> group(calls.begin() + begin, calls.begin() + end);
+        for (size_t i = 0; i < group.size(); ++i) {
+          members_[group[i]] = {num_groups, i};
+        }
+        groups_.push_back(std::move(group));
+        num_groups += 1;
+        num_calls += end - begin;
+      }
+    }
+    if (groups_.empty()) return func;
+    DLOG(INFO) << "HorizontalFuseOps: " << num_calls << " fused functions packed into "
+               << num_groups << " groups";
+    group_calls_.resize(groups_.size());
+    return Downcast<Function>(Mutate(func));
+  }
+
+ private:
+  /*! \brief Record the dependency level of the calls to fused functions. */
+  void Visit(const Expr& expr) {
+    int level = 0;
+    if (const auto* call = expr.as<CallNode>()) {
+      for (const Expr& arg : call->args) level = std::max(level, Level(arg));
+      if (IsPrimitive(call)) {
+        level += 1;
+        calls_.push_back(call);
+      }
+    } else if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const Expr& field : tuple->fields) level = std::max(level, Level(field));
+    } else if (const auto* get = expr.as<TupleGetItemNode>()) {
+      level = Level(get->tuple);
+    } else if (expr.as<LetNode>() || expr.as<IfNode>() || expr.as<MatchNode>() ||
+               expr.as<RefCreateNode>()) {
+      dataflow_ = false;
+    }
+    levels_[expr.get()] = level;
+  }
+
+  int Level(const Expr& expr) const {
+    auto it = levels_.find(expr.get());
+    return it != levels_.end() ? it->second : 0;
+  }
+
+  static bool IsPrimitive(const CallNode* call) {
+    const auto* func = call->op.as<FunctionNode>();
+    return func != nullptr && func->HasNonzeroAttr(attr::kPrimitive) &&
+           !func->GetAttr<String>(attr::kCompiler).defined();
+  }
+
+  /*!
+   * \brief The kind of the fused function of a call, the injective functions and the
+   *  reductions are packed apart since they are scheduled differently.
+   * \return 0 for injective, 1 for reductions, and -1 if the function is not packed.
+   */
+  int Kind(const CallNode* call) const {
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    const auto* func = call->op.as<FunctionNode>();
+    const auto* ttype = func->body->checked_type_.as<TensorTypeNode>();
+    if (ttype == nullptr) return -1;
+    int64_t bytes = ttype->dtype.bytes();
+    for (const PrimExpr& dim : ttype->shape) {
+      const auto* extent = dim.as<IntImmNode>();
+      if (extent == nullptr) return -1;
+      bytes *= extent->value;
+    }
+    if (bytes > cfg_->max_bytes) return -1;
+    int pattern = kElemWise;
+    PostOrderVisit(func->body, [&](const Expr& expr) {
+      if (const auto* op = expr.as<CallNode>()) {
+        if (const auto* callee = op->op.as<OpNode>()) {
+          pattern = std::max<int>(pattern, fpattern.get(GetRef<Op>(callee), kOpaque));
+        }
+      }
+    });
+    if (pattern <= kInjective) return 0;
+    return pattern == kCommReduce ? 1 : -1;
+  }
+
+  Expr VisitExpr_(const CallNode* op) final {
+    auto it = members_.find(op);
+    if (it == members_.end()) return ExprMutator::VisitExpr_(op);
+    int group = it->second.first;
+    if (!group_calls_[group].defined()) group_calls_[group] = PackGroup(groups_[group]);
+    return TupleGetItem(group_calls_[group], it->second.second, op->span);
+  }
+
+  /*!
+   * \brief Make the call to the primitive function of a group, the parameters bound to the
+   *  same argument are merged.
+   */
+  Call PackGroup(const std::vector<const CallNode*>& group) {
+    Array<Var> params;
+    Array<Expr> args, outputs;
+    std::unordered_map<Expr, Var, ObjectPtrHash, ObjectPtrEqual> param_of_arg;
+    for (const CallNode* call : group) {
+      const auto* func = call->op.as<FunctionNode>();
+      Map<Var, Expr> subst;
+      for (size_t i = 0; i < call->args.size(); ++i) {
+        Expr arg = VisitExpr(call->args[i]);
+        auto it = param_of_arg.find(arg);
+        if (it != param_of_arg.end()) {
+          subst.Set(func->params[i], it->second);
+          continue;
+        }
+        param_of_arg[arg] = func->params[i];
+        params.push_back(func->params[i]);
+        args.push_back(arg);
+      }
+      outputs.push_back(Bind(func->body, subst));
+    }
+    Function func(params, Tuple(outputs), Type(), {});
+    func = WithAttr(std::move(func), attr::kPrimitive, tvm::Integer(1));
+    func = WithAttr(std::move(func), attr::kHorizontallyFused, tvm::Integer(1));
+    return Call(func, args, Attrs(), {});
+  }
+
+  /*! \brief The configuration of the pass. */
+  HorizontalFuseOpsConfig cfg_;
+  /*! \brief Whether the function is a dataflow graph. */
+  bool dataflow_{true};
+  /*! \brief The calls to fused functions in post DFS order. */
+  std::vector<const CallNode*> calls_;
+  /*! \brief The dependency level of the expressions, the number of fused calls before. */
+  std::unordered_map<const Object*, int> levels_;
+  /*! \brief The calls of each group. */
+  std::vector<std::vector<const CallNode*>> groups_;
+  /*! \brief The group and the position in it of the packed calls. */
+  std::unordered_map<const CallNode*, std::pair<int, int>> members_;
+  /*! \brief The call of each group once made. */
+  std::vector<Call> group_calls_;
+};
+
+namespace transform {
+
+Pass HorizontalFuseOps() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        auto cfg = pc->GetConfig<HorizontalFuseOpsConfig>(
+            "relay.HorizontalFuseOps", AttrsWithDefaultValues<HorizontalFuseOpsConfig>());
+        return HorizontalFuser(cfg.value()).Run(f);
+      };
+  return CreateFunctionPass(pass_func, 4, "HorizontalFuseOps", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.HorizontalFuseOps").set_body_typed(HorizontalFuseOps);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
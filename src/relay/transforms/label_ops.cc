@@ -18,6 +18,7 @@
  */
 #include <tvm/ir/attrs.h>
 #include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
 #include <tvm/relay/transform.h>
 
 namespace tvm {
@@ -26,6 +27,80 @@ namespace transform {
 
 namespace {
 
+/*! \brief Same signature as the per-op MAC counters registered in mac_count.cc. */
+using FMacCount = runtime::TypedPackedFunc<int64_t(const Call& call_node)>;
+
+/*! \brief Number of elements (or bytes if `bytes` is set) of a tensor or tuple type.
+ * \return -1 if the type is not fully static.
+ */
+int64_t TypeSize(const Type& type, bool bytes) {
+  if (const auto* tt = type.as<TensorTypeNode>()) {
+    int64_t size = bytes ? (tt->dtype.bits() * tt->dtype.lanes() + 7) / 8 : 1;
+    for (const auto& dim : tt->shape) {
+      const auto* imm = dim.as<IntImmNode>();
+      if (imm == nullptr) return -1;
+      size *= imm->value;
+    }
+    return size;
+  } else if (const auto* tuple = type.as<TupleTypeNode>()) {
+    int64_t size = 0;
+    for (const auto& field : tuple->fields) {
+      int64_t field_size = TypeSize(field, bytes);
+      if (field_size < 0) return -1;
+      size += field_size;
+    }
+    return size;
+  }
+  return -1;
+}
+
+/*! \brief Estimate the floating point operations of a primitive function body.
+ *
+ * Ops with a registered FMacCount (conv, dense, batch_matmul) count two
+ * operations per MAC, reductions count one operation per input element,
+ * injective ops count none and all other ops count one operation per output
+ * element. The estimate is -1 if any type in the body is not fully static.
+ */
+class FlopCounter : private ExprVisitor {
+ public:
+  static int64_t Count(const Expr& body) {
+    FlopCounter counter;
+    counter(body);
+    return counter.static_ ? counter.flops_ : -1;
+  }
+
+ private:
+  void VisitExpr_(const CallNode* call) final {
+    static const auto& fmac = Op::GetAttrMap<FMacCount>("FMacCount");
+    static const auto& fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    ExprVisitor::VisitExpr_(call);
+    const auto* op = call->op.as<OpNode>();
+    if (op == nullptr || !static_) return;
+    if (!call->checked_type_.defined() || TypeSize(call->checked_type_, false) < 0) {
+      static_ = false;
+      return;
+    }
+    for (const auto& arg : call->args) {
+      if (!arg->checked_type_.defined() || TypeSize(arg->checked_type_, false) < 0) {
+        static_ = false;
+        return;
+      }
+    }
+    Op op_ref = GetRef<Op>(op);
+    int pattern = fpattern.get(op_ref, kOpaque);
+    if (fmac.count(op_ref)) {
+      flops_ += 2 * fmac[op_ref](GetRef<Call>(call));
+    } else if (pattern == kCommReduce && !call->args.empty()) {
+      flops_ += TypeSize(call->args[0]->checked_type_, false);
+    } else if (pattern != kInjective) {
+      flops_ += TypeSize(call->checked_type_, false);
+    }
+  }
+
+  int64_t flops_{0};
+  bool static_{true};
+};
+
 /*! \brief Collect all attributes whose name contains "layout".
  */
 struct CollectAttrs : public AttrVisitor {
@@ -54,7 +129,9 @@ struct CollectAttrs : public AttrVisitor {
 /*! \brief Visitor to add structural hash and layout information to `Function`
  * nodes. Sets the "hash" field on the attr to the structural hash of the
  * function. Propogates any attributes with "layout" in their name from call
- * nodes in the Function to the Function's attrs.
+ * nodes in the Function to the Function's attrs. Primitive functions with
+ * static shapes also get "flops" and "bytes" estimates of their work, where
+ * "bytes" is the size of all inputs and outputs.
  */
 class LabelOpsMutator : public MixedModeMutator {
  private:
@@ -75,6 +152,22 @@ class LabelOpsMutator : public MixedModeMutator {
     for (auto p : body_attrs) {
       f = WithAttr(f, p.first, p.second);
     }
+    if (f->HasNonzeroAttr(attr::kPrimitive)) {
+      int64_t flops = FlopCounter::Count(f->body);
+      int64_t bytes =
+          f->body->checked_type_.defined() ? TypeSize(f->body->checked_type_, true) : -1;
+      for (const auto& param : f->params) {
+        int64_t param_bytes = TypeSize(param->checked_type_.defined() ? param->checked_type_
+                                                                      : param->type_annotation,
+                                       true);
+        bytes = (bytes < 0 || param_bytes < 0) ? -1 : bytes + param_bytes;
+      }
+      // attrs are passed as strings since the graph executor json only keeps string attrs
+      if (flops >= 0 && bytes >= 0) {
+        f = WithAttr(f, "flops", String(std::to_string(flops)));
+        f = WithAttr(f, "bytes", String(std::to_string(bytes)));
+      }
+    }
     return std::move(f);
   }
 
@@ -103,7 +196,9 @@ class LabelOpsMutator : public MixedModeMutator {
  * The key "hash" contains the structural hash of the node. Any attributes with
  * "layout" in their name are also added to attrs (for example,
  * `attrs["src_layout"]` contains the `src_layout` attribute of the TVM op
- * corresponding to this function call).
+ * corresponding to this function call). Primitive functions with static
+ * shapes additionally carry "flops" and "bytes" estimates used for the
+ * roofline metrics of the profiler.
  */
 Pass LabelOps() {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
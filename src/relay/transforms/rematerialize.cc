@@ -0,0 +1,260 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rematerialize.cc
+ * \brief Recompute cheap activations instead of keeping them alive, to fit the
+ *  peak memory of a function in a budget.
+ *
+ * The gradient passes bind the forward activations with lets, and the backward
+ * section uses them long after they are computed. The pass estimates the live
+ * bytes of the let-bound values like the memory planner: a value is live from
+ * its binding to its last use. While the peak is over the budget, a cheap value
+ * which is live but unused at the peak is recomputed right before its next use.
+ */
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+
+/*! \brief The let bindings of a function, flattened in evaluation order. */
+class Rematerializer {
+ public:
+  explicit Rematerializer(int64_t memory_budget) : memory_budget_(memory_budget) {}
+
+  Function Run(const Function& func) {
+    body_ = Flatten(func->body);
+    if (bindings_.empty()) return func;
+    int64_t initial_peak = -1;
+    int num_recomputed = 0;
+    while (true) {
+      Analyze();
+      if (initial_peak < 0) initial_peak = peak_;
+      if (peak_ <= memory_budget_ || !Recompute()) break;
+      num_recomputed += 1;
+    }
+    if (peak_ > memory_budget_) {
+      LOG(WARNING) << "Rematerialize: the peak memory " << peak_ << " is over the budget "
+                   << memory_budget_ << " after recomputing " << num_recomputed << " values";
+    }
+    DLOG(INFO) << "Rematerialize: peak memory " << initial_peak << " -> " << peak_ << ", "
+               << num_recomputed << " values recomputed";
+    if (num_recomputed == 0) return func;
+    Expr body = body_;
+    for (auto it = bindings_.rbegin(); it != bindings_.rend(); ++it) {
+      body = Let(it->var, it->value, body);
+    }
+    return Function(func->params, body, func->ret_type, func->type_params, func->attrs,
+                    func->span);
+  }
+
+ private:
+  struct Binding {
+    Var var;
+    Expr value;
+    /*! \brief The bytes of the value, 0 when they are not known statically. */
+    int64_t bytes;
+    /*! \brief Whether the value is a cheap operator to recompute. */
+    bool cheap;
+    /*! \brief The estimated cost of a recomputation, the bytes it reads and writes. */
+    int64_t cost;
+  };
+
+  /*!
+   * \brief Move the lets of the body to the bindings, the gradient passes nest the
+   *  let list of the backward section in the returned tuple. The other non atomic
+   *  expressions of the tuple are bound in order, which keeps the evaluation order.
+   */
+  Expr Flatten(const Expr& expr) {
+    if (const auto* op = expr.as<LetNode>()) {
+      Push(op->var, op->value);
+      return Flatten(op->body);
+    }
+    if (const auto* op = expr.as<TupleNode>()) {
+      Array<Expr> fields;
+      for (const Expr& field : op->fields) fields.push_back(Flatten(field));
+      return Tuple(fields, op->span);
+    }
+    if (expr.as<VarNode>() || expr.as<ConstantNode>() || expr.as<GlobalVarNode>() ||
+        expr.as<OpNode>()) {
+      return expr;
+    }
+    Var var("x", Type());
+    Push(var, expr);
+    return std::move(var);
+  }
+
+  void Push(const Var& var, const Expr& value) {
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    Binding binding{var, value, Bytes(value->checked_type_), false, 0};
+    if (const auto* call = value.as<CallNode>()) {
+      if (const auto* op = call->op.as<OpNode>()) {
+        binding.cheap = binding.bytes > 0 && fpattern.get(GetRef<Op>(op), kOpaque) <= kInjective;
+        binding.cost = binding.bytes;
+        for (const Expr& arg : call->args) {
+          binding.cheap &= arg.as<VarNode>() != nullptr || arg.as<ConstantNode>() != nullptr;
+          binding.cost += Bytes(arg->checked_type_);
+        }
+      }
+    }
+    bindings_.push_back(std::move(binding));
+  }
+
+  /*! \brief Collect the uses of the bindings and the live bytes at each binding. */
+  void Analyze() {
+    size_t num_bindings = bindings_.size();
+    std::unordered_map<const VarNode*, size_t> index;
+    for (size_t i = 0; i < num_bindings; ++i) {
+      index[bindings_[i].var.get()] = i;
+    }
+    // The position num_bindings is the body.
+    users_.assign(num_bindings, {});
+    for (size_t i = 0; i <= num_bindings; ++i) {
+      for (const Var& var : FreeVars(i < num_bindings ? bindings_[i].value : body_)) {
+        auto it = index.find(var.get());
+        if (it != index.end()) users_[it->second].push_back(i);
+      }
+    }
+    std::vector<int64_t> delta(num_bindings + 2, 0);
+    for (size_t i = 0; i < num_bindings; ++i) {
+      size_t last = users_[i].empty() ? i : users_[i].back();
+      delta[i] += bindings_[i].bytes;
+      delta[last + 1] -= bindings_[i].bytes;
+    }
+    int64_t live = 0;
+    peak_ = 0;
+    peak_at_ = 0;
+    for (size_t i = 0; i <= num_bindings; ++i) {
+      live += delta[i];
+      if (live > peak_) {
+        peak_ = live;
+        peak_at_ = i;
+      }
+    }
+  }
+
+  /*!
+   * \brief Recompute the cheap value live at the peak with the best ratio of the
+   *  bytes saved to the recomputation cost.
+   * \return false if no value can be recomputed.
+   */
+  bool Recompute() {
+    size_t num_bindings = bindings_.size();
+    int best = -1;
+    size_t best_use = 0;
+    double best_score = 0;
+    for (size_t j = 0; j < peak_at_; ++j) {
+      const Binding& binding = bindings_[j];
+      if (!binding.cheap) continue;
+      // The next use after the peak, the value is recomputed right before it.
+      auto it = std::lower_bound(users_[j].begin(), users_[j].end(), peak_at_);
+      if (it == users_[j].end() || *it == peak_at_) continue;
+      size_t use = *it;
+      // The inputs must still be alive at the recomputation.
+      bool available = true;
+      for (const Expr& arg : binding.value.as<CallNode>()->args) {
+        const auto* var = arg.as<VarNode>();
+        if (var == nullptr) continue;
+        for (size_t k = 0; k < j && available; ++k) {
+          if (bindings_[k].var.get() == var) {
+            available = users_[k].back() >= use;
+          }
+        }
+      }
+      if (!available) continue;
+      double score = static_cast<double>(binding.bytes) / binding.cost;
+      if (best < 0 || score > best_score) {
+        best_score = score;
+        best = j;
+        best_use = use;
+      }
+    }
+    if (best < 0) return false;
+    Binding recomputed = bindings_[best];
+    Var var = recomputed.var;
+    recomputed.var = Var(var->name_hint(), var->type_annotation);
+    Map<Var, Expr> subst{{var, recomputed.var}};
+    for (size_t i = best_use; i < num_bindings; ++i) {
+      bindings_[i].value = Bind(bindings_[i].value, subst);
+    }
+    body_ = Bind(body_, subst);
+    bool used_before = users_[best].front() < peak_at_;
+    bindings_.insert(bindings_.begin() + best_use, std::move(recomputed));
+    // Without a use before the peak, the value is only moved to its use.
+    if (!used_before) bindings_.erase(bindings_.begin() + best);
+    return true;
+  }
+
+  /*! \return The bytes of a value of a type, or 0 if they are not known statically. */
+  static int64_t Bytes(const Type& type) {
+    if (const auto* ttype = type.as<TensorTypeNode>()) {
+      int64_t size = (ttype->dtype.bits() * ttype->dtype.lanes() + 7) / 8;
+      for (const PrimExpr& dim : ttype->shape) {
+        const auto* extent = dim.as<IntImmNode>();
+        if (extent == nullptr) return 0;
+        size *= extent->value;
+      }
+      return size;
+    }
+    if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+      int64_t size = 0;
+      for (const Type& field : tuple_type->fields) size += Bytes(field);
+      return size;
+    }
+    return 0;
+  }
+
+  /*! \brief The peak memory allowed. */
+  int64_t memory_budget_;
+  /*! \brief The bindings in evaluation order. */
+  std::vector<Binding> bindings_;
+  /*! \brief The body after the bindings. */
+  Expr body_;
+  /*! \brief The positions of the uses of each binding, the body is at the end. */
+  std::vector<std::vector<size_t>> users_;
+  /*! \brief The peak of the live bytes. */
+  int64_t peak_{0};
+  /*! \brief The position of the peak. */
+  size_t peak_at_{0};
+};
+
+namespace transform {
+
+Pass Rematerialize(int64_t memory_budget) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Rematerializer(memory_budget).Run(f);
+      };
+  return CreateFunctionPass(pass_func, 1, "Rematerialize", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.Rematerialize").set_body_typed(Rematerialize);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
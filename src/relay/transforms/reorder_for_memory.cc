@@ -0,0 +1,344 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file reorder_for_memory.cc
+ * \brief Reorder the calls of a dataflow function to lower its peak memory.
+ *
+ * The graph and AOT executors run the calls in the post DFS order of the
+ * dataflow graph, and the memory is planned on that order. The pass searches
+ * for a topological order with a lower peak of live bytes, and binds the calls
+ * with lets in that order, which the code generators of both executors follow.
+ */
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../support/arena.h"
+#include "../analysis/dependency_graph.h"
+#include "let_list.h"
+
+namespace tvm {
+namespace relay {
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.ReorderForMemory.report", Bool);
+
+/*!
+ * \brief The order of the calls of a dataflow graph.
+ *
+ *  The model of the memory follows the memory planner: a call allocates its
+ *  output, which is released after the last call using it, and the outputs of
+ *  the function are never released. Tuples and their items alias the outputs
+ *  of the calls and allocate nothing.
+ */
+class CallScheduler {
+ public:
+  explicit CallScheduler(Expr body) : body_(std::move(body)) {}
+
+  /*!
+   * \brief Collect the calls of the body and their dependencies.
+   * \return false if the body is not a dataflow graph of calls with static shapes.
+   */
+  bool Init() {
+    using Node = DependencyGraph::Node;
+    DependencyGraph graph = DependencyGraph::Create(&arena_, body_);
+    std::unordered_map<Node*, Expr> node_expr;
+    for (const auto& kv : graph.expr_node) {
+      node_expr[kv.second] = kv.first;
+    }
+    // The nodes of the body, without the bodies of the called functions.
+    std::unordered_set<Node*> outer;
+    std::vector<Node*> stack{graph.expr_node.at(body_)};
+    while (!stack.empty()) {
+      Node* n = stack.back();
+      stack.pop_back();
+      if (!outer.insert(n).second || node_expr.at(n).as<FunctionNode>()) continue;
+      for (auto* link = n->children.head; link != nullptr; link = link->next) {
+        stack.push_back(link->value);
+      }
+    }
+    // The calls whose outputs are aliased by each node.
+    std::unordered_map<Node*, std::vector<int>> owners;
+    auto collect = [&owners](Node* n) {
+      std::vector<int> ret;
+      for (auto* link = n->children.head; link != nullptr; link = link->next) {
+        auto it = owners.find(link->value);
+        if (it != owners.end()) ret.insert(ret.end(), it->second.begin(), it->second.end());
+      }
+      std::sort(ret.begin(), ret.end());
+      ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+      return ret;
+    };
+    for (Node* n : graph.post_dfs_order) {
+      if (!outer.count(n)) continue;
+      const Expr& expr = node_expr.at(n);
+      if (expr.as<CallNode>()) {
+        int64_t bytes = Bytes(expr->checked_type_);
+        if (bytes < 0) return false;
+        deps_.push_back(collect(n));
+        owners[n] = {static_cast<int>(calls_.size())};
+        calls_.push_back(expr);
+        bytes_.push_back(bytes);
+      } else if (expr.as<TupleNode>() || expr.as<TupleGetItemNode>()) {
+        owners[n] = collect(n);
+      } else if (!expr.as<VarNode>() && !expr.as<ConstantNode>() && !expr.as<OpNode>() &&
+                 !expr.as<FunctionNode>()) {
+        return false;
+      }
+    }
+    auto it = owners.find(graph.expr_node.at(body_));
+    if (it != owners.end()) outputs_.insert(it->second.begin(), it->second.end());
+    users_.assign(calls_.size(), 0);
+    consumers_.resize(calls_.size());
+    for (size_t c = 0; c < calls_.size(); ++c) {
+      for (int d : deps_[c]) {
+        users_[d] += 1;
+        consumers_[d].push_back(c);
+      }
+    }
+    return !calls_.empty();
+  }
+
+  /*! \return The post DFS order the executors use by default. */
+  std::vector<int> DefaultOrder() const {
+    std::vector<int> order(calls_.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    return order;
+  }
+
+  /*! \return The order with the lowest peak among a few heuristics and the default. */
+  std::vector<int> Search() const {
+    std::vector<int> best = DefaultOrder();
+    int64_t best_peak = Peak(best);
+    for (std::vector<int> order : {SubtreeOrder(), Greedy(false), Greedy(true)}) {
+      int64_t peak = Peak(order);
+      if (peak < best_peak) {
+        best = std::move(order);
+        best_peak = peak;
+      }
+    }
+    return best;
+  }
+
+  /*! \return The peak of live bytes when the calls run in an order. */
+  int64_t Peak(const std::vector<int>& order) const {
+    std::vector<int> remaining = users_;
+    int64_t live = 0, peak = 0;
+    for (int c : order) {
+      live += bytes_[c];
+      peak = std::max(peak, live);
+      if (remaining[c] == 0 && !outputs_.count(c)) live -= bytes_[c];
+      for (int d : deps_[c]) {
+        if (--remaining[d] == 0 && !outputs_.count(d)) live -= bytes_[d];
+      }
+    }
+    return peak;
+  }
+
+  /*! \return The body with the calls bound by lets in an order. */
+  Expr Rewrite(const std::vector<int>& order) const {
+    std::unordered_map<Expr, Expr, ObjectPtrHash, ObjectPtrEqual> memo;
+    std::function<Expr(const Expr&)> remap = [&](const Expr& expr) {
+      auto it = memo.find(expr);
+      if (it != memo.end()) return it->second;
+      Expr ret = expr;
+      if (const auto* op = expr.as<TupleNode>()) {
+        Array<Expr> fields;
+        for (const Expr& field : op->fields) fields.push_back(remap(field));
+        ret = Tuple(fields, op->span);
+      } else if (const auto* op = expr.as<TupleGetItemNode>()) {
+        ret = TupleGetItem(remap(op->tuple), op->index, op->span);
+      }
+      memo[expr] = ret;
+      return ret;
+    };
+    LetList ll;
+    for (int c : order) {
+      const auto* call = calls_[c].as<CallNode>();
+      Array<Expr> args;
+      for (const Expr& arg : call->args) args.push_back(remap(arg));
+      memo[calls_[c]] = ll.Push(Call(call->op, args, call->attrs, call->type_args, call->span),
+                                call->checked_type_);
+    }
+    return ll.Get(remap(body_));
+  }
+
+ private:
+  /*!
+   * \brief Schedule the ready call with the lowest increase of the live bytes,
+   *  or with the smallest output, the ties go to the default order.
+   */
+  std::vector<int> Greedy(bool smallest_first) const {
+    size_t num_calls = calls_.size();
+    std::vector<int> order, remaining = users_, pending(num_calls);
+    std::vector<bool> ready(num_calls, false);
+    for (size_t c = 0; c < num_calls; ++c) {
+      pending[c] = deps_[c].size();
+      ready[c] = pending[c] == 0;
+    }
+    while (order.size() < num_calls) {
+      int best = -1;
+      int64_t best_key[2] = {0, 0};
+      for (size_t c = 0; c < num_calls; ++c) {
+        if (!ready[c]) continue;
+        int64_t freed = remaining[c] == 0 && !outputs_.count(c) ? bytes_[c] : 0;
+        for (int d : deps_[c]) {
+          if (remaining[d] == 1 && !outputs_.count(d)) freed += bytes_[d];
+        }
+        int64_t delta = bytes_[c] - freed;
+        int64_t key[2] = {smallest_first ? bytes_[c] : delta, smallest_first ? delta : bytes_[c]};
+        if (best < 0 || std::lexicographical_compare(key, key + 2, best_key, best_key + 2)) {
+          best = c;
+          std::copy(key, key + 2, best_key);
+        }
+      }
+      ICHECK_GE(best, 0) << "ReorderForMemory: the dependencies of the calls have a cycle";
+      order.push_back(best);
+      ready[best] = false;
+      for (int d : deps_[best]) remaining[d] -= 1;
+      for (int c : consumers_[best]) {
+        if (--pending[c] == 0) ready[c] = true;
+      }
+    }
+    return order;
+  }
+
+  /*!
+   * \brief A post DFS order visiting first the inputs whose subgraphs need the most
+   *  memory besides their outputs, which is optimal when the graph is a tree.
+   */
+  std::vector<int> SubtreeOrder() const {
+    size_t num_calls = calls_.size();
+    // The peak of each subgraph run alone, counting the shared inputs in every user.
+    std::vector<int64_t> peak(num_calls);
+    std::vector<std::vector<int>> inputs(num_calls);
+    auto by_saving = [&](int a, int b) { return peak[a] - bytes_[a] > peak[b] - bytes_[b]; };
+    for (size_t c = 0; c < num_calls; ++c) {
+      inputs[c] = deps_[c];
+      std::stable_sort(inputs[c].begin(), inputs[c].end(), by_saving);
+      int64_t live = 0;
+      peak[c] = 0;
+      for (int d : inputs[c]) {
+        peak[c] = std::max(peak[c], live + peak[d]);
+        live += bytes_[d];
+      }
+      peak[c] = std::max(peak[c], live + bytes_[c]);
+    }
+    std::vector<int> sinks;
+    for (size_t c = 0; c < num_calls; ++c) {
+      if (users_[c] == 0) sinks.push_back(c);
+    }
+    std::stable_sort(sinks.begin(), sinks.end(), by_saving);
+    std::vector<int> order;
+    std::vector<bool> visited(num_calls, false);
+    for (int sink : sinks) {
+      // The calls on the path from the sink, with the index of the next input to visit.
+      std::vector<std::pair<int, size_t>> stack;
+      if (!visited[sink]) stack.emplace_back(sink, 0);
+      visited[sink] = true;
+      while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second < inputs[top.first].size()) {
+          int d = inputs[top.first][top.second++];
+          if (!visited[d]) {
+            visited[d] = true;
+            stack.emplace_back(d, 0);
+          }
+        } else {
+          order.push_back(top.first);
+          stack.pop_back();
+        }
+      }
+    }
+    return order;
+  }
+
+  /*! \return The bytes of a value of a type, or -1 if they are not known statically. */
+  static int64_t Bytes(const Type& type) {
+    if (const auto* ttype = type.as<TensorTypeNode>()) {
+      int64_t size = (ttype->dtype.bits() * ttype->dtype.lanes() + 7) / 8;
+      for (const PrimExpr& dim : ttype->shape) {
+        const auto* extent = dim.as<IntImmNode>();
+        if (extent == nullptr) return -1;
+        size *= extent->value;
+      }
+      return size;
+    }
+    if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+      int64_t size = 0;
+      for (const Type& field : tuple_type->fields) {
+        int64_t bytes = Bytes(field);
+        if (bytes < 0) return -1;
+        size += bytes;
+      }
+      return size;
+    }
+    return -1;
+  }
+
+  /*! \brief The body of the function. */
+  Expr body_;
+  /*! \brief The arena of the dependency graph. */
+  support::Arena arena_;
+  /*! \brief The calls in post DFS order. */
+  std::vector<Expr> calls_;
+  /*! \brief The bytes of the output of each call. */
+  std::vector<int64_t> bytes_;
+  /*! \brief The calls whose outputs each call uses. */
+  std::vector<std::vector<int>> deps_;
+  /*! \brief The calls using the output of each call. */
+  std::vector<std::vector<int>> consumers_;
+  /*! \brief The number of calls using the output of each call. */
+  std::vector<int> users_;
+  /*! \brief The calls whose outputs are returned by the function. */
+  std::unordered_set<int> outputs_;
+};
+
+namespace transform {
+
+Pass ReorderForMemory() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        CallScheduler scheduler(f->body);
+        if (!scheduler.Init()) return f;
+        std::vector<int> order = scheduler.Search();
+        int64_t before = scheduler.Peak(scheduler.DefaultOrder());
+        int64_t after = scheduler.Peak(order);
+        if (pc->GetConfig<Bool>("relay.ReorderForMemory.report", Bool(false)).value()) {
+          LOG(INFO) << "ReorderForMemory: peak live bytes " << before << " -> " << after;
+        }
+        if (after >= before) return f;
+        return Function(f->params, scheduler.Rewrite(order), f->ret_type, f->type_params, f->attrs,
+                        f->span);
+      };
+  return CreateFunctionPass(pass_func, 4, "ReorderForMemory", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.ReorderForMemory").set_body_typed(ReorderForMemory);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
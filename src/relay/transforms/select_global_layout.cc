@@ -0,0 +1,500 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file select_global_layout.cc
+ * \brief Select the NCHWc layouts of the convolutions of a function together.
+ *
+ * AlterOpLayout picks the channel blocking of each convolution on its own, so
+ * neighbouring convolutions may disagree and layout_transform is inserted
+ * between them. This pass builds a graph whose nodes are the convolutions,
+ * each with its candidate blockings priced by a tuning log or a default model,
+ * and whose edges price the layout transforms between the blockings of
+ * connected convolutions. The assignment is solved by dynamic programming,
+ * exact on chains, refined by iterated conditional modes on DAGs, and applied
+ * with the layout rewriter of AlterOpLayout.
+ */
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "picojson.h"
+#include "pattern_utils.h"
+#include "transform_layout.h"
+
+namespace tvm {
+namespace relay {
+
+struct SelectGlobalLayoutConfigNode : public tvm::AttrsNode<SelectGlobalLayoutConfigNode> {
+  String log_file;
+  Array<Integer> block_sizes;
+  double peak_gflops;
+  double bandwidth_gbps;
+  int vector_lanes;
+
+  TVM_DECLARE_ATTRS(SelectGlobalLayoutConfigNode, "relay.transform.SelectGlobalLayoutConfig") {
+    TVM_ATTR_FIELD(log_file)
+        .describe("An autotvm log with conv2d_NCHWc records, the default model prices the rest")
+        .set_default("");
+    TVM_ATTR_FIELD(block_sizes)
+        .describe("The candidate blockings of the channels")
+        .set_default(Array<Integer>({4, 8, 16, 32, 64}));
+    TVM_ATTR_FIELD(peak_gflops)
+        .describe("The peak throughput of the default model of the convolutions")
+        .set_default(100.0);
+    TVM_ATTR_FIELD(bandwidth_gbps)
+        .describe("The memory bandwidth pricing the layout transforms, in GB/s")
+        .set_default(10.0);
+    TVM_ATTR_FIELD(vector_lanes)
+        .describe("The vector lanes of the default model, a smaller output blocking is slower")
+        .set_default(16);
+  }
+};
+
+class SelectGlobalLayoutConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(SelectGlobalLayoutConfig, Attrs,
+                                            SelectGlobalLayoutConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(SelectGlobalLayoutConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.SelectGlobalLayout", SelectGlobalLayoutConfig);
+
+namespace select_global_layout {
+
+/*! \brief The blocking of the input and output channels of a convolution. */
+using ChannelBlocks = std::pair<int, int>;
+
+/*! \brief The best time of each blocking of the convolution workloads. */
+using KernelCosts = std::unordered_map<std::string, std::map<ChannelBlocks, double>>;
+
+std::string WorkloadKey(const std::vector<int64_t>& data, const std::vector<int64_t>& kernel,
+                        const std::vector<int64_t>& strides, std::vector<int64_t> padding,
+                        const std::vector<int64_t>& dilation) {
+  // The padding of a workload is (top, left, bottom, right).
+  if (padding.size() == 1) padding.resize(2, padding[0]);
+  if (padding.size() == 2) padding = {padding[0], padding[1], padding[0], padding[1]};
+  std::ostringstream os;
+  const std::vector<int64_t>* fields[] = {&data, &kernel, &strides, &padding, &dilation};
+  for (const std::vector<int64_t>* values : fields) {
+    for (int64_t v : *values) os << v << ",";
+    os << ";";
+  }
+  return os.str();
+}
+
+/*! \brief Read the records of the NCHWc convolutions of an autotvm log. */
+KernelCosts LoadKernelCosts(const std::string& path) {
+  KernelCosts costs;
+  std::ifstream is(path);
+  if (!is.good()) {
+    LOG(WARNING) << "SelectGlobalLayout: cannot open the log " << path;
+    return costs;
+  }
+  auto ints = [](const picojson::value& v) {
+    std::vector<int64_t> ret;
+    for (const auto& x : v.get<picojson::array>()) {
+      ret.push_back(static_cast<int64_t>(x.get<double>()));
+    }
+    return ret;
+  };
+  std::string line;
+  while (std::getline(is, line)) {
+    picojson::value record;
+    if (!picojson::parse(record, line).empty() || !record.is<picojson::object>()) continue;
+    try {
+      const auto& input = record.get("input").get<picojson::array>();
+      if (input[1].get<std::string>().find("NCHWc") == std::string::npos) continue;
+      const auto& result = record.get("result").get<picojson::array>();
+      if (result[1].get<double>() != 0) continue;
+      ChannelBlocks blocks{0, 0};
+      for (const auto& knob : record.get("config").get("entity").get<picojson::array>()) {
+        const auto& entity = knob.get<picojson::array>();
+        const std::string& name = entity[0].get<std::string>();
+        if (name != "tile_ic" && name != "tile_oc") continue;
+        int factor = static_cast<int>(entity[2].get<picojson::array>().back().get<double>());
+        (name == "tile_ic" ? blocks.first : blocks.second) = factor;
+      }
+      if (blocks.first == 0 || blocks.second == 0) continue;
+      double time = 0;
+      const auto& times = result[0].get<picojson::array>();
+      for (const auto& t : times) time += t.get<double>();
+      time /= std::max<size_t>(times.size(), 1);
+      const auto& args = input[2].get<picojson::array>();
+      std::string key = WorkloadKey(ints(args[0].get<picojson::array>()[1]),
+                                    ints(args[1].get<picojson::array>()[1]), ints(args[2]),
+                                    ints(args[3]), ints(args[4]));
+      auto it = costs[key].find(blocks);
+      if (it == costs[key].end() || time < it->second) costs[key][blocks] = time;
+    } catch (const std::exception& e) {
+      DLOG(INFO) << "SelectGlobalLayout: skip a malformed record: " << e.what();
+    }
+  }
+  return costs;
+}
+
+/*! \brief A convolution and the costs of its candidate blockings. */
+struct ConvNode {
+  const CallNode* call;
+  bool depthwise;
+  std::vector<ChannelBlocks> candidates;
+  std::vector<double> costs;
+};
+
+/*!
+ * \brief A layout transform between two convolutions, needed when the output
+ *  blocking of the source differs from the input blocking of the destination,
+ *  or from its output blocking when the two outputs join in an elementwise op.
+ */
+struct LayoutEdge {
+  int src;
+  int dst;
+  bool join;
+  double cost;
+};
+
+/*! \brief Collect the convolutions and the layout transforms between them. */
+class ConvGraphBuilder : private ExprVisitor {
+ public:
+  ConvGraphBuilder(const SelectGlobalLayoutConfig& cfg, const KernelCosts& kernel_costs)
+      : cfg_(cfg), kernel_costs_(kernel_costs) {}
+
+  void Build(const Function& func) { VisitExpr(func->body); }
+
+  std::vector<ConvNode> nodes;
+  std::vector<LayoutEdge> edges;
+
+ private:
+  void VisitExpr_(const FunctionNode* op) final {
+    // Only the convolutions of the body are selected.
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    ExprVisitor::VisitExpr_(op);
+    static const Op& conv2d = Op::Get("nn.conv2d");
+    static const Op& max_pool2d = Op::Get("nn.max_pool2d");
+    static const Op& avg_pool2d = Op::Get("nn.avg_pool2d");
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    const auto* ttype = op->checked_type_.as<TensorTypeNode>();
+    if (ttype == nullptr || ttype->shape.size() != 4) return;
+    if (op->op == conv2d && AddConv(op)) return;
+    const auto* callee = op->op.as<OpNode>();
+    if (callee == nullptr) return;
+    Op callee_op = GetRef<Op>(callee);
+    bool transparent = fpattern.get(callee_op, kOpaque) <= kBroadcast ||
+                       callee_op == max_pool2d || callee_op == avg_pool2d;
+    if (!transparent) return;
+    // The op keeps the blocking of its inputs, which must agree.
+    std::vector<int>& producers = producers_[op];
+    for (const Expr& arg : op->args) {
+      auto it = producers_.find(arg.get());
+      if (it == producers_.end()) continue;
+      for (int p : it->second) {
+        if (std::find(producers.begin(), producers.end(), p) != producers.end()) continue;
+        // The edges of the ops with a dynamic shape are not costed.
+        int64_t bytes;
+        if (!producers.empty() && Bytes(op->checked_type_, &bytes)) {
+          AddEdge(producers[0], p, true, bytes);
+        }
+        producers.push_back(p);
+      }
+    }
+  }
+
+  bool AddConv(const CallNode* op) {
+    const auto* attrs = op->attrs.as<Conv2DAttrs>();
+    const auto* data = op->args[0]->checked_type_.as<TensorTypeNode>();
+    const auto* kernel = op->args[1]->checked_type_.as<TensorTypeNode>();
+    if (attrs->data_layout != "NCHW" || attrs->kernel_layout != "OIHW" ||
+        !(attrs->out_layout.empty() || attrs->out_layout == "NCHW") || data == nullptr ||
+        kernel == nullptr) {
+      return false;
+    }
+    std::vector<int64_t> data_shape, kernel_shape, strides, padding, dilation;
+    if (!ConstInts(data->shape, &data_shape) || !ConstInts(kernel->shape, &kernel_shape) ||
+        !ConstInts(attrs->strides, &strides) || !ConstInts(attrs->padding, &padding) ||
+        !ConstInts(attrs->dilation, &dilation)) {
+      return false;
+    }
+    int64_t in_channels = data_shape[1], out_channels = kernel_shape[0];
+    ConvNode node{op, attrs->groups > 1, {}, {}};
+    if (node.depthwise && (attrs->groups != in_channels || out_channels != in_channels)) {
+      return false;
+    }
+    if (!node.depthwise && attrs->groups != 1) return false;
+    auto it = kernel_costs_.find(
+        WorkloadKey(data_shape, kernel_shape, strides, padding, dilation));
+    if (it != kernel_costs_.end()) {
+      for (const auto& kv : it->second) {
+        if (in_channels % kv.first.first != 0 || out_channels % kv.first.second != 0) continue;
+        if (node.depthwise && kv.first.first != kv.first.second) continue;
+        node.candidates.push_back(kv.first);
+        node.costs.push_back(kv.second);
+      }
+    }
+    if (node.candidates.empty()) {
+      // The default model, the throughput drops when the output blocking fills less
+      // than a vector.
+      const auto* out = op->checked_type_.as<TensorTypeNode>();
+      int64_t out_bytes;
+      if (!Bytes(op->checked_type_, &out_bytes)) return false;
+      double flops = 2.0 * out_bytes / out->dtype.bytes() * kernel_shape[1] * kernel_shape[2] *
+                     kernel_shape[3];
+      for (const Integer& in : cfg_->block_sizes) {
+        for (const Integer& out : cfg_->block_sizes) {
+          if (in_channels % in->value != 0 || out_channels % out->value != 0) continue;
+          if (node.depthwise && in->value != out->value) continue;
+          double lanes = std::min<int64_t>(out->value, cfg_->vector_lanes);
+          node.candidates.emplace_back(in->value, out->value);
+          node.costs.push_back(flops / (cfg_->peak_gflops * 1e9 * lanes / cfg_->vector_lanes));
+        }
+      }
+    }
+    if (node.candidates.empty()) return false;
+    int id = nodes.size();
+    nodes.push_back(std::move(node));
+    producers_[op] = {id};
+    auto it_data = producers_.find(op->args[0].get());
+    int64_t data_bytes;
+    if (it_data != producers_.end() && Bytes(op->args[0]->checked_type_, &data_bytes)) {
+      for (int p : it_data->second) AddEdge(p, id, false, data_bytes);
+    }
+    return true;
+  }
+
+  void AddEdge(int src, int dst, bool join, int64_t bytes) {
+    if (src > dst) std::swap(src, dst);
+    // Reading and writing each byte.
+    edges.push_back({src, dst, join, 2.0 * bytes / (cfg_->bandwidth_gbps * 1e9)});
+  }
+
+  static bool ConstInts(const Array<PrimExpr>& values, std::vector<int64_t>* out) {
+    for (const PrimExpr& v : values) {
+      const auto* imm = v.as<IntImmNode>();
+      if (imm == nullptr) return false;
+      out->push_back(imm->value);
+    }
+    return true;
+  }
+
+  static bool Bytes(const Type& type, int64_t* bytes) {
+    const auto* ttype = type.as<TensorTypeNode>();
+    std::vector<int64_t> shape;
+    if (ttype == nullptr || !ConstInts(ttype->shape, &shape)) return false;
+    *bytes = ttype->dtype.bytes();
+    for (int64_t dim : shape) *bytes *= dim;
+    return true;
+  }
+
+  /*! \brief The configuration of the pass. */
+  SelectGlobalLayoutConfig cfg_;
+  /*! \brief The costs read from the tuning log. */
+  const KernelCosts& kernel_costs_;
+  /*! \brief The convolutions whose output blocking each expression keeps. */
+  std::unordered_map<const Object*, std::vector<int>> producers_;
+};
+
+/*! \brief The cost of an edge between two candidates. */
+double EdgeCost(const LayoutEdge& e, const ChannelBlocks& src, const ChannelBlocks& dst) {
+  int dst_blocks = e.join ? dst.second : dst.first;
+  return src.second != dst_blocks ? e.cost : 0.0;
+}
+
+/*!
+ * \brief Solve the assignment of the candidates. A dynamic program in the post DFS order
+ *  is exact when the convolutions form a chain, the shared inputs of a DAG are then
+ *  refined with iterated conditional modes.
+ * \return The index of the candidate chosen for each convolution.
+ */
+std::vector<int> SolveLayouts(const std::vector<ConvNode>& nodes,
+                              const std::vector<LayoutEdge>& edges) {
+  size_t num_nodes = nodes.size();
+  std::vector<std::vector<int>> in_edges(num_nodes), incident(num_nodes);
+  for (size_t i = 0; i < edges.size(); ++i) {
+    in_edges[edges[i].dst].push_back(i);
+    incident[edges[i].src].push_back(i);
+    incident[edges[i].dst].push_back(i);
+  }
+  // dp[i][s]: the cost of the convolutions up to i with the candidate s for i.
+  std::vector<std::vector<double>> dp(num_nodes);
+  // choice[e][s]: the best candidate of the source of e for the candidate s of its destination.
+  std::vector<std::vector<int>> choice(edges.size());
+  for (size_t i = 0; i < num_nodes; ++i) {
+    dp[i] = nodes[i].costs;
+    for (int e : in_edges[i]) {
+      const LayoutEdge& edge = edges[e];
+      const ConvNode& src = nodes[edge.src];
+      choice[e].resize(nodes[i].candidates.size());
+      for (size_t s = 0; s < nodes[i].candidates.size(); ++s) {
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t t = 0; t < src.candidates.size(); ++t) {
+          double cost =
+              dp[edge.src][t] + EdgeCost(edge, src.candidates[t], nodes[i].candidates[s]);
+          if (cost < best) {
+            best = cost;
+            choice[e][s] = t;
+          }
+        }
+        dp[i][s] += best;
+      }
+    }
+  }
+  // Backtrack from the last convolutions.
+  std::vector<int> assign(num_nodes, -1);
+  for (int i = static_cast<int>(num_nodes) - 1; i >= 0; --i) {
+    if (assign[i] < 0) {
+      assign[i] = std::min_element(dp[i].begin(), dp[i].end()) - dp[i].begin();
+    }
+    for (int e : in_edges[i]) {
+      if (assign[edges[e].src] < 0) assign[edges[e].src] = choice[e][assign[i]];
+    }
+  }
+  auto local_cost = [&](size_t i, size_t s) {
+    double cost = nodes[i].costs[s];
+    for (int e : incident[i]) {
+      const LayoutEdge& edge = edges[e];
+      const ConvNode& src = nodes[edge.src];
+      const ConvNode& dst = nodes[edge.dst];
+      if (edge.src == static_cast<int>(i)) {
+        cost += EdgeCost(edge, src.candidates[s], dst.candidates[assign[edge.dst]]);
+      } else {
+        cost += EdgeCost(edge, src.candidates[assign[edge.src]], dst.candidates[s]);
+      }
+    }
+    return cost;
+  };
+  for (int iter = 0; iter < 16; ++iter) {
+    bool changed = false;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      double best = local_cost(i, assign[i]);
+      for (size_t s = 0; s < nodes[i].candidates.size(); ++s) {
+        double cost = local_cost(i, s);
+        if (cost < best) {
+          best = cost;
+          assign[i] = s;
+          changed = true;
+        }
+      }
+    }
+    if (!changed) break;
+  }
+  return assign;
+}
+
+/*! \brief The layouts selected for the convolutions. */
+class SelectTransformMemorizerNode : public TransformMemorizerNode {
+ public:
+  std::unordered_map<const Object*, std::pair<ChannelBlocks, bool>> selection;
+
+  static constexpr const char* _type_key = "relay.select_global_layout.SelectTransformMemorizer";
+};
+
+/*! \brief Rewrite the selected convolutions to the NCHWc convolutions. */
+class SelectTransformMemorizer : public TransformMemorizer {
+ public:
+  SelectTransformMemorizer() {}
+  explicit SelectTransformMemorizer(ObjectPtr<Object> n) : TransformMemorizer(n) {}
+
+  SelectTransformMemorizerNode* operator->() {
+    return static_cast<SelectTransformMemorizerNode*>(get_mutable());
+  }
+
+  Call CallWithNewLayouts(const Call& ref_call, Attrs new_attrs,
+                          const std::vector<Expr>& new_args) override {
+    auto it = operator->()->selection.find(ref_call.get());
+    if (it == operator->()->selection.end()) {
+      return Call(ref_call->op, new_args, new_attrs, {}, ref_call->span);
+    }
+    int in = it->second.first.first, out = it->second.first.second;
+    bool depthwise = it->second.second;
+    const auto* kernel = ref_call->args[1]->type_as<TensorTypeNode>();
+    auto attrs = make_object<Conv2DAttrs>(*new_attrs.as<Conv2DAttrs>());
+    attrs->channels = kernel->shape[0];
+    attrs->kernel_size = {kernel->shape[2], kernel->shape[3]};
+    attrs->data_layout = "NCHW" + std::to_string(in) + "c";
+    attrs->kernel_layout = "OIHW" + std::to_string(depthwise ? 1 : in) + "i" +
+                           std::to_string(out) + "o";
+    attrs->out_layout = "NCHW" + std::to_string(out) + "c";
+    const Op& op = depthwise ? Op::Get("nn.contrib_depthwise_conv2d_NCHWc")
+                             : Op::Get("nn.contrib_conv2d_NCHWc");
+    return Call(op, new_args, Attrs(attrs), {}, ref_call->span);
+  }
+
+  using TransformMemorizer::CallWithNewLayouts;
+  using ContainerType = SelectTransformMemorizerNode;
+};
+
+Expr SelectGlobalLayout(const Function& func, const SelectGlobalLayoutConfig& cfg) {
+  KernelCosts kernel_costs;
+  if (!cfg->log_file.empty()) kernel_costs = LoadKernelCosts(cfg->log_file);
+  ConvGraphBuilder builder(cfg, kernel_costs);
+  builder.Build(func);
+  if (builder.nodes.empty()) return func;
+  std::vector<int> assign = SolveLayouts(builder.nodes, builder.edges);
+
+  SelectTransformMemorizer memorizer(make_object<SelectTransformMemorizerNode>());
+  size_t num_transforms = 0;
+  for (size_t i = 0; i < builder.nodes.size(); ++i) {
+    const ConvNode& node = builder.nodes[i];
+    memorizer->selection[node.call] = {node.candidates[assign[i]], node.depthwise};
+  }
+  for (const LayoutEdge& e : builder.edges) {
+    const ChannelBlocks& src = builder.nodes[e.src].candidates[assign[e.src]];
+    const ChannelBlocks& dst = builder.nodes[e.dst].candidates[assign[e.dst]];
+    num_transforms += EdgeCost(e, src, dst) > 0;
+  }
+  DLOG(INFO) << "SelectGlobalLayout: " << builder.nodes.size() << " convolutions, "
+             << num_transforms << " layout transforms between them";
+  auto fcontext = [&](const Call& call) -> ObjectRef { return memorizer; };
+  return ForwardRewrite(func, LayoutRewriter<SelectTransformMemorizer>, fcontext);
+}
+
+}  // namespace select_global_layout
+
+namespace transform {
+
+Pass SelectGlobalLayout() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        auto cfg = pc->GetConfig<SelectGlobalLayoutConfig>(
+            "relay.SelectGlobalLayout", AttrsWithDefaultValues<SelectGlobalLayoutConfig>());
+        return Downcast<Function>(
+            relay::select_global_layout::SelectGlobalLayout(f, cfg.value()));
+      };
+  return CreateFunctionPass(pass_func, 3, "SelectGlobalLayout", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.SelectGlobalLayout").set_body_typed(SelectGlobalLayout);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
@@ -25,10 +25,12 @@
  */
 
 #include <tvm/ir/attrs.h>
+#include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/object.h>
 
+#include <unordered_set>
 #include <utility>
 
 #include "pattern_utils.h"
@@ -67,6 +69,33 @@ using CachedCastNodes = std::unordered_map<std::pair<const ExprNode*, DataType>,
 using FTVMMixedPrecisionConversionType = runtime::TypedPackedFunc<Array<ObjectRef>(
     const Call& call_node, const std::string& target_dtype_str)>;
 
+// The indices in MixedPrecisionLayers of the layers of main kept in FP32, e.g. the layers found
+// too sensitive by the accuracy-budgeted search of relay.transform.mixed_precision_search. The
+// other functions of the module are converted as a whole.
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.ToMixedPrecision.keep_fp32_layers", Array<Integer>);
+
+/*!
+ * \brief The layers of a graph, the calls to the ops of category MIXED_PRECISION_ALWAYS in post
+ * DFS order. They are the unit of the per-layer precision selection.
+ */
+Array<Call> MixedPrecisionLayers(const Expr& expr, const DataType& mixed_precision_type) {
+  static auto attr_map =
+      Op::GetAttrMap<FTVMMixedPrecisionConversionType>("FTVMMixedPrecisionConversionType");
+  Array<Call> layers;
+  PostOrderVisit(expr, [&](const Expr& e) {
+    const auto* call = e.as<CallNode>();
+    if (call == nullptr || !call->op.as<OpNode>()) return;
+    Op op = Downcast<Op>(call->op);
+    if (!attr_map.count(op)) return;
+    Array<ObjectRef> op_descriptor =
+        attr_map[op](GetRef<Call>(call), DLDataType2String(mixed_precision_type));
+    if (Downcast<Integer>(op_descriptor[0])->value == MIXED_PRECISION_ALWAYS) {
+      layers.push_back(GetRef<Call>(call));
+    }
+  });
+  return layers;
+}
+
 /*! \brief This class transforms the given relay module into a version where
  * as many operations as possible operate in the target mixed precision dtype.
  *
@@ -106,6 +135,9 @@ class MixedPrecisionPass : public MixedModeMutator {
    */
   std::unordered_map<std::string, int> missing_ops_;
 
+  /*! \brief The layers kept in FP32 despite their MIXED_PRECISION_ALWAYS category. */
+  std::unordered_set<const CallNode*> fp32_layers_;
+
   Attrs GetNewAttrs(const CallNode* call, const DataType& accumulation_dtype) const {
     /* If the accumulation dtype is in the attributes make a copy and mutate the field. */
     Attrs cur_attrs = call->attrs;
@@ -319,6 +351,11 @@ class MixedPrecisionPass : public MixedModeMutator {
         initial_category = static_cast<MixedTypeConversionCategory>(op_conversion_type);
         accumulation_dtype = DataType(String2DLDataType(Downcast<String>(op_descriptor[1])));
         output_dtype = DataType(String2DLDataType(Downcast<String>(op_descriptor[2])));
+        if (initial_category == MIXED_PRECISION_ALWAYS && fp32_layers_.count(pre_call_node)) {
+          initial_category = MIXED_PRECISION_NEVER;
+          accumulation_dtype = DataType::Float(32);
+          output_dtype = DataType::Float(32);
+        }
       } else {
         missing_ops_[op->name] += 1;
 
@@ -404,10 +441,11 @@ class MixedPrecisionPass : public MixedModeMutator {
 
   // To access map of ops not registered for error reporting
   friend Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type,
-                               int missing_op_mode);
+                               int missing_op_mode, bool is_main);
 };
 
-Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, int missing_op_mode) {
+Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, int missing_op_mode,
+                      bool is_main) {
   /*
   missing_op_mode:
 
@@ -419,6 +457,19 @@ Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, in
       << " missing_op_mode must be either 0, 1, or 2 got " << missing_op_mode;
 
   MixedPrecisionPass converter = MixedPrecisionPass(mixed_precision_type);
+  Array<Integer> keep_fp32_layers =
+      transform::PassContext::Current()
+          ->GetConfig<Array<Integer>>("relay.ToMixedPrecision.keep_fp32_layers", Array<Integer>())
+          .value();
+  if (is_main && !keep_fp32_layers.empty()) {
+    Array<Call> layers = MixedPrecisionLayers(expr, mixed_precision_type);
+    for (const Integer& index : keep_fp32_layers) {
+      ICHECK(index->value >= 0 && index->value < static_cast<int64_t>(layers.size()))
+          << "The layer " << index << " kept in FP32 is out of the " << layers.size()
+          << " layers";
+      converter.fp32_layers_.insert(layers[index->value].get());
+    }
+  }
   auto result = converter.Mutate(expr);
 
   for (auto it = converter.missing_ops_.begin();
@@ -442,13 +493,21 @@ namespace transform {
 Pass ToMixedPrecision(DataType mixed_precision_type, int missing_op_mode) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(ToMixedPrecision(f, mixed_precision_type, missing_op_mode));
+        // The layers kept in FP32 are indexed in main.
+        bool is_main = m->ContainGlobalVar("main") && m->Lookup("main").same_as(f);
+        return Downcast<Function>(
+            ToMixedPrecision(f, mixed_precision_type, missing_op_mode, is_main));
       };
   return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {});
 }
 
 TVM_REGISTER_GLOBAL("relay._transform.ToMixedPrecision").set_body_typed(ToMixedPrecision);
 
+TVM_REGISTER_GLOBAL("relay._transform.MixedPrecisionLayers")
+    .set_body_typed([](Function func, DataType mixed_precision_type) {
+      return MixedPrecisionLayers(func, mixed_precision_type);
+    });
+
 }  // namespace transform
 
 }  // namespace relay
@@ -45,6 +45,9 @@
 #include <tvm/relay/pattern_functor.h>
 #include <tvm/relay/transform.h>
 
+#include <unordered_set>
+#include <vector>
+
 #include "../analysis/type_solver.h"
 #include "pass_utils.h"
 
@@ -789,6 +792,146 @@ struct AllCheckTypePopulated : MixedModeVisitor {
 
 void EnsureCheckedType(const Expr& e) { AllCheckTypePopulated().VisitExpr(e); }
 
+/*!
+ * \brief Check whether a function keeps valid types from a previous inference, so it need
+ * not be checked again: the function and all its nodes are typed with complete types and no
+ * free type variables, the variables agree with their type annotations, and the calls agree
+ * with the types of the functions they call, the global ones being looked up in the module.
+ * The passes build new nodes when they change an expression, and the new nodes are not typed
+ * yet. A pass may however copy the checked types to the nodes it builds, so the signature of
+ * the function is checked against the annotations of its parameters.
+ */
+class CheckedTypeValidator : public ExprVisitor {
+ public:
+  explicit CheckedTypeValidator(const IRModule& mod) : mod_(mod) {}
+
+  bool Check(const Function& func) {
+    const auto* func_type = func->checked_type_.as<FuncTypeNode>();
+    if (func_type == nullptr || !func->body->checked_type_.defined() ||
+        func_type->arg_types.size() != func->params.size() ||
+        !StructuralEqual()(func_type->ret_type, func->body->checked_type_)) {
+      return false;
+    }
+    for (size_t i = 0; i < func->params.size(); ++i) {
+      if (!func->params[i]->checked_type_.defined() ||
+          !StructuralEqual()(func_type->arg_types[i], func->params[i]->checked_type_)) {
+        return false;
+      }
+      VisitExpr(func->params[i]);
+    }
+    if (!valid_ || !IsComplete(func->checked_type_) || !FreeTypeVars(func, mod_).empty()) {
+      return false;
+    }
+    VisitExpr(func->body);
+    return valid_;
+  }
+
+  // Expand the dataflow regions like MixedModeVisitor, except the global functions called,
+  // which are checked with their calls. The other global vars reached are used as values.
+  void VisitExpr(const Expr& expr) final {
+    auto fcheck_visited = [this](const Expr& expr) {
+      return !valid_ || visited_.count(expr.get()) != 0;
+    };
+    auto fvisit_leaf = [this](const Expr& expr) {
+      visited_.insert(expr.get());
+      VisitLeaf(expr);
+    };
+    auto fexpand_expr = [](const Expr& expr) {
+      std::vector<Expr> result;
+      if (const auto* op = expr.as<CallNode>()) {
+        for (auto it = op->args.rbegin(); it != op->args.rend(); ++it) {
+          result.push_back(*it);
+        }
+        if (!op->op.as<GlobalVarNode>()) result.push_back(op->op);
+      } else if (const auto* op = expr.as<TupleNode>()) {
+        for (auto it = op->fields.rbegin(); it != op->fields.rend(); ++it) {
+          result.push_back(*it);
+        }
+      } else if (const auto* op = expr.as<TupleGetItemNode>()) {
+        result.push_back(op->tuple);
+      }
+      return result;
+    };
+    ExpandDataflow(expr, fcheck_visited, fvisit_leaf, fexpand_expr);
+  }
+
+  void VisitExpr_(const CallNode* op) final {}
+  void VisitExpr_(const TupleNode* op) final {}
+  void VisitExpr_(const TupleGetItemNode* op) final {}
+
+  void VisitExpr_(const LetNode* op) final {
+    auto pre_visit = [this](const LetNode* op) {
+      if (!op->checked_type_.defined()) valid_ = false;
+      this->VisitExpr(op->var);
+      this->VisitExpr(op->value);
+    };
+    auto post_visit = [this](const LetNode* op) { this->VisitExpr(op->body); };
+    ExpandANormalForm(op, pre_visit, post_visit);
+  }
+
+ private:
+  void VisitLeaf(const Expr& expr) {
+    if (!valid_ || expr.as<OpNode>() || expr.as<ConstructorNode>()) return;
+    if (expr.as<GlobalVarNode>() || !expr->checked_type_.defined() ||
+        !IsComplete(expr->checked_type_)) {
+      valid_ = false;
+      return;
+    }
+    if (const auto* var = expr.as<VarNode>()) {
+      if (var->type_annotation.defined() &&
+          !StructuralEqual()(var->type_annotation, var->checked_type_)) {
+        valid_ = false;
+        return;
+      }
+    }
+    if (const auto* call = expr.as<CallNode>()) {
+      if (const auto* global = call->op.as<GlobalVarNode>()) {
+        valid_ = CheckGlobalCall(call, GetRef<GlobalVar>(global));
+      } else if (!call->op.as<OpNode>() && !call->op.as<ConstructorNode>()) {
+        // The type relations of the operators and constructors are not solved again here,
+        // the calls to local functions must agree with the type of the function.
+        valid_ = CheckCallType(call, call->op->checked_type_.as<FuncTypeNode>());
+      }
+    }
+    ExprFunctor::VisitExpr(expr);
+  }
+
+  bool CheckGlobalCall(const CallNode* call, const GlobalVar& global) const {
+    if (!valid_ || !mod_->ContainGlobalVar(global->name_hint)) return false;
+    const auto* callee = mod_->Lookup(global).as<FunctionNode>();
+    if (callee == nullptr) return false;
+    return CheckCallType(call, callee->checked_type_.as<FuncTypeNode>());
+  }
+
+  bool CheckCallType(const CallNode* call, const FuncTypeNode* callee_type) const {
+    if (callee_type == nullptr || !callee_type->type_params.empty() ||
+        callee_type->arg_types.size() != call->args.size() ||
+        !StructuralEqual()(callee_type->ret_type, call->checked_type_)) {
+      return false;
+    }
+    for (size_t i = 0; i < call->args.size(); ++i) {
+      if (!call->args[i]->checked_type_.defined() ||
+          !StructuralEqual()(callee_type->arg_types[i], call->args[i]->checked_type_)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool IsComplete(const Type& type) {
+    struct IncompleteTypeFinder : TypeVisitor {
+      void VisitType_(const IncompleteTypeNode* op) final { found = true; }
+      bool found{false};
+    } finder;
+    finder.VisitType(type);
+    return !finder.found;
+  }
+
+  IRModule mod_;
+  bool valid_{true};
+  std::unordered_set<const Object*> visited_;
+};
+
 // TODO(@jroesch): Can we optimize this?
 void AddGlobalTypes(IRModule mod) {
   std::vector<std::pair<GlobalVar, Function> > updates;
@@ -811,6 +954,8 @@ void AddGlobalTypes(IRModule mod) {
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.InferType.incremental", Bool);
+
 Pass InferType() {
   auto pass_info = PassInfo(0, "InferType", {});
   return tvm::transform::CreateModulePass(
@@ -825,47 +970,64 @@ Pass InferType() {
         // Add all the type annotations to the functions in the model.
         AddGlobalTypes(mod);
 
-        std::vector<std::pair<GlobalVar, Function> > updates;
-        for (const auto& it : updated_mod->functions) {
-          // Currently we don't type check TIR.
-          //
-          // The inferencer will only check Relay functions.
-
-          // In the future we plan a unified type checker
-          // that works on TIR and Relay at the same time.
-          if (auto* func_node = it.second.as<FunctionNode>()) {
-            auto func = GetRef<Function>(func_node);
-
-            // // If a function already has type information we can skip checking it.
-            // if (func->checked_type_.defined()) {
-            //   continue;
-            // }
-
-            // TODO(@jroesch): we should be able to move the type inferencer outside
-            // of this function but it seems to be more stateful then I expect.
-            auto inferencer = TypeInferencer(mod, pass_ctx->diag_ctx.value());
-            auto updated_func = inferencer.Infer(it.first, func);
-
-            pass_ctx->diag_ctx.value().Render();
-
-            // After we are done checking write the global type back
-            // into the global var.
-            it.first->checked_type_ = updated_func->checked_type();
-
-            if (!WellFormed(updated_func, pass_ctx->diag_ctx)) {
-              LOG(FATAL) << "The type checked intermediate representation is malformed";
+        // In the incremental mode, the functions keeping valid types from a previous inference
+        // are not checked again. When the type of a checked function changes, the functions
+        // calling it are validated again in the next round.
+        bool incremental = pass_ctx->GetConfig<Bool>("relay.InferType.incremental", Bool(false))
+                               .value()
+                               ->value;
+        std::unordered_set<const GlobalVarNode*> checked;
+        bool changed = true;
+        while (changed) {
+          changed = false;
+          std::vector<std::pair<GlobalVar, Function> > updates;
+          for (const auto& it : updated_mod->functions) {
+            // Currently we don't type check TIR.
+            //
+            // The inferencer will only check Relay functions.
+
+            // In the future we plan a unified type checker
+            // that works on TIR and Relay at the same time.
+            if (auto* func_node = it.second.as<FunctionNode>()) {
+              auto func = GetRef<Function>(func_node);
+              if (checked.count(it.first.get())) continue;
+              if (incremental && CheckedTypeValidator(updated_mod).Check(func)) {
+                it.first->checked_type_ = func->checked_type();
+                continue;
+              }
+              checked.insert(it.first.get());
+
+              // TODO(@jroesch): we should be able to move the type inferencer outside
+              // of this function but it seems to be more stateful then I expect.
+              auto inferencer = TypeInferencer(mod, pass_ctx->diag_ctx.value());
+              auto updated_func = inferencer.Infer(it.first, func);
+
+              pass_ctx->diag_ctx.value().Render();
+
+              // After we are done checking write the global type back
+              // into the global var.
+              it.first->checked_type_ = updated_func->checked_type();
+
+              if (!WellFormed(updated_func, pass_ctx->diag_ctx)) {
+                LOG(FATAL) << "The type checked intermediate representation is malformed";
+              }
+
+              auto free_tvars = FreeTypeVars(updated_func, mod);
+              ICHECK(free_tvars.size() == 0)
+                  << "Found unbound type variables in " << updated_func << ": " << free_tvars;
+              EnsureCheckedType(updated_func);
+              updates.push_back({it.first, Downcast<Function>(updated_func)});
+              // The callers validated in this round saw the previous type of the function.
+              if (!func->checked_type_.defined() ||
+                  !StructuralEqual()(func->checked_type_, updated_func->checked_type())) {
+                changed = incremental;
+              }
             }
-
-            auto free_tvars = FreeTypeVars(updated_func, mod);
-            ICHECK(free_tvars.size() == 0)
-                << "Found unbound type variables in " << updated_func << ": " << free_tvars;
-            EnsureCheckedType(updated_func);
-            updates.push_back({it.first, Downcast<Function>(updated_func)});
           }
-        }
 
-        for (const auto& pair : updates) {
-          updated_mod->Add(pair.first, pair.second, true);
+          for (const auto& pair : updates) {
+            updated_mod->Add(pair.first, pair.second, true);
+          }
         }
 
         return updated_mod;
@@ -0,0 +1,216 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file perf_event.cc
+ * \brief Hardware performance counter collection for the profiler using Linux perf_event_open.
+ */
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/registry.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief A hardware event that can be counted with perf_event_open. */
+struct PerfEvent {
+  /*! \brief Name of the event as accepted by PerfEventCollector. */
+  const char* name;
+  /*! \brief Name of the column in the profiling report. */
+  const char* metric;
+  /*! \brief The PERF_COUNT_HW_* event id. */
+  uint64_t config;
+};
+
+static const PerfEvent kPerfEvents[] = {
+    {"cycles", "Cycles", PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", "Instructions", PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache-references", "Cache References", PERF_COUNT_HW_CACHE_REFERENCES},
+    {"cache-misses", "Cache Misses", PERF_COUNT_HW_CACHE_MISSES},
+    {"branches", "Branches", PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch-misses", "Branch Misses", PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+/*! \brief Counter values at the start of a call, one vector per monitored thread. */
+class PerfEventStartNode : public Object {
+ public:
+  std::vector<std::vector<uint64_t>> values;
+
+  static constexpr const char* _type_key = "runtime.profiling.PerfEventStart";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PerfEventStartNode, Object);
+};
+TVM_REGISTER_OBJECT_TYPE(PerfEventStartNode);
+
+/*! \brief Collects hardware counters on CPU devices using Linux perf_event_open.
+ *
+ * One group of counters is opened for every thread of the process when the
+ * profiler starts, so the work done by the TVM thread pool is included. The
+ * counters run for the whole profiling session and every call reports the
+ * difference between the values read at `StopCall` and at `StartCall`.
+ */
+class PerfEventCollectorNode final : public MetricCollectorNode {
+ public:
+  explicit PerfEventCollectorNode(std::vector<const PerfEvent*> events)
+      : events_(std::move(events)) {}
+
+  void Init(const std::vector<Device>& devs) final {
+    CloseAll();
+    DIR* dir = opendir("/proc/self/task");
+    if (dir == nullptr) {
+      LOG(WARNING) << "PerfEventCollector: cannot list the threads of this process, "
+                   << "hardware counters will not be collected.";
+      return;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+      if (entry->d_name[0] == '.') continue;
+      pid_t tid = static_cast<pid_t>(std::stoi(entry->d_name));
+      std::vector<int> fds = OpenGroup(tid);
+      if (!fds.empty()) {
+        groups_.push_back(std::move(fds));
+      }
+    }
+    closedir(dir);
+    for (auto& fds : groups_) {
+      ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  ObjectRef Start(Device dev) final {
+    if (dev.device_type != kDLCPU || groups_.empty()) {
+      return ObjectRef(nullptr);
+    }
+    auto node = make_object<PerfEventStartNode>();
+    node->values.reserve(groups_.size());
+    for (auto& fds : groups_) {
+      node->values.push_back(ReadGroup(fds[0]));
+    }
+    return ObjectRef(node);
+  }
+
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    const auto* start = obj.as<PerfEventStartNode>();
+    ICHECK(start != nullptr);
+    std::vector<int64_t> totals(events_.size(), 0);
+    for (size_t i = 0; i < groups_.size(); ++i) {
+      std::vector<uint64_t> end = ReadGroup(groups_[i][0]);
+      for (size_t j = 0; j < events_.size(); ++j) {
+        totals[j] += static_cast<int64_t>(end[j] - start->values[i][j]);
+      }
+    }
+    Map<String, ObjectRef> metrics;
+    for (size_t j = 0; j < events_.size(); ++j) {
+      metrics.Set(events_[j]->metric, ObjectRef(make_object<CountNode>(totals[j])));
+    }
+    return metrics;
+  }
+
+  ~PerfEventCollectorNode() final { CloseAll(); }
+
+  static constexpr const char* _type_key = "runtime.profiling.PerfEventCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PerfEventCollectorNode, MetricCollectorNode);
+
+ private:
+  /*! \brief Open one counter group on thread `tid`, the first event is the group leader. */
+  std::vector<int> OpenGroup(pid_t tid) {
+    std::vector<int> fds;
+    for (const PerfEvent* event : events_) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = event->config;
+      attr.disabled = fds.empty() ? 1 : 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      int group_fd = fds.empty() ? -1 : fds[0];
+      int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, tid, -1, group_fd, 0));
+      if (fd < 0) {
+        // Threads may exit between listing and opening, only warn on the first failure.
+        if (!warned_) {
+          LOG(WARNING) << "PerfEventCollector: perf_event_open failed for event " << event->name
+                       << ": " << strerror(errno)
+                       << ". Check /proc/sys/kernel/perf_event_paranoid.";
+          warned_ = true;
+        }
+        for (int x : fds) close(x);
+        return {};
+      }
+      fds.push_back(fd);
+    }
+    return fds;
+  }
+
+  /*! \brief Read all counters of a group through its leader. */
+  std::vector<uint64_t> ReadGroup(int leader) {
+    // layout of PERF_FORMAT_GROUP: { u64 nr; u64 values[nr]; }
+    std::vector<uint64_t> buf(events_.size() + 1, 0);
+    ssize_t n = read(leader, buf.data(), buf.size() * sizeof(uint64_t));
+    ICHECK_EQ(n, static_cast<ssize_t>(buf.size() * sizeof(uint64_t)))
+        << "PerfEventCollector: failed to read hardware counters";
+    return std::vector<uint64_t>(buf.begin() + 1, buf.end());
+  }
+
+  void CloseAll() {
+    for (auto& fds : groups_) {
+      for (int fd : fds) close(fd);
+    }
+    groups_.clear();
+  }
+
+  /*! \brief The counted events. */
+  std::vector<const PerfEvent*> events_;
+  /*! \brief The file descriptors of the counter group of every monitored thread. */
+  std::vector<std::vector<int>> groups_;
+  /*! \brief Whether a failure of perf_event_open has been reported. */
+  bool warned_{false};
+};
+
+TVM_REGISTER_OBJECT_TYPE(PerfEventCollectorNode);
+
+TVM_REGISTER_GLOBAL("runtime.profiling.PerfEventCollector")
+    .set_body_typed([](Array<String> event_names) {
+      std::vector<const PerfEvent*> events;
+      for (const String& name : event_names) {
+        const PerfEvent* found = nullptr;
+        for (const PerfEvent& event : kPerfEvents) {
+          if (name == event.name) found = &event;
+        }
+        ICHECK(found != nullptr) << "PerfEventCollector: unknown event " << name;
+        events.push_back(found);
+      }
+      ICHECK(!events.empty()) << "PerfEventCollector: at least one event is required";
+      return MetricCollector(make_object<PerfEventCollectorNode>(events));
+    });
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
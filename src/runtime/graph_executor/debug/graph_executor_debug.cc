@@ -276,15 +276,20 @@ class GraphExecutorDebug : public GraphExecutor {
    * the module compared to GraphRuntimeDebug::RunIndividual as it runs the
    * entire graph in order.
    *
+   * \param collectors Optional user defined `MetricCollector`s to use with this profiling run.
+   * \param peak_gflops Peak compute throughput of the device in GFLOPS, 0 if unknown.
+   * \param peak_gbps Peak memory bandwidth of the device in GB/s, 0 if unknown.
+   *
    * \returns A table of per-op runtimes and total times.
    */
-  profiling::Report Profile() {
+  profiling::Report Profile(Array<profiling::MetricCollector> collectors, double peak_gflops,
+                            double peak_gbps) {
     // warm up. 1 iteration does not seem enough.
     for (int i = 0; i < 3; i++) {
       GraphExecutor::Run();
     }
 
-    profiling::Profiler prof;
+    profiling::Profiler prof(collectors, peak_gflops, peak_gbps);
     prof.Start(devices_);
     for (size_t i = 0; i < op_execs_.size(); ++i) {
       if (op_execs_[i]) {
@@ -311,6 +316,13 @@ class GraphExecutorDebug : public GraphExecutor {
         if (nodes_[i].param.attrs.find("hash") != nodes_[i].param.attrs.end()) {
           metrics["Hash"] = Downcast<String>(nodes_[i].param.attrs.at("hash"));
         }
+        // work estimates attached by the compiler, used for the roofline metrics
+        if (nodes_[i].param.attrs.count("flops") && nodes_[i].param.attrs.count("bytes")) {
+          std::string flops = Downcast<String>(nodes_[i].param.attrs.at("flops"));
+          std::string bytes = Downcast<String>(nodes_[i].param.attrs.at("bytes"));
+          metrics["FLOPs"] = ObjectRef(make_object<profiling::CountNode>(std::stoll(flops)));
+          metrics["Bytes"] = ObjectRef(make_object<profiling::CountNode>(std::stoll(bytes)));
+        }
         metrics["Argument Shapes"] = profiling::ShapeString(shapes);
         prof.StartCall(nodes_[i].param.func_name, dev, metrics);
         op_execs_[i]();
@@ -359,7 +371,11 @@ PackedFunc GraphExecutorDebug::GetFunction(const std::string& name,
       *rv = this->RunIndividual(number, repeat, min_repeat_ms);
     });
   } else if (name == "profile") {
-    return TypedPackedFunc<profiling::Report()>([sptr_to_self, this]() { return this->Profile(); });
+    return TypedPackedFunc<profiling::Report(Array<profiling::MetricCollector>, double, double)>(
+        [sptr_to_self, this](Array<profiling::MetricCollector> collectors, double peak_gflops,
+                             double peak_gbps) {
+          return this->Profile(collectors, peak_gflops, peak_gbps);
+        });
   } else {
     return GraphExecutor::GetFunction(name, sptr_to_self);
   }
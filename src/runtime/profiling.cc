@@ -102,6 +102,9 @@ namespace profiling {
 
 void Profiler::Start(const std::vector<Device>& devs) {
   CHECK(global_timers_.empty()) << "You can only call Start once per Profiler.";
+  for (auto& collector : collectors_) {
+    collector->Init(devs);
+  }
   for (auto dev : devs) {
     global_timers_.emplace_back(dev, Timer::Start(dev));
   }
@@ -109,7 +112,14 @@ void Profiler::Start(const std::vector<Device>& devs) {
 
 void Profiler::StartCall(String name, Device dev,
                          std::unordered_map<std::string, ObjectRef> extra_metrics) {
-  in_flight_.push(CallFrame{dev, name, Timer::Start(dev), extra_metrics});
+  std::vector<std::pair<MetricCollector, ObjectRef>> objs;
+  for (auto& collector : collectors_) {
+    ObjectRef obj = collector->Start(dev);
+    if (obj.defined()) {
+      objs.emplace_back(collector, obj);
+    }
+  }
+  in_flight_.push(CallFrame{dev, name, Timer::Start(dev), extra_metrics, objs});
 }
 
 void Profiler::StopCall(std::unordered_map<std::string, ObjectRef> extra_metrics) {
@@ -118,6 +128,12 @@ void Profiler::StopCall(std::unordered_map<std::string, ObjectRef> extra_metrics
   for (auto& p : extra_metrics) {
     cf.extra_metrics[p.first] = p.second;
   }
+  // collectors are stopped after the timer so they do not add to the duration
+  for (auto& p : cf.extra_collectors) {
+    for (auto& kv : p.first->Stop(p.second)) {
+      cf.extra_metrics[kv.first] = kv.second;
+    }
+  }
   in_flight_.pop();
   calls_.push_back(cf);
 }
@@ -185,6 +201,8 @@ String ReportNode::AsCSV() const {
           s << (*it).second.as<DurationNode>()->microseconds;
         } else if ((*it).second.as<PercentNode>()) {
           s << (*it).second.as<PercentNode>()->percent;
+        } else if ((*it).second.as<RatioNode>()) {
+          s << (*it).second.as<RatioNode>()->ratio;
         } else if ((*it).second.as<StringObj>()) {
           s << "\"" << Downcast<String>((*it).second) << "\"";
         }
@@ -198,6 +216,76 @@ String ReportNode::AsCSV() const {
   return s.str();
 }
 
+namespace {
+void PrintMetricAsJSON(std::ostream& os, const ObjectRef& obj) {
+  if (obj.as<CountNode>()) {
+    os << "{\"count\": " << obj.as<CountNode>()->value << "}";
+  } else if (obj.as<DurationNode>()) {
+    os << "{\"microseconds\": " << std::setprecision(17)
+       << obj.as<DurationNode>()->microseconds << "}";
+  } else if (obj.as<PercentNode>()) {
+    os << "{\"percent\": " << std::setprecision(17)
+       << obj.as<PercentNode>()->percent << "}";
+  } else if (obj.as<RatioNode>()) {
+    os << "{\"ratio\": " << std::setprecision(17) << obj.as<RatioNode>()->ratio << "}";
+  } else if (obj.as<StringObj>()) {
+    // escape the characters JSON does not allow in a string literal
+    os << "\"";
+    for (char c : std::string(Downcast<String>(obj))) {
+      if (c == '"' || c == '\\') {
+        os << '\\' << c;
+      } else if (c == '\n') {
+        os << "\\n";
+      } else {
+        os << c;
+      }
+    }
+    os << "\"";
+  } else {
+    LOG(FATAL) << "Unprintable type " << obj->GetTypeKey();
+  }
+}
+
+void PrintMetricsAsJSON(std::ostream& os, const Map<String, ObjectRef>& metrics) {
+  os << "{";
+  bool first = true;
+  for (const auto& p : metrics) {
+    if (!first) {
+      os << ", ";
+    }
+    first = false;
+    PrintMetricAsJSON(os, p.first);
+    os << ": ";
+    PrintMetricAsJSON(os, p.second);
+  }
+  os << "}";
+}
+}  // namespace
+
+String ReportNode::AsJSON() const {
+  std::stringstream s;
+  s << "{\"calls\": [";
+  for (size_t i = 0; i < calls.size(); i++) {
+    if (i > 0) {
+      s << ", ";
+    }
+    PrintMetricsAsJSON(s, calls[i]);
+  }
+  s << "], \"device_metrics\": {";
+  bool first = true;
+  for (const auto& p : device_metrics) {
+    if (!first) {
+      s << ", ";
+    }
+    first = false;
+    PrintMetricAsJSON(s, p.first);
+    s << ": ";
+    PrintMetricsAsJSON(s, p.second);
+  }
+  s << "}}";
+  return s.str();
+}
+
 String ReportNode::AsTable(bool sort, bool aggregate) const {
   // aggregate calls by op hash (or op name if hash is not set) + argument shapes
   std::vector<Map<String, ObjectRef>> aggregated_calls;
@@ -239,16 +327,34 @@ String ReportNode::AsTable(bool sort, bool aggregate) const {
               aggregated[metric.first] =
                   ObjectRef(make_object<PercentNode>(it->second.as<PercentNode>()->percent +
                                                      metric.second.as<PercentNode>()->percent));
-            } else if (metric.second.as<StringObj>()) {
-              // Don't do anything. Assume the two strings are the same.
+            } else if (metric.second.as<StringObj>() || metric.second.as<RatioNode>()) {
+              // Don't do anything. Assume the two strings are the same. Ratios are averaged below.
             } else {
               LOG(FATAL) << "Can only aggregate metrics with types DurationNode, CountNode, "
-                            "PercentNode, and StringObj, but got "
+                            "PercentNode, RatioNode, and StringObj, but got "
                          << metric.second->GetTypeKey();
             }
           }
         }
       }
+      // average ratios weighted by duration, i.e. sum(work) / sum(time) for throughputs
+      for (auto& metric : aggregated) {
+        if (metric.second.as<RatioNode>()) {
+          double weighted = 0, total = 0;
+          for (auto i : p.second) {
+            auto it = calls[i].find(metric.first);
+            auto dur = calls[i].find("Duration (us)");
+            if (it != calls[i].end() && dur != calls[i].end()) {
+              double us = (*dur).second.as<DurationNode>()->microseconds;
+              weighted += (*it).second.as<RatioNode>()->ratio * us;
+              total += us;
+            }
+          }
+          if (total > 0) {
+            metric.second = ObjectRef(make_object<RatioNode>(weighted / total));
+          }
+        }
+      }
       aggregated_calls.push_back(aggregated);
     }
   } else {
@@ -349,6 +455,10 @@ String ReportNode::AsTable(bool sort, bool aggregate) const {
           std::stringstream s;
           s << std::fixed << std::setprecision(2) << (*it).second.as<PercentNode>()->percent;
           val = s.str();
+        } else if ((*it).second.as<RatioNode>()) {
+          std::stringstream s;
+          s << std::fixed << std::setprecision(2) << (*it).second.as<RatioNode>()->ratio;
+          val = s.str();
         } else if ((*it).second.as<StringObj>()) {
           val = Downcast<String>((*it).second);
         }
@@ -395,6 +505,37 @@ std::string DeviceString(Device dev) {
   return DeviceName(dev.device_type) + std::to_string(dev.device_id);
 }
 
+void Profiler::AddRooflineMetrics(double us, std::unordered_map<String, ObjectRef>* row) const {
+  auto flops_it = row->find("FLOPs");
+  auto bytes_it = row->find("Bytes");
+  if (flops_it == row->end() || bytes_it == row->end() || us <= 0) {
+    return;
+  }
+  double flops = static_cast<double>(flops_it->second.as<CountNode>()->value);
+  double bytes = static_cast<double>(bytes_it->second.as<CountNode>()->value);
+  // work per nanosecond is work per second in units of 10^9
+  double gflops = flops / (us * 1e3);
+  double gbps = bytes / (us * 1e3);
+  (*row)["GFLOPS"] = ObjectRef(make_object<RatioNode>(gflops));
+  (*row)["GB/s"] = ObjectRef(make_object<RatioNode>(gbps));
+
+  // The attainable throughput is bounded by either compute or memory bandwidth times the
+  // arithmetic intensity. Ops without FLOPs are measured against the bandwidth alone.
+  double percent = -1;
+  if (flops > 0 && peak_gflops_ > 0) {
+    double attainable = peak_gflops_;
+    if (peak_gbps_ > 0 && bytes > 0) {
+      attainable = std::min(attainable, flops / bytes * peak_gbps_);
+    }
+    percent = gflops / attainable * 100;
+  } else if (flops == 0 && peak_gbps_ > 0) {
+    percent = gbps / peak_gbps_ * 100;
+  }
+  if (percent >= 0) {
+    (*row)["Roofline (%)"] = ObjectRef(make_object<RatioNode>(percent));
+  }
+}
+
 Report Profiler::Report(bool aggregate, bool sort) {
   std::vector<std::pair<Device, double>> global_times;
   for (auto p : global_timers_) {
@@ -428,6 +569,7 @@ Report Profiler::Report(bool aggregate, bool sort) {
     for (auto p : cf.extra_metrics) {
       row[p.first] = p.second;
     }
+    AddRooflineMetrics(us, &row);
     rows.push_back(row);
   }
 
@@ -445,9 +587,14 @@ Report::Report(Array<Map<String, ObjectRef>> calls,
 TVM_REGISTER_OBJECT_TYPE(DurationNode);
 TVM_REGISTER_OBJECT_TYPE(PercentNode);
 TVM_REGISTER_OBJECT_TYPE(CountNode);
+TVM_REGISTER_OBJECT_TYPE(RatioNode);
 TVM_REGISTER_OBJECT_TYPE(ReportNode);
+TVM_REGISTER_OBJECT_TYPE(MetricCollectorNode);
 
 TVM_REGISTER_GLOBAL("runtime.profiling.AsCSV").set_body_typed([](Report n) { return n->AsCSV(); });
+TVM_REGISTER_GLOBAL("runtime.profiling.AsJSON").set_body_typed([](Report n) {
+  return n->AsJSON();
+});
 }  // namespace profiling
 }  // namespace runtime
 }  // namespace tvm
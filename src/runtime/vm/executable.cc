@@ -224,6 +224,9 @@ TVMByteArray Executable::Save() {
   // Primitive names.
   SavePrimitiveOpNames(&strm);
 
+  // Shape bucket section.
+  SaveShapeBucketSection(&strm);
+
   // Code section.
   SaveCodeSection(&strm);
 
@@ -275,6 +278,27 @@ void Executable::SavePrimitiveOpNames(dmlc::Stream* strm) {
   strm->Write(primitive_names);
 }
 
+// The dispatch tables are flattened into one list of the form
+//   `packed_index ndims (arg axis)*ndims nvariants (extent variant_index)*nvariants`
+// for each generic kernel.
+void Executable::SaveShapeBucketSection(dmlc::Stream* strm) {
+  std::vector<Index> fields;
+  for (const auto& it : this->shape_buckets) {
+    fields.push_back(it.first);
+    fields.push_back(static_cast<Index>(it.second.dynamic_dims.size()));
+    for (const auto& dim : it.second.dynamic_dims) {
+      fields.push_back(dim.first);
+      fields.push_back(dim.second);
+    }
+    fields.push_back(static_cast<Index>(it.second.variants.size()));
+    for (const auto& variant : it.second.variants) {
+      fields.push_back(variant.first);
+      fields.push_back(variant.second);
+    }
+  }
+  strm->Write(fields);
+}
+
 // Serialize a virtual machine instruction. It creates a list that contains the
 // hash, opcode, and all fields of an instruction.
 //
@@ -529,6 +553,9 @@ runtime::Module Executable::Load(const std::string& code, const runtime::Module
   // Primitive names that will be invoked by `InvokePacked` instructions.
   exec->LoadPrimitiveOpNames(&strm);
 
+  // Specialized variants of the primitive ops.
+  exec->LoadShapeBucketSection(&strm);
+
   // Code section.
   exec->LoadCodeSection(&strm);
 
@@ -571,6 +598,28 @@ void Executable::LoadPrimitiveOpNames(dmlc::Stream* strm) {
   }
 }
 
+void Executable::LoadShapeBucketSection(dmlc::Stream* strm) {
+  std::vector<Index> fields;
+  STREAM_CHECK(strm->Read(&fields), "shape bucket");
+  size_t pos = 0;
+  auto next = [&]() {
+    STREAM_CHECK(pos < fields.size(), "shape bucket");
+    return fields[pos++];
+  };
+  while (pos < fields.size()) {
+    Index packed_index = next();
+    ShapeBucketDispatch& dispatch = this->shape_buckets[packed_index];
+    for (Index i = next(); i > 0; --i) {
+      Index arg = next();
+      dispatch.dynamic_dims.emplace_back(arg, next());
+    }
+    for (Index i = next(); i > 0; --i) {
+      Index extent = next();
+      dispatch.variants.emplace_back(extent, next());
+    }
+  }
+}
+
 // Extract the `cnt` number of fields started at `start` from the list
 // `instr_fields`.
 inline std::vector<Index> ExtractFields(const std::vector<Index>& instr_fields, Index start,
@@ -43,26 +43,29 @@ namespace vm {
 PackedFunc VirtualMachineDebug::GetFunction(const std::string& name,
                                             const ObjectPtr<Object>& sptr_to_self) {
   if (name == "profile") {
-    return TypedPackedFunc<profiling::Report(String)>([sptr_to_self, this](String arg_name) {
-      std::vector<Device> devices;
-      for (auto dev : devices_) {
-        if (dev.device_type > 0) {
-          devices.push_back(dev);
-        }
-      }
-
-      auto invoke = VirtualMachine::GetFunction("invoke", sptr_to_self);
-      // warmup
-      for (int i = 0; i < 3; i++) {
-        invoke(arg_name);
-      }
-
-      prof_ = profiling::Profiler();  // reset profiler
-      prof_.Start(devices);
-      invoke(arg_name);
-      prof_.Stop();
-      return prof_.Report();
-    });
+    return TypedPackedFunc<profiling::Report(String, Array<profiling::MetricCollector>, double,
+                                             double)>(
+        [sptr_to_self, this](String arg_name, Array<profiling::MetricCollector> collectors,
+                             double peak_gflops, double peak_gbps) {
+          std::vector<Device> devices;
+          for (auto dev : devices_) {
+            if (dev.device_type > 0) {
+              devices.push_back(dev);
+            }
+          }
+
+          auto invoke = VirtualMachine::GetFunction("invoke", sptr_to_self);
+          // warmup
+          for (int i = 0; i < 3; i++) {
+            invoke(arg_name);
+          }
+
+          prof_ = profiling::Profiler(collectors, peak_gflops, peak_gbps);  // reset profiler
+          prof_.Start(devices);
+          invoke(arg_name);
+          prof_.Stop();
+          return prof_.Report();
+        });
   } else {
     return VirtualMachine::GetFunction(name, sptr_to_self);
   }
@@ -120,6 +123,13 @@ void VirtualMachineDebug::InvokePacked(Index packed_index, const PackedFunc& fun
     if (it != op_attrs.end()) {
       metrics["Hash"] = Downcast<String>((*it).second);
     }
+    // work estimates attached by the compiler, used for the roofline metrics
+    if (op_attrs.count("flops") && op_attrs.count("bytes")) {
+      std::string flops = Downcast<String>(op_attrs.at("flops"));
+      std::string bytes = Downcast<String>(op_attrs.at("bytes"));
+      metrics["FLOPs"] = ObjectRef(make_object<profiling::CountNode>(std::stoll(flops)));
+      metrics["Bytes"] = ObjectRef(make_object<profiling::CountNode>(std::stoll(bytes)));
+    }
     metrics["Argument Shapes"] = profiling::ShapeString(shapes);
 
     prof_.StartCall(packed_index_map_[packed_index], dev, metrics);
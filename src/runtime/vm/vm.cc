@@ -272,6 +272,41 @@ ObjectRef VirtualMachine::Invoke(const std::string& name, const std::vector<Obje
   return Invoke(exec_->functions[func_index_], args);
 }
 
+Index VirtualMachine::SelectShapeBucket(Index packed_index,
+                                        const std::vector<ObjectRef>& args) const {
+  auto it = exec_->shape_buckets.find(packed_index);
+  if (it == exec_->shape_buckets.end()) {
+    return packed_index;
+  }
+  // The dynamic dims are indexed by the flattened arguments.
+  std::vector<NDArray> arrays;
+  for (const auto& arg : args) {
+    if (const auto* obj = arg.as<ADTObj>()) {
+      for (size_t fi = 0; fi < obj->size; ++fi) {
+        arrays.push_back(Downcast<NDArray>((*obj)[fi]));
+      }
+    } else {
+      arrays.push_back(Downcast<NDArray>(arg));
+    }
+  }
+  const ShapeBucketDispatch& dispatch = it->second;
+  int64_t extent = -1;
+  for (const auto& dim : dispatch.dynamic_dims) {
+    ICHECK_LT(static_cast<size_t>(dim.first), arrays.size());
+    int64_t value = arrays[dim.first].Shape()[dim.second];
+    if (extent != -1 && value != extent) {
+      return packed_index;
+    }
+    extent = value;
+  }
+  for (const auto& variant : dispatch.variants) {
+    if (variant.first == extent) {
+      return variant.second;
+    }
+  }
+  return packed_index;
+}
+
 void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, Index arg_count,
                                   Index output_size, const std::vector<ObjectRef>& args) {
   size_t arity = 0;
@@ -455,7 +490,6 @@ void VirtualMachine::RunLoop() {
       case Opcode::InvokePacked: {
         DLOG(INFO) << "InvokedPacked " << instr.packed_index << " arity=" << instr.arity;
         ICHECK_LE(instr.packed_index, packed_funcs_.size());
-        const auto& func = packed_funcs_[instr.packed_index];
         const auto& arity = instr.arity;
         std::vector<ObjectRef> args;
         for (Index i = 0; i < arity; ++i) {
@@ -463,10 +497,12 @@ void VirtualMachine::RunLoop() {
           auto arg = ReadRegister(instr.packed_args[i]);
           args.push_back(arg);
         }
+        Index packed_index = SelectShapeBucket(instr.packed_index, args);
+        const auto& func = packed_funcs_[packed_index];
 
         // We no longer need to write the registers back, we write directly
         // through the registers mutably.
-        InvokePacked(instr.packed_index, func, arity, instr.output_size, args);
+        InvokePacked(packed_index, func, arity, instr.output_size, args);
         pc_++;
         goto main_loop;
       }
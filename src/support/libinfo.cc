@@ -179,6 +179,10 @@
 #define TVM_INFO_USE_RANDOM "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_PERF_EVENT
+#define TVM_INFO_USE_PERF_EVENT "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_MICRO_STANDALONE_RUNTIME
 #define TVM_INFO_USE_MICRO_STANDALONE_RUNTIME "NOT-FOUND"
 #endif
@@ -267,6 +271,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_SORT", TVM_INFO_USE_SORT},
       {"USE_NNPACK", TVM_INFO_USE_NNPACK},
       {"USE_RANDOM", TVM_INFO_USE_RANDOM},
+      {"USE_PERF_EVENT", TVM_INFO_USE_PERF_EVENT},
       {"USE_MICRO_STANDALONE_RUNTIME", TVM_INFO_USE_MICRO_STANDALONE_RUNTIME},
       {"USE_CPP_RPC", TVM_INFO_USE_CPP_RPC},
       {"USE_TFLITE", TVM_INFO_USE_TFLITE},
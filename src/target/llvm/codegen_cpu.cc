@@ -26,10 +26,12 @@
 
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/tir/analysis.h>
+#include <tvm/tir/stmt_functor.h>
 
 #include <algorithm>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "../func_registry_generator.h"
 
@@ -524,8 +526,30 @@ void CodeGenCPU::CreateParallelLaunch(const Stmt& body, int num_task) {
                              "__tvm_parallel_lambda", module_.get());
   // allocate and setup the closure, call the closure.
   Array<Var> vfields = tir::UndefinedVars(body, {});
+  // Every dynamically scheduled loop in the launch gets its own iteration counter,
+  // shared by all tasks through the closure and reset before every launch.
+  int num_dynamic_loops = 0;
+  tir::PostOrderVisit(body, [&num_dynamic_loops](const ObjectRef& n) {
+    const auto* attr = n.as<AttrStmtNode>();
+    if (attr != nullptr && attr->attr_key == "pragma_parallel_schedule" &&
+        ParseParallelSchedule(attr->value).kind != ParallelSchedule::kStatic) {
+      ++num_dynamic_loops;
+    }
+  });
+  Var counters("parallel_counters", DataType::Handle());
+  if (num_dynamic_loops != 0) {
+    llvm::Value* counter_array = WithFunctionEntry(
+        [&]() { return builder_->CreateAlloca(t_int64_, ConstInt32(num_dynamic_loops)); });
+    for (int i = 0; i < num_dynamic_loops; ++i) {
+      builder_->CreateStore(llvm::ConstantInt::get(t_int64_, 0),
+                            builder_->CreateInBoundsGEP(counter_array, ConstInt32(i)));
+    }
+    var_map_[counters.get()] = builder_->CreatePointerCast(counter_array, t_void_p_);
+    vfields.push_back(counters);
+  }
   uint64_t nbytes;
   llvm::Value* cdata = PackClosureData(vfields, &nbytes);
+  var_map_.erase(counters.get());
 #if TVM_LLVM_VERSION >= 90
   auto launch_callee = llvm::FunctionCallee(ftype_tvm_parallel_launch_, RuntimeTVMParallelLaunch());
 #else
@@ -551,10 +575,26 @@ void CodeGenCPU::CreateParallelLaunch(const Stmt& body, int num_task) {
   new_vmap[par_env.num_task.get()] =
       builder_->CreateLoad(builder_->CreateInBoundsGEP(penv, {ConstInt32(0), ConstInt32(1)}));
   par_env.penv = penv;
+  if (num_dynamic_loops != 0) {
+    par_env.counters = counters;
+    // Unless the launch is the scheduled loop itself, a launch point may enter it again,
+    // e.g. in a serial loop, and its counter is reset after each entry.
+    const auto* loop = body.as<ForNode>();
+    const auto* attr = body.as<AttrStmtNode>();
+    par_env.reset_counters = !(loop != nullptr && loop->kind == ForKind::kParallel) &&
+                             !(attr != nullptr && attr->attr_key == "pragma_parallel_schedule");
+  }
   std::swap(function_, f);
   std::swap(parallel_env_, par_env);
   std::swap(var_map_, new_vmap);
+  bool nontemporal_store_emitted = nontemporal_store_emitted_;
+  nontemporal_store_emitted_ = false;
   this->VisitStmt(body);
+  // make the non-temporal stores of the task visible before it reports completion.
+  if (nontemporal_store_emitted_) {
+    CreateStoreFence();
+  }
+  nontemporal_store_emitted_ = nontemporal_store_emitted;
   builder_->CreateRet(ConstInt32(0));
   // swap the var map back, now we are back on track.
   std::swap(var_map_, new_vmap);
@@ -564,6 +604,148 @@ void CodeGenCPU::CreateParallelLaunch(const Stmt& body, int num_task) {
   builder_->SetInsertPoint(par_launch_end);
 }
 
+Stmt CodeGenCPU::CollapseParallelLoops(const ForNode* op) {
+  // Collect the perfectly nested parallel loops with rectangular iteration spaces.
+  std::vector<const ForNode*> loops = {op};
+  std::unordered_set<const VarNode*> loop_vars = {op->loop_var.get()};
+  while (const auto* inner = loops.back()->body.as<ForNode>()) {
+    if (inner->kind != ForKind::kParallel || !is_zero(inner->min) ||
+        tir::ExprUseVar(inner->extent, [&loop_vars](const VarNode* v) {
+          return loop_vars.count(v) != 0;
+        })) {
+      break;
+    }
+    loops.push_back(inner);
+    loop_vars.insert(inner->loop_var.get());
+  }
+  if (loops.size() == 1) {
+    return Stmt();
+  }
+  DataType t = op->extent.dtype();
+  for (const ForNode* loop : loops) {
+    if (loop->extent.dtype().bits() > t.bits()) t = loop->extent.dtype();
+  }
+  PrimExpr extent = make_const(t, 1);
+  for (const ForNode* loop : loops) {
+    extent = extent * cast(t, loop->extent);
+  }
+  // Recover the original loop variables from the collapsed one, innermost first. Only the
+  // outermost loop may start at a non-zero min, which offsets its variable.
+  Var fused(op->loop_var->name_hint + ".fused", t);
+  Stmt body = loops.back()->body;
+  PrimExpr rest = fused;
+  for (size_t i = loops.size(); i != 0; --i) {
+    const ForNode* loop = loops[i - 1];
+    PrimExpr value = i != 1 ? indexmod(rest, cast(t, loop->extent))
+                            : is_zero(op->min) ? rest : cast(t, op->min) + rest;
+    body = LetStmt(loop->loop_var, cast(loop->loop_var.dtype(), value), body);
+    rest = indexdiv(rest, cast(t, loop->extent));
+  }
+  return For(fused, make_const(t, 0), extent, ForKind::kParallel, body);
+}
+
+CodeGenCPU::ParallelSchedule CodeGenCPU::ParseParallelSchedule(const PrimExpr& value) {
+  // The value is "static", "dynamic" or "guided", optionally followed by ",<chunk>".
+  const auto* str = value.as<StringImmNode>();
+  ICHECK(str != nullptr) << "pragma_parallel_schedule expects a string value";
+  std::string kind = str->value;
+  ParallelSchedule schedule;
+  size_t pos = kind.find(',');
+  if (pos != std::string::npos) {
+    schedule.chunk = std::stoll(kind.substr(pos + 1));
+    ICHECK_GT(schedule.chunk, 0) << "The chunk size of a parallel schedule must be positive";
+    kind = kind.substr(0, pos);
+  }
+  if (kind == "static") {
+    schedule.kind = ParallelSchedule::kStatic;
+  } else if (kind == "dynamic") {
+    schedule.kind = ParallelSchedule::kDynamic;
+  } else if (kind == "guided") {
+    schedule.kind = ParallelSchedule::kGuided;
+  } else {
+    LOG(FATAL) << "Unknown parallel schedule " << str->value
+               << ", expected one of static, dynamic or guided";
+  }
+  return schedule;
+}
+
+void CodeGenCPU::CreateDynamicParallelFor(const ForNode* op, const ParallelSchedule& schedule) {
+  using llvm::BasicBlock;
+  ICHECK(parallel_env_.counters.defined());
+  llvm::Value* counters =
+      builder_->CreatePointerCast(MakeValue(parallel_env_.counters), t_int64_->getPointerTo());
+  llvm::Value* counter =
+      builder_->CreateInBoundsGEP(counters, ConstInt32(parallel_env_.dynamic_loop_count++));
+  llvm::Value* extent = builder_->CreateIntCast(MakeValue(op->extent), t_int64_, true);
+  llvm::Value* num_task =
+      builder_->CreateIntCast(MakeValue(parallel_env_.num_task), t_int64_, true);
+  llvm::Value* min_chunk = llvm::ConstantInt::get(t_int64_, schedule.chunk);
+
+  BasicBlock* chunk_begin = BasicBlock::Create(*ctx_, "parallel_chunk_begin", function_);
+  BasicBlock* chunk_body = BasicBlock::Create(*ctx_, "parallel_chunk_body", function_);
+  BasicBlock* chunk_end = BasicBlock::Create(*ctx_, "parallel_chunk_end", function_);
+  builder_->CreateBr(chunk_begin);
+  builder_->SetInsertPoint(chunk_begin);
+  llvm::Value* chunk = min_chunk;
+  if (schedule.kind == ParallelSchedule::kGuided) {
+    // Like OpenMP guided scheduling, grab the remaining iterations divided by the number of
+    // tasks. The counter is only read to size the chunk, the fetch-add below still hands out
+    // disjoint ranges if another task moves the counter in between.
+    llvm::LoadInst* current = builder_->CreateLoad(counter);
+    current->setAtomic(llvm::AtomicOrdering::Monotonic);
+#if TVM_LLVM_VERSION >= 100
+    current->setAlignment(llvm::Align(8));
+#else
+    current->setAlignment(8);
+#endif
+    llvm::Value* guided = builder_->CreateSDiv(builder_->CreateSub(extent, current), num_task);
+    chunk = builder_->CreateSelect(builder_->CreateICmpSGT(guided, min_chunk), guided, min_chunk);
+  }
+#if TVM_LLVM_VERSION >= 130
+  llvm::Value* begin =
+      builder_->CreateAtomicRMW(llvm::AtomicRMWInst::Add, counter, chunk, llvm::MaybeAlign(),
+                                llvm::AtomicOrdering::Monotonic);
+#else
+  llvm::Value* begin = builder_->CreateAtomicRMW(llvm::AtomicRMWInst::Add, counter, chunk,
+                                                 llvm::AtomicOrdering::Monotonic);
+#endif
+  builder_->CreateCondBr(builder_->CreateICmpSLT(begin, extent), chunk_body, chunk_end,
+                         md_very_likely_branch_);
+  builder_->SetInsertPoint(chunk_body);
+  llvm::Value* next = builder_->CreateAdd(begin, chunk);
+  llvm::Value* end = builder_->CreateSelect(builder_->CreateICmpSLT(next, extent), next, extent);
+  llvm::Type* loop_type = DTypeToLLVMType(op->extent.dtype());
+  CreateSerialFor(builder_->CreateIntCast(begin, loop_type, true),
+                  builder_->CreateIntCast(end, loop_type, true),
+                  llvm::ConstantInt::getSigned(loop_type, 1), op->loop_var, op->body);
+  builder_->CreateBr(chunk_begin);
+  builder_->SetInsertPoint(chunk_end);
+  if (parallel_env_.reset_counters) {
+    // All tasks are past the loop after the first barrier, so the first task can reset the
+    // counter, and the second barrier keeps the others from entering the loop again before.
+    CreateParallelBarrier();
+    BasicBlock* reset_body = BasicBlock::Create(*ctx_, "parallel_counter_reset", function_);
+    BasicBlock* reset_end = BasicBlock::Create(*ctx_, "parallel_counter_reset_end", function_);
+    builder_->CreateCondBr(
+        builder_->CreateICmpEQ(MakeValue(parallel_env_.task_id), ConstInt32(0)), reset_body,
+        reset_end);
+    builder_->SetInsertPoint(reset_body);
+    builder_->CreateStore(llvm::ConstantInt::get(t_int64_, 0), counter);
+    builder_->CreateBr(reset_end);
+    builder_->SetInsertPoint(reset_end);
+    CreateParallelBarrier();
+  }
+}
+
+void CodeGenCPU::CreateParallelBarrier() {
+#if TVM_LLVM_VERSION >= 90
+  auto bar_callee = llvm::FunctionCallee(ftype_tvm_parallel_barrier_, RuntimeTVMParallelBarrier());
+#else
+  auto bar_callee = RuntimeTVMParallelBarrier();
+#endif
+  builder_->CreateCall(bar_callee, {MakeValue(parallel_env_.task_id), parallel_env_.penv});
+}
+
 llvm::Value* CodeGenCPU::CreateStaticHandle() {
   llvm::GlobalVariable* gv =
       new llvm::GlobalVariable(*module_, t_void_p_, false, llvm::GlobalValue::PrivateLinkage,
@@ -950,6 +1132,18 @@ void CodeGenCPU::VisitStmt_(const AttrStmtNode* op) {
           << "Pragma parallel_stride_pattern only valid in parallel launch";
       parallel_env_.stride_pattern = true;
       this->VisitStmt(op->body);
+    } else if (op->attr_key == "pragma_parallel_schedule") {
+      const auto* loop = op->body.as<ForNode>();
+      if (loop == nullptr || loop->kind != ForKind::kParallel) {
+        LOG(WARNING) << "Pragma parallel_schedule is only valid on a parallel loop, ignored";
+        this->VisitStmt(op->body);
+      } else if (parallel_env_.penv == nullptr) {
+        // launch around the pragma so that the loop inside the launch sees the schedule
+        CreateParallelLaunch(GetRef<Stmt>(op), 0);
+      } else {
+        parallel_env_.schedule = ParseParallelSchedule(op->value);
+        this->VisitStmt(op->body);
+      }
     } else if (op->attr_key == "pragma_parallel_launch_point") {
       CreateParallelLaunch(op->body, 0);
     } else if (op->attr_key == "pragma_parallel_barrier_when_finish") {
@@ -958,13 +1152,7 @@ void CodeGenCPU::VisitStmt_(const AttrStmtNode* op) {
           << "Cannot not place within parallel loop as the workload may differ, "
           << " place it between parallel and parallel_launch_point";
       this->VisitStmt(op->body);
-#if TVM_LLVM_VERSION >= 90
-      auto bar_callee =
-          llvm::FunctionCallee(ftype_tvm_parallel_barrier_, RuntimeTVMParallelBarrier());
-#else
-      auto bar_callee = RuntimeTVMParallelBarrier();
-#endif
-      builder_->CreateCall(bar_callee, {MakeValue(parallel_env_.task_id), parallel_env_.penv});
+      CreateParallelBarrier();
     } else if (op->attr_key == tir::attr::pragma_import_llvm) {
       const StringImmNode* value = op->value.as<StringImmNode>();
       ICHECK(value != nullptr);
@@ -980,6 +1168,14 @@ void CodeGenCPU::VisitStmt_(const AttrStmtNode* op) {
 }
 
 void CodeGenCPU::VisitStmt_(const ForNode* op) {
+  if (op->kind == ForKind::kParallel) {
+    // the collapsed loop starts at zero, the min of the outer loop is folded into its index.
+    Stmt collapsed = CollapseParallelLoops(op);
+    if (collapsed.defined()) {
+      this->VisitStmt(collapsed);
+      return;
+    }
+  }
   ICHECK(is_zero(op->min));
   if (op->kind == ForKind::kSerial || op->kind == ForKind::kUnrolled) {
     CodeGenLLVM::VisitStmt_(op);
@@ -988,6 +1184,15 @@ void CodeGenCPU::VisitStmt_(const ForNode* op) {
       CreateParallelLaunch(For(op->loop_var, op->min, op->extent, op->kind, op->body,
                                op->thread_binding, op->annotations),
                            0);
+    } else if (parallel_env_.in_parallel_loop) {
+      // The enclosing parallel loop already distributes its iterations over the parallel
+      // group and the thread pool does not support nested launches, so the iterations of
+      // this loop run serially within each task. A schedule pragma on it is dropped, it must
+      // not apply to a later parallel loop.
+      parallel_env_.schedule = ParallelSchedule();
+      CreateSerialFor(MakeValue(op->min), MakeValue(op->extent),
+                      llvm::ConstantInt::getSigned(GetLLVMType(op->extent), 1), op->loop_var,
+                      op->body);
     } else {
       // already in parallel env.
       ICHECK(parallel_env_.task_id.defined());
@@ -996,10 +1201,13 @@ void CodeGenCPU::VisitStmt_(const ForNode* op) {
       DataType t = op->extent.dtype();
       PrimExpr num_task = cast(t, parallel_env_.num_task);
       PrimExpr task_id = cast(t, parallel_env_.task_id);
-      ICHECK(!parallel_env_.in_parallel_loop)
-          << "Nested parallel loop is not supported by threadpool, try fuse them instead";
       parallel_env_.in_parallel_loop = true;
-      if (parallel_env_.stride_pattern) {
+      ParallelSchedule schedule = parallel_env_.schedule;
+      // the schedule only applies to the loop the pragma is attached to
+      parallel_env_.schedule = ParallelSchedule();
+      if (schedule.kind != ParallelSchedule::kStatic) {
+        CreateDynamicParallelFor(op, schedule);
+      } else if (parallel_env_.stride_pattern) {
         CreateSerialFor(MakeValue(task_id), MakeValue(op->extent), MakeValue(num_task),
                         op->loop_var, op->body);
       } else {
@@ -85,6 +85,13 @@ class CodeGenCPU : public CodeGenLLVM {
   llvm::FunctionType* ftype_tvm_static_init_{nullptr};
 
  private:
+  // the scheduling of the iterations of a parallel loop over the tasks
+  struct ParallelSchedule {
+    enum Kind { kStatic, kDynamic, kGuided };
+    Kind kind{kStatic};
+    // the (minimum) number of iterations grabbed at once by dynamic and guided schedules
+    int64_t chunk{1};
+  };
   // the parallel group information
   struct ParallelEnv {
     Var task_id;
@@ -93,6 +100,13 @@ class CodeGenCPU : public CodeGenLLVM {
     bool in_parallel_loop{false};
     int parallel_loop_count{0};
     llvm::Value* penv{nullptr};
+    // schedule of the next parallel loop, set by pragma_parallel_schedule
+    ParallelSchedule schedule;
+    // shared iteration counters of the dynamically scheduled loops in this launch
+    Var counters;
+    int dynamic_loop_count{0};
+    // whether the launch may enter a dynamically scheduled loop again, e.g. in a launch point
+    bool reset_counters{false};
   };
   // Get runtime functions
   void InitGlobalContext(bool dynamic_lookup);
@@ -121,6 +135,15 @@ class CodeGenCPU : public CodeGenLLVM {
   void CreateStaticInit(const std::string& init_fname, const Stmt& body);
   // Create parallel launch
   void CreateParallelLaunch(const Stmt& body, int num_task);
+  // Collapse perfectly nested parallel loops into a single parallel loop.
+  // Returns an undefined Stmt if the body of op is not a parallel loop.
+  Stmt CollapseParallelLoops(const ForNode* op);
+  // Parse the value of pragma_parallel_schedule
+  static ParallelSchedule ParseParallelSchedule(const PrimExpr& value);
+  // Create a parallel loop whose chunks are grabbed from a shared atomic counter
+  void CreateDynamicParallelFor(const ForNode* op, const ParallelSchedule& schedule);
+  // Create a barrier of the tasks of the current parallel launch
+  void CreateParallelBarrier();
   // Create a new compute scope.
   void CreateComputeScope(const AttrStmtNode* op);
   // Check if the call to packed function is successful
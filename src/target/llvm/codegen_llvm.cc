@@ -106,6 +106,8 @@ void CodeGenLLVM::InitFuncState() {
   alias_var_set_.clear();
   alloc_storage_info_.clear();
   volatile_buf_.clear();
+  nontemporal_buf_.clear();
+  nontemporal_store_emitted_ = false;
   analyzer_.reset(new arith::Analyzer());
 }
 
@@ -495,6 +497,25 @@ void CodeGenLLVM::AddAliasInfo(llvm::Instruction* inst, const VarNode* buffer, P
   inst->setMetadata("tbaa", md_builder_->createTBAAStructTagNode(meta, meta, 0));
 }
 
+void CodeGenLLVM::AddNontemporalInfo(llvm::StoreInst* store, const VarNode* buffer) {
+  if (!nontemporal_buf_.count(buffer) || volatile_buf_.count(buffer)) return;
+  llvm::MDNode* md = llvm::MDNode::get(*ctx_, {llvm::ConstantAsMetadata::get(ConstInt32(1))});
+  store->setMetadata(llvm::LLVMContext::MD_nontemporal, md);
+  nontemporal_store_emitted_ = true;
+}
+
+void CodeGenLLVM::CreateStoreFence() {
+  llvm::Triple::ArchType arch = target_machine_->getTargetTriple().getArch();
+  if (arch == llvm::Triple::x86_64 || arch == llvm::Triple::x86) {
+    // non-temporal stores are weakly ordered on x86 and are only ordered by sfence/mfence.
+    builder_->CreateCall(
+        llvm::Intrinsic::getDeclaration(module_.get(), llvm::Intrinsic::x86_sse_sfence));
+  } else {
+    builder_->CreateFence(llvm::AtomicOrdering::Release);
+  }
+  nontemporal_store_emitted_ = false;
+}
+
 void CodeGenLLVM::GetAlignment(DataType t, const VarNode* buf_var, const PrimExpr& index,
                                int* p_alignment, int* p_native_bits) {
   int max_align_bits = t.bits();
@@ -1128,6 +1149,9 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const LoadNode* op) {
   DataType t = op->dtype;
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
+  if (!is_one(op->predicate)) {
+    return CreatePredicatedLoad(op, buffer);
+  }
   llvm::Value* index = MakeValue(op->index);
 
   if (t.lanes() == 1) {
@@ -1240,12 +1264,15 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const BroadcastNode* op) {
 }
 
 void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
-  ICHECK(is_one(op->predicate)) << op->predicate;
   DataType t = op->value.dtype();
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
-  llvm::Value* index = MakeValue(op->index);
   llvm::Value* value = MakeValue(op->value);
+  if (!is_one(op->predicate)) {
+    CreatePredicatedStore(op, buffer, value);
+    return;
+  }
+  llvm::Value* index = MakeValue(op->index);
 
   if (t.lanes() == 1) {
     int alignment, native_bits;
@@ -1276,6 +1303,7 @@ void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
         llvm::StoreInst* store = builder_->CreateAlignedStore(value, ptr, alignment, is_volatile);
 #endif
         AddAliasInfo(store, op->buffer_var.get(), op->index);
+        AddNontemporalInfo(store, op->buffer_var.get());
         return;
       }
     }
@@ -1297,6 +1325,77 @@ void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
   this->Scalarize(op->index, f);
 }
 
+llvm::Value* CodeGenLLVM::CreatePredicatedLoad(const LoadNode* op, llvm::Value* buffer) {
+  DataType t = op->dtype;
+  ICHECK_GT(t.lanes(), 1) << "Predicated load requires a vector type, but get " << t;
+  ICHECK(!volatile_buf_.count(op->buffer_var.get())) << "Predicated load of a volatile buffer";
+  llvm::Type* vtype = DTypeToLLVMType(t);
+  llvm::Value* mask = MakeValue(op->predicate);
+  // Masked-off lanes read as zero.
+  llvm::Value* passthru = llvm::Constant::getNullValue(vtype);
+  llvm::CallInst* load;
+  const RampNode* ramp = op->index.as<RampNode>();
+  if (ramp && is_one(ramp->stride)) {
+    int alignment, native_bits;
+    GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+    unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(buffer->getType())->getAddressSpace();
+    llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(ramp->base));
+    ptr = builder_->CreatePointerCast(ptr, vtype->getPointerTo(addrspace));
+#if TVM_LLVM_VERSION >= 130
+    load = builder_->CreateMaskedLoad(vtype, ptr, llvm::Align(alignment), mask, passthru);
+#elif TVM_LLVM_VERSION >= 110
+    load = builder_->CreateMaskedLoad(ptr, llvm::Align(alignment), mask, passthru);
+#else
+    load = builder_->CreateMaskedLoad(ptr, alignment, mask, passthru);
+#endif
+    AddAliasInfo(load, op->buffer_var.get(), op->index);
+  } else {
+    int basic_align = t.bits() / 8;
+    llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, MakeValue(op->index));
+#if TVM_LLVM_VERSION >= 130
+    load = builder_->CreateMaskedGather(vtype, ptrs, llvm::Align(basic_align), mask, passthru);
+#elif TVM_LLVM_VERSION >= 110
+    load = builder_->CreateMaskedGather(ptrs, llvm::Align(basic_align), mask, passthru);
+#else
+    load = builder_->CreateMaskedGather(ptrs, basic_align, mask, passthru);
+#endif
+    AddAliasInfo(load, op->buffer_var.get(), PrimExpr());
+  }
+  return load;
+}
+
+void CodeGenLLVM::CreatePredicatedStore(const StoreNode* op, llvm::Value* buffer,
+                                        llvm::Value* value) {
+  DataType t = op->value.dtype();
+  ICHECK_GT(t.lanes(), 1) << "Predicated store requires a vector type, but get " << t;
+  ICHECK(!volatile_buf_.count(op->buffer_var.get())) << "Predicated store to a volatile buffer";
+  llvm::Value* mask = MakeValue(op->predicate);
+  llvm::CallInst* store;
+  const RampNode* ramp = op->index.as<RampNode>();
+  if (ramp && is_one(ramp->stride)) {
+    int alignment, native_bits;
+    GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+    unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(buffer->getType())->getAddressSpace();
+    llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(ramp->base));
+    ptr = builder_->CreatePointerCast(ptr, DTypeToLLVMType(t)->getPointerTo(addrspace));
+#if TVM_LLVM_VERSION >= 110
+    store = builder_->CreateMaskedStore(value, ptr, llvm::Align(alignment), mask);
+#else
+    store = builder_->CreateMaskedStore(value, ptr, alignment, mask);
+#endif
+    AddAliasInfo(store, op->buffer_var.get(), op->index);
+  } else {
+    int basic_align = t.bits() / 8;
+    llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, MakeValue(op->index));
+#if TVM_LLVM_VERSION >= 110
+    store = builder_->CreateMaskedScatter(value, ptrs, llvm::Align(basic_align), mask);
+#else
+    store = builder_->CreateMaskedScatter(value, ptrs, basic_align, mask);
+#endif
+    AddAliasInfo(store, op->buffer_var.get(), PrimExpr());
+  }
+}
+
 void CodeGenLLVM::VisitStmt_(const ForNode* op) {
   ICHECK(is_zero(op->min));
   analyzer_->Bind(op->loop_var, Range::FromMinExtent(op->min, op->extent));
@@ -1407,6 +1506,18 @@ void CodeGenLLVM::VisitStmt_(const AttrStmtNode* op) {
     const VarNode* v = op->node.as<VarNode>();
     ICHECK(v);
     volatile_buf_.insert(v);
+  } else if (op->attr_key == tir::attr::nontemporal_store) {
+    const VarNode* v = op->node.as<VarNode>();
+    ICHECK(v);
+    if (is_one(op->value)) {
+      nontemporal_buf_.insert(v);
+      this->VisitStmt(op->body);
+      nontemporal_buf_.erase(v);
+      if (nontemporal_store_emitted_) {
+        CreateStoreFence();
+      }
+      return;
+    }
   }
   this->VisitStmt(op->body);
 }
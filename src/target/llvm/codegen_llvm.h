@@ -284,6 +284,10 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   llvm::Value* CreateMul(DataType t, llvm::Value* a, llvm::Value* b);
   llvm::Value* CreateBroadcast(llvm::Value* value, int lanes);
   llvm::Value* CreateBufferPtr(DataType t, llvm::Value* buffer, llvm::Value* index);
+  // Load and store that only access the lanes enabled by the predicate,
+  // lowered to the llvm masked load/store or gather/scatter intrinsics.
+  llvm::Value* CreatePredicatedLoad(const LoadNode* op, llvm::Value* buffer);
+  void CreatePredicatedStore(const StoreNode* op, llvm::Value* buffer, llvm::Value* value);
   // Vector concatenation.
   llvm::Value* CreateVecSlice(llvm::Value* vec, int begin, int extent);
   llvm::Value* CreateVecFlip(llvm::Value* vec);
@@ -294,6 +298,10 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
                        const Var& loop_var, const Stmt& body);
   // add alias information.
   void AddAliasInfo(llvm::Instruction* load, const VarNode* buffer, PrimExpr index);
+  // Mark the store as non-temporal if the buffer is in a nontemporal_store scope.
+  void AddNontemporalInfo(llvm::StoreInst* store, const VarNode* buffer);
+  // Order the non-temporal stores emitted so far before the following stores.
+  void CreateStoreFence();
   // The IRBuilder.
   using IRBuilder = llvm::IRBuilder<llvm::ConstantFolder, llvm::IRBuilderDefaultInserter>;
   // The current function
@@ -341,6 +349,10 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   std::unordered_set<const VarNode*> alias_var_set_;
   // set of volatile buffer.
   std::unordered_set<const VarNode*> volatile_buf_;
+  // set of buffer whose stores are non-temporal.
+  std::unordered_set<const VarNode*> nontemporal_buf_;
+  // Whether a non-temporal store was emitted since the last store fence.
+  bool nontemporal_store_emitted_{false};
   // deep comparison of PrimExpr
   ExprDeepEqual deep_equal_;
   // binding of let variables. Enables duplicate var defs that map to same value
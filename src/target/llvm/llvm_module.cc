@@ -37,6 +37,7 @@
 #include "codegen_cpu.h"
 #include "codegen_llvm.h"
 #include "llvm_common.h"
+#include "llvm_orc_jit.h"
 
 namespace tvm {
 namespace codegen {
@@ -48,6 +49,7 @@ using runtime::TVMRetValue;
 class LLVMModuleNode final : public runtime::ModuleNode {
  public:
   ~LLVMModuleNode() {
+    orc_jit_.reset();
     module_.reset();
     if (ee_ != nullptr) {
       ee_->runStaticConstructorsDestructors(true);
@@ -77,7 +79,7 @@ class LLVMModuleNode final : public runtime::ModuleNode {
       }
       return PackedFunc([target_triple](TVMArgs args, TVMRetValue* rv) { *rv = target_triple; });
     }
-    if (ee_ == nullptr) LazyInitJIT();
+    if (ee_ == nullptr && orc_jit_ == nullptr) LazyInitJIT();
 
     std::lock_guard<std::mutex> lock(mutex_);
 
@@ -311,12 +313,26 @@ class LLVMModuleNode final : public runtime::ModuleNode {
  private:
   void LazyInitJIT() {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (ee_) {
+    if (ee_ || orc_jit_) {
       return;
     }
     if (!target_.defined()) {
       target_ = Target("llvm");
     }
+    if (target_->GetAttr<String>("jit").value_or("mcjit") == "orc") {
+      LazyInitORCJIT();
+    } else {
+      LazyInitMCJIT();
+    }
+    if (void** ctx_addr =
+            reinterpret_cast<void**>(GetGlobalAddr(runtime::symbol::tvm_module_ctx))) {
+      *ctx_addr = this;
+    }
+    runtime::InitContextFunctions(
+        [this](const char* name) { return reinterpret_cast<void*>(GetGlobalAddr(name)); });
+  }
+  // Create an MCJIT execution engine, which compiles the whole module.
+  void LazyInitMCJIT() {
     llvm::EngineBuilder builder(std::move(module_));
     std::string triple, mcpu, mattr;
     llvm::TargetOptions opt;
@@ -346,19 +362,22 @@ class LLVMModuleNode final : public runtime::ModuleNode {
     ee_ = builder.create(tm.release());
     ICHECK(ee_ != nullptr) << "Failed to initialize jit engine for " << mptr_->getTargetTriple();
     ee_->runStaticConstructorsDestructors(false);
-
-    if (void** ctx_addr =
-            reinterpret_cast<void**>(GetGlobalAddr(runtime::symbol::tvm_module_ctx))) {
-      *ctx_addr = this;
+  }
+  // Create an ORC JIT session, which compiles each function on its first call.
+  void LazyInitORCJIT() {
+    std::unique_ptr<llvm::TargetMachine> tm_sys = GetLLVMTargetMachine(Target("llvm"));
+    if (tm_sys->getTargetTriple().getArch() != tm_->getTargetTriple().getArch()) {
+      LOG(FATAL) << "Cannot run module, architecture mismatch "
+                 << " module=" << tm_->getTargetTriple().str()
+                 << " system=" << tm_sys->getTargetTriple().str();
     }
-    runtime::InitContextFunctions(
-        [this](const char* name) { return reinterpret_cast<void*>(GetGlobalAddr(name)); });
+    orc_jit_ = ORCJIT::Create(*mptr_, target_);
   }
   // Get global address from execution engine.
   uint64_t GetGlobalAddr(const std::string& name) const {
     // first verifies if GV exists.
     if (mptr_->getGlobalVariable(name) != nullptr) {
-      return ee_->getGlobalValueAddress(name);
+      return orc_jit_ ? orc_jit_->Lookup(name) : ee_->getGlobalValueAddress(name);
     } else {
       return 0;
     }
@@ -366,7 +385,7 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   uint64_t GetFunctionAddr(const std::string& name) const {
     // first verifies if GV exists.
     if (mptr_->getFunction(name) != nullptr) {
-      return ee_->getFunctionAddress(name);
+      return orc_jit_ ? orc_jit_->Lookup(name) : ee_->getFunctionAddress(name);
     } else {
       return 0;
     }
@@ -378,11 +397,13 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   std::mutex mutex_;
   // execution engine
   llvm::ExecutionEngine* ee_{nullptr};
+  // ORC JIT session, used instead of the execution engine when the target sets -jit=orc.
+  std::unique_ptr<ORCJIT> orc_jit_;
   // The raw pointer to the module.
   llvm::Module* mptr_{nullptr};
   // The target machine
   std::unique_ptr<llvm::TargetMachine> tm_{nullptr};
-  // The module, can be moved to ee if JIT is enabled.
+  // The module, can be moved to ee if MCJIT is enabled.
   std::unique_ptr<llvm::Module> module_;
   // the context.
   std::shared_ptr<llvm::LLVMContext> ctx_;
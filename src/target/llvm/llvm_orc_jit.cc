@@ -0,0 +1,229 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file llvm_orc_jit.cc
+ * \brief Lazy per-function JIT of LLVM modules based on ORC LLJIT.
+ */
+#ifdef TVM_LLVM_VERSION
+
+#include "llvm_orc_jit.h"
+
+#if TVM_LLVM_VERSION >= 130
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Support/MD5.h>
+#endif
+
+#include <thread>
+#include <utility>
+
+namespace tvm {
+namespace codegen {
+
+#if TVM_LLVM_VERSION >= 130
+
+/*! \brief Abort with the message of an LLVM error. */
+static void CheckLLVMError(llvm::Error err, const char* what) {
+  if (err) {
+    LOG(FATAL) << what << ": " << llvm::toString(std::move(err));
+  }
+}
+
+/*!
+ * \brief Cache of the object files of the compiled partitions in a directory.
+ *
+ *  The files are named after the hash of the bitcode of the partition and of
+ *  the target, so a cache directory can be shared by modules and processes.
+ */
+class ObjectFileCache : public llvm::ObjectCache {
+ public:
+  ObjectFileCache(std::string dir, std::string target)
+      : dir_(std::move(dir)), target_(std::move(target)) {
+    std::error_code ecode = llvm::sys::fs::create_directories(dir_);
+    if (ecode) {
+      LOG(WARNING) << "Cannot create the JIT cache directory " << dir_ << ": " << ecode.message();
+    }
+  }
+
+  void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) final {
+    std::string path = CachePath(*module);
+    // Write to a temporary file first, so concurrent readers never see a partial object.
+    std::string tmp =
+        path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::error_code ecode;
+    llvm::raw_fd_ostream os(tmp, ecode, llvm::sys::fs::OF_None);
+    if (ecode) {
+      LOG(WARNING) << "Cannot write JIT cache file " << tmp << ": " << ecode.message();
+      return;
+    }
+    os << obj.getBuffer();
+    os.close();
+    if (os.has_error() || llvm::sys::fs::rename(tmp, path)) {
+      os.clear_error();
+      llvm::sys::fs::remove(tmp);
+    }
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) final {
+    auto buffer = llvm::MemoryBuffer::getFile(CachePath(*module));
+    if (!buffer) {
+      return nullptr;
+    }
+    return std::move(*buffer);
+  }
+
+ private:
+  std::string CachePath(const llvm::Module& module) const {
+    llvm::SmallVector<char, 0> bitcode;
+    llvm::raw_svector_ostream os(bitcode);
+    llvm::WriteBitcodeToFile(module, os);
+    llvm::MD5 hash;
+    hash.update(target_);
+    hash.update(llvm::StringRef(bitcode.data(), bitcode.size()));
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+    return dir_ + "/" + result.digest().str().str() + ".o";
+  }
+
+  /*! \brief The cache directory. */
+  std::string dir_;
+  /*! \brief The target string, part of the key. */
+  std::string target_;
+};
+
+class ORCJIT::Impl {
+ public:
+  /*! \brief The object cache, it must outlive the JIT. */
+  std::unique_ptr<ObjectFileCache> cache;
+  /*! \brief The JIT. */
+  std::unique_ptr<llvm::orc::LLLazyJIT> jit;
+};
+
+ORCJIT::ORCJIT(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+ORCJIT::~ORCJIT() {
+  if (impl_->jit != nullptr) {
+    llvm::consumeError(impl_->jit->deinitialize(impl_->jit->getMainJITDylib()));
+  }
+}
+
+std::unique_ptr<ORCJIT> ORCJIT::Create(const llvm::Module& module, const Target& target) {
+  std::string triple, mcpu, mattr;
+  llvm::TargetOptions opt;
+  ParseLLVMTargetOptions(target, &triple, &mcpu, &mattr, &opt);
+  llvm::orc::JITTargetMachineBuilder jtmb{llvm::Triple(triple)};
+  if (mcpu.length() != 0) {
+    jtmb.setCPU(mcpu);
+  }
+  if (mattr.length() != 0) {
+    llvm::SmallVector<llvm::StringRef, 8> features;
+    llvm::StringRef(mattr).split(features, ",", -1, false);
+    for (const auto& feature : features) {
+      jtmb.getFeatures().AddFeature(feature);
+    }
+  }
+  jtmb.setOptions(opt);
+  jtmb.setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+
+  auto impl = std::make_unique<Impl>();
+  llvm::orc::LLLazyJITBuilder builder;
+  builder.setJITTargetMachineBuilder(jtmb);
+  int64_t num_threads = target->GetAttr<Integer>("jit-threads").value_or(Integer(0))->value;
+  if (num_threads > 0) {
+    builder.setNumCompileThreads(static_cast<unsigned>(num_threads));
+  }
+  String cache_dir = target->GetAttr<String>("jit-cache-dir").value_or("");
+  if (!cache_dir.empty()) {
+    impl->cache = std::make_unique<ObjectFileCache>(cache_dir, LLVMTargetToString(target));
+    llvm::ObjectCache* cache = impl->cache.get();
+    builder.setCompileFunctionCreator(
+        [cache](llvm::orc::JITTargetMachineBuilder jtmb)
+            -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+          return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb), cache);
+        });
+  }
+  auto jit = builder.create();
+  CheckLLVMError(jit.takeError(), "Failed to initialize the ORC JIT");
+  impl->jit = std::move(*jit);
+
+  const llvm::DataLayout& layout = impl->jit->getDataLayout();
+  ICHECK(layout == module.getDataLayout())
+      << "Data layout mismatch between module(" << module.getDataLayout().getStringRepresentation()
+      << ")"
+      << " and ORC JIT (" << layout.getStringRepresentation() << ")";
+  // Resolve the runtime and libc symbols in the process, like the MCJIT memory manager does.
+  auto generator =
+      llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(layout.getGlobalPrefix());
+  CheckLLVMError(generator.takeError(), "Failed to create the process symbol generator");
+  impl->jit->getMainJITDylib().addGenerator(std::move(*generator));
+
+  // The JIT needs a module in a context it owns, copy it through bitcode.
+  llvm::SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream os(bitcode);
+  llvm::WriteBitcodeToFile(module, os);
+  auto ctx = std::make_unique<llvm::LLVMContext>();
+  auto copy = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()), "TVMMod"), *ctx);
+  CheckLLVMError(copy.takeError(), "Failed to copy the module");
+  CheckLLVMError(
+      impl->jit->addLazyIRModule(llvm::orc::ThreadSafeModule(std::move(*copy), std::move(ctx))),
+      "Failed to add the module to the ORC JIT");
+  CheckLLVMError(impl->jit->initialize(impl->jit->getMainJITDylib()),
+                 "Failed to run the static constructors");
+  return std::unique_ptr<ORCJIT>(new ORCJIT(std::move(impl)));
+}
+
+uint64_t ORCJIT::Lookup(const std::string& name) {
+  auto symbol = impl_->jit->lookup(name);
+  if (!symbol) {
+    llvm::consumeError(symbol.takeError());
+    return 0;
+  }
+#if TVM_LLVM_VERSION >= 150
+  return symbol->getValue();
+#else
+  return symbol->getAddress();
+#endif
+}
+
+#else
+
+class ORCJIT::Impl {};
+
+ORCJIT::ORCJIT(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+ORCJIT::~ORCJIT() {}
+
+std::unique_ptr<ORCJIT> ORCJIT::Create(const llvm::Module& module, const Target& target) {
+  LOG(FATAL) << "The ORC JIT requires LLVM 13 or newer, use the default MCJIT engine instead";
+  return nullptr;
+}
+
+uint64_t ORCJIT::Lookup(const std::string& name) { return 0; }
+
+#endif  // TVM_LLVM_VERSION >= 130
+
+}  // namespace codegen
+}  // namespace tvm
+#endif  // TVM_LLVM_VERSION
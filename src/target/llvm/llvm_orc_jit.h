@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file llvm_orc_jit.h
+ * \brief Lazy per-function JIT of LLVM modules based on ORC LLJIT.
+ */
+#ifndef TVM_TARGET_LLVM_LLVM_ORC_JIT_H_
+#define TVM_TARGET_LLVM_LLVM_ORC_JIT_H_
+#ifdef TVM_LLVM_VERSION
+#include <tvm/target/target.h>
+
+#include <memory>
+#include <string>
+
+#include "llvm_common.h"
+
+namespace tvm {
+namespace codegen {
+
+/*!
+ * \brief A JIT session that compiles the functions of a module on their first call.
+ *
+ *  The module is split into one partition per function, a lookup returns a
+ *  stub that compiles the partition when it is called. The session is
+ *  configured by the attributes of the llvm target:
+ *
+ *  - `jit-threads`: number of threads compiling the partitions in the
+ *    background, 0 compiles on the calling thread.
+ *  - `jit-cache-dir`: directory caching the object files of the partitions,
+ *    keyed by the hash of the partition and of the target.
+ */
+class ORCJIT {
+ public:
+  ~ORCJIT();
+
+  /*!
+   * \brief Create a JIT session for a module.
+   * \param module The module, it is copied so the caller keeps ownership.
+   * \param target The target of the module.
+   * \return The JIT session.
+   */
+  static std::unique_ptr<ORCJIT> Create(const llvm::Module& module, const Target& target);
+
+  /*!
+   * \brief Get the address of a symbol, materializing it if needed.
+   * \param name The name of the symbol.
+   * \return The address, or 0 if the symbol cannot be found.
+   */
+  uint64_t Lookup(const std::string& name);
+
+ private:
+  class Impl;
+  explicit ORCJIT(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace codegen
+}  // namespace tvm
+#endif  // TVM_LLVM_VERSION
+#endif  // TVM_TARGET_LLVM_LLVM_ORC_JIT_H_
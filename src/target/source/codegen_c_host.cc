@@ -27,8 +27,10 @@
 #include <tvm/target/codegen.h>
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "../../arith/pattern_match.h"
 #include "../../support/str_escape.h"
 #include "../build_common.h"
 #include "../func_registry_generator.h"
@@ -39,14 +41,20 @@ namespace codegen {
 
 CodeGenCHost::CodeGenCHost() { module_name_ = GetUniqueName("__tvm_module_ctx"); }
 
-void CodeGenCHost::Init(bool output_ssa, bool emit_asserts, std::string target_str) {
+void CodeGenCHost::Init(bool output_ssa, bool emit_asserts, std::string target_str,
+                        std::string simd) {
   emit_asserts_ = emit_asserts;
+  simd_name_ = simd;
+  simd_ = simd.empty() ? nullptr : &CSIMDIntrinsics::Get(simd);
   declared_globals_.clear();
   decl_stream << "// tvm target: " << target_str << "\n";
   decl_stream << "#define TVM_EXPORTS\n";
   decl_stream << "#include \"tvm/runtime/c_runtime_api.h\"\n";
   decl_stream << "#include \"tvm/runtime/c_backend_api.h\"\n";
   decl_stream << "#include <math.h>\n";
+  if (simd_ != nullptr) {
+    decl_stream << simd_->header;
+  }
   CodeGenC::Init(output_ssa);
 }
 
@@ -122,6 +130,10 @@ void CodeGenCHost::PrintFinalReturn() {  // NOLINT(*)
 
 void CodeGenCHost::PrintType(DataType t, std::ostream& os) {  // NOLINT(*)
   int lanes = t.lanes();
+  if (IsSIMDVector(t)) {
+    os << simd_->VectorType(t);
+    return;
+  }
   if (t.is_handle()) {
     ICHECK_EQ(lanes, 1) << "does not support vector types";
     os << "void*";
@@ -186,6 +198,8 @@ void CodeGenCHost::PrintType(DataType t, std::ostream& os) {  // NOLINT(*)
 }
 
 void CodeGenCHost::VisitExpr_(const BroadcastNode* op, std::ostream& os) {  // NOLINT(*)
+  if (PrintSIMDIntrinsic("broadcast", op->dtype, {op->value}, os)) return;
+  CheckSIMDFallback("broadcast", op->dtype);
   std::string v = PrintExpr(op->value);
   os << "((";
   PrintType(op->dtype, os);
@@ -343,13 +357,290 @@ void CodeGenCHost::VisitStmt_(const AssertStmtNode* op) {  // NOLINT(*)
 }
 
 void CodeGenCHost::VisitExpr_(const MinNode* op, std::ostream& os) {  // NOLINT(*)
+  if (IsSIMDVector(op->dtype)) {
+    PrintVecBinaryOp("min", op->dtype, op->a, op->b, os);
+    return;
+  }
   PrintTernaryCondExpr(op, "<", os);
 }
 
 void CodeGenCHost::VisitExpr_(const MaxNode* op, std::ostream& os) {  // NOLINT(*)
+  if (IsSIMDVector(op->dtype)) {
+    PrintVecBinaryOp("max", op->dtype, op->a, op->b, os);
+    return;
+  }
   PrintTernaryCondExpr(op, ">", os);
 }
 
+void CodeGenCHost::VisitExpr_(const AddNode* op, std::ostream& os) {  // NOLINT(*)
+  if (IsSIMDVector(op->dtype)) {
+    // acc + a * b is a multiply-accumulate.
+    const MulNode* mul = op->b.as<MulNode>();
+    PrimExpr acc = op->a;
+    if (mul == nullptr) {
+      mul = op->a.as<MulNode>();
+      acc = op->b;
+    }
+    if (mul != nullptr && PrintSIMDIntrinsic("mla", op->dtype, {acc, mul->a, mul->b}, os)) {
+      return;
+    }
+  }
+  CodeGenC::VisitExpr_(op, os);
+}
+
+/*!
+ * \brief Match a saturating addition or subtraction on the narrow type T,
+ *  i.e. cast(T, clamp(cast(W, a) op cast(W, b), T.min, T.max)) with a wider W.
+ * \return The name of the operation, or an empty string.
+ */
+static std::string MatchSaturatingOp(const CastNode* op, PrimExpr* a, PrimExpr* b) {
+  DataType t = op->dtype;
+  if (!t.is_int() && !t.is_uint()) return "";
+  int64_t lo = t.is_int() ? -(int64_t(1) << (t.bits() - 1)) : 0;
+  int64_t hi = t.is_int() ? (int64_t(1) << (t.bits() - 1)) - 1 : (int64_t(1) << t.bits()) - 1;
+  auto is_bound = [&t](const PrimExpr& e, int64_t value) {
+    const auto* bcast = e.as<BroadcastNode>();
+    const auto* imm = bcast ? bcast->value.as<IntImmNode>() : nullptr;
+    return imm != nullptr && bcast->lanes == t.lanes() && imm->value == value;
+  };
+  PrimExpr value = op->value;
+  bool has_lo = false, has_hi = false;
+  for (int i = 0; i < 2; ++i) {
+    if (const auto* min = value.as<MinNode>()) {
+      if (has_hi || !is_bound(min->b, hi)) return "";
+      has_hi = true;
+      value = min->a;
+    } else if (const auto* max = value.as<MaxNode>()) {
+      if (has_lo || !is_bound(max->b, lo)) return "";
+      has_lo = true;
+      value = max->a;
+    }
+  }
+  auto match_operands = [&](const PrimExpr& x, const PrimExpr& y, bool is_sub) {
+    const auto* cx = x.as<CastNode>();
+    const auto* cy = y.as<CastNode>();
+    if (cx == nullptr || cy == nullptr || cx->value.dtype() != t || cy->value.dtype() != t) {
+      return false;
+    }
+    DataType wide = x.dtype();
+    // The wide type must hold every result, including the negative ones.
+    bool needs_sign = t.is_int() || is_sub;
+    if (wide.bits() <= t.bits() || (needs_sign && !wide.is_int()) ||
+        (!wide.is_int() && !wide.is_uint())) {
+      return false;
+    }
+    *a = cx->value;
+    *b = cy->value;
+    return true;
+  };
+  if (const auto* add = value.as<AddNode>()) {
+    // an unsigned sum never goes below the lower bound.
+    if (has_hi && (has_lo || t.is_uint()) && match_operands(add->a, add->b, false)) return "qadd";
+  } else if (const auto* sub = value.as<SubNode>()) {
+    // an unsigned difference never goes above the upper bound.
+    if (has_lo && (has_hi || t.is_uint()) && match_operands(sub->a, sub->b, true)) return "qsub";
+  }
+  return "";
+}
+
+void CodeGenCHost::VisitExpr_(const CastNode* op, std::ostream& os) {  // NOLINT(*)
+  if (IsSIMDVector(op->dtype)) {
+    PrimExpr a, b;
+    std::string name = MatchSaturatingOp(op, &a, &b);
+    if (!name.empty() && PrintSIMDIntrinsic(name, op->dtype, {a, b}, os)) return;
+  }
+  CodeGenC::VisitExpr_(op, os);
+}
+
+void CodeGenCHost::PrintVecBinaryOp(const std::string& op, DataType t, PrimExpr lhs, PrimExpr rhs,
+                                    std::ostream& os) {  // NOLINT(*)
+  static const std::unordered_map<std::string, std::string> names = {
+      {"+", "add"}, {"-", "sub"}, {"*", "mul"}, {"min", "min"}, {"max", "max"}};
+  if (IsSIMDVector(t)) {
+    auto it = names.find(op);
+    if (it != names.end() && PrintSIMDIntrinsic(it->second, t, {lhs, rhs}, os)) return;
+    CheckSIMDFallback(op, t);
+  }
+  CodeGenC::PrintVecBinaryOp(op, t, lhs, rhs, os);
+}
+
+std::string CodeGenCHost::GetVecLoad(DataType t, const VarNode* buffer, PrimExpr base) {
+  std::string intrin = IsSIMDVector(t) ? simd_->Intrinsic("load", t) : "";
+  if (intrin.empty()) {
+    return CodeGenC::GetVecLoad(t, buffer, base);
+  }
+  return intrin + "(" + GetVecPointer(t, buffer, base) + ")";
+}
+
+void CodeGenCHost::PrintVecStore(const VarNode* buffer, DataType t, PrimExpr base,
+                                 const std::string& value) {
+  std::string intrin = IsSIMDVector(t) ? simd_->Intrinsic("store", t) : "";
+  if (intrin.empty()) {
+    CodeGenC::PrintVecStore(buffer, t, base, value);
+    return;
+  }
+  std::string ptr = GetVecPointer(t, buffer, base);
+  this->PrintIndent();
+  stream << intrin << "(" << ptr << ", " << value << ");\n";
+}
+
+std::string CodeGenCHost::CastFromTo(std::string value, DataType from, DataType target) {
+  if (from == target || !IsSIMDVector(target)) {
+    return CodeGenC::CastFromTo(value, from, target);
+  }
+  CheckSIMDFallback("cast", target);
+  if (IsSIMDVector(from)) {
+    // A C cast reinterprets the bits of a vector, convert the lanes instead.
+    std::ostringstream os;
+    os << "__builtin_convertvector(" << value << ", ";
+    PrintType(target, os);
+    os << ")";
+    return os.str();
+  }
+  return CodeGenC::CastFromTo(value, from, target);
+}
+
+bool CodeGenCHost::IsSIMDVector(DataType t) const {
+  return simd_ != nullptr && t.lanes() > 1 && !simd_->VectorType(t).empty();
+}
+
+bool CodeGenCHost::PrintSIMDIntrinsic(const std::string& op, DataType t,
+                                      const Array<PrimExpr>& args,
+                                      std::ostream& os) {  // NOLINT(*)
+  if (!IsSIMDVector(t)) return false;
+  std::string intrin = simd_->Intrinsic(op, t);
+  if (intrin.empty()) return false;
+  os << intrin << "(";
+  for (size_t i = 0; i < args.size(); ++i) {
+    if (i != 0) os << ", ";
+    this->PrintExpr(args[i], os);
+  }
+  os << ")";
+  return true;
+}
+
+void CodeGenCHost::CheckSIMDFallback(const std::string& op, DataType t) const {
+  if (IsSIMDVector(t) && simd_->packed) {
+    LOG(FATAL) << "The " << simd_name_ << " SIMD instruction set has no " << op << " on " << t
+               << ", vectorize the loop with another type or remove -simd from the target";
+  }
+}
+
+std::string CodeGenCHost::GetVecPointer(DataType t, const VarNode* buffer, PrimExpr base) {
+  std::ostringstream os;
+  os << "((";
+  PrintType(t.element_of(), os);
+  os << "*)" << GetVarID(buffer) << " + (";
+  PrintExpr(base, os);
+  os << "))";
+  return os.str();
+}
+
+std::vector<PrimExpr> CodeGenCHost::GetElemIndices(DataType t, const PrimExpr& index) const {
+  std::vector<PrimExpr> indices;
+  if (const auto* ramp = index.as<RampNode>()) {
+    indices.push_back(ramp->base);
+    for (int i = 1; i < t.lanes(); ++i) {
+      indices.push_back(ramp->base + ramp->stride * make_const(ramp->stride.dtype(), i));
+    }
+  } else if (const auto* bcast = index.as<BroadcastNode>()) {
+    indices.assign(t.lanes(), bcast->value);
+  } else {
+    LOG(FATAL) << "The " << simd_name_ << " SIMD instruction set has no gather or scatter on "
+               << t << ", the index must be a ramp, got " << index;
+  }
+  return indices;
+}
+
+void CodeGenCHost::VisitExpr_(const LoadNode* op, std::ostream& os) {  // NOLINT(*)
+  arith::PVar<PrimExpr> base;
+  if (!IsSIMDVector(op->dtype) || arith::ramp(base, 1, op->dtype.lanes()).Match(op->index)) {
+    CodeGenC::VisitExpr_(op, os);
+    return;
+  }
+  ICHECK(is_one(op->predicate)) << "predicated load is not supported";
+  // Load the elements one by one, and pack them into the vector.
+  std::vector<PrimExpr> indices = GetElemIndices(op->dtype, op->index);
+  for (int i = 0; i < op->dtype.lanes(); ++i) {
+    std::string ref = GetBufferRef(op->dtype.element_of(), op->buffer_var.get(), indices[i]);
+    PrintVecElemLoadExpr(op->dtype, i, ref, os);
+  }
+}
+
+void CodeGenCHost::VisitStmt_(const StoreNode* op) {  // NOLINT(*)
+  DataType t = op->value.dtype();
+  arith::PVar<PrimExpr> base;
+  if (!IsSIMDVector(t) || arith::ramp(base, 1, t.lanes()).Match(op->index)) {
+    CodeGenC::VisitStmt_(op);
+    return;
+  }
+  ICHECK(is_one(op->predicate)) << "Predicated store is not supported";
+  std::vector<PrimExpr> indices = GetElemIndices(t, op->index);
+  // store elements seperately, in a new scope as in CodeGenC
+  int vec_scope = BeginScope();
+  std::string value = SSAGetID(PrintExpr(op->value), t);
+  for (int i = 0; i < t.lanes(); ++i) {
+    std::string ref = GetBufferRef(t.element_of(), op->buffer_var.get(), indices[i]);
+    this->PrintIndent();
+    stream << ref << " = ";
+    PrintVecElemLoad(value, t, i, stream);
+    stream << ";\n";
+  }
+  EndScope(vec_scope);
+}
+
+void CodeGenCHost::PrintVecElemLoad(const std::string& vec, DataType t, int i,
+                                    std::ostream& os) {  // NOLINT(*)
+  if (!IsSIMDVector(t)) {
+    CodeGenC::PrintVecElemLoad(vec, t, i, os);
+  } else if (simd_->packed) {
+    os << "((";
+    PrintType(t.element_of(), os);
+    os << ")tvm_simd_lane" << t.bits() << "(" << vec << ", " << i << "))";
+  } else {
+    // The vector types of the instruction set are vectors of the compiler.
+    os << vec << "[" << i << "]";
+  }
+}
+
+void CodeGenCHost::PrintVecElemStore(const std::string& vec, DataType t, int i,
+                                     const std::string& value) {
+  if (!IsSIMDVector(t)) {
+    CodeGenC::PrintVecElemStore(vec, t, i, value);
+    return;
+  }
+  this->PrintIndent();
+  if (simd_->packed) {
+    stream << vec << " = tvm_simd_set_lane" << t.bits() << "(" << vec << ", " << i << ", "
+           << value << ");\n";
+  } else {
+    stream << vec << "[" << i << "] = " << value << ";\n";
+  }
+}
+
+void CodeGenCHost::PrintVecElemLoadExpr(DataType t, int i, const std::string& value,
+                                        std::ostream& os) {  // NOLINT(*)
+  if (!IsSIMDVector(t)) {
+    CodeGenC::PrintVecElemLoadExpr(t, i, value, os);
+    return;
+  }
+  if (i == 0) {
+    if (simd_->packed) {
+      os << "tvm_simd_pack" << t.bits() << "(";
+    } else {
+      os << "((";
+      PrintType(t, os);
+      os << "){";
+    }
+  }
+  os << value;
+  if (i != t.lanes() - 1) {
+    os << ", ";
+  } else {
+    os << (simd_->packed ? ")" : "})");
+  }
+}
+
 template <typename T>
 inline void CodeGenCHost::PrintTernaryCondExpr(const T* op, const char* compare,
                                                std::ostream& os) {  // NOLINT(*)
@@ -369,7 +660,7 @@ runtime::Module BuildCHost(IRModule mod, Target target) {
   bool output_ssa = false;
   bool emit_asserts = false;
   CodeGenCHost cg;
-  cg.Init(output_ssa, emit_asserts, target->str());
+  cg.Init(output_ssa, emit_asserts, target->str(), target->GetAttr<String>("simd").value_or(""));
 
   Map<String, LinkedParam> linked_params;
   bool found_linked_params = false;
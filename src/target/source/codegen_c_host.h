@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "codegen_c.h"
+#include "codegen_c_simd.h"
 #include "tvm/target/codegen.h"
 #include "tvm/tir/expr.h"
 
@@ -38,7 +39,14 @@ namespace codegen {
 class CodeGenCHost final : public CodeGenC {
  public:
   CodeGenCHost();
-  void Init(bool output_ssa, bool emit_asserts, std::string target_str);
+  /*!
+   * \brief Initialize the code generator.
+   * \param output_ssa Whether to output SSA.
+   * \param emit_asserts Whether to emit the asserts.
+   * \param target_str The target string, printed in the header of the code.
+   * \param simd The SIMD instruction set of the vector operations, empty for generic C.
+   */
+  void Init(bool output_ssa, bool emit_asserts, std::string target_str, std::string simd);
 
   void AddFunction(const PrimFunc& f);
 
@@ -52,15 +60,34 @@ class CodeGenCHost final : public CodeGenC {
   void PrintFuncPrefix() final;                        // NOLINT(*)
   void PrintFinalReturn() final;                       // NOLINT(*)
 
+  // print the vector operations with the SIMD intrinsics
+  void PrintVecBinaryOp(const std::string& op, DataType t, PrimExpr lhs, PrimExpr rhs,
+                        std::ostream& os) final;  // NOLINT(*)
+  std::string GetVecLoad(DataType t, const VarNode* buffer, PrimExpr base) final;
+  void PrintVecStore(const VarNode* buffer, DataType t, PrimExpr base,
+                     const std::string& value) final;
+  std::string CastFromTo(std::string value, DataType from, DataType target) final;
+  // access the lanes of the vectors of the SIMD instruction set
+  void PrintVecElemLoad(const std::string& vec, DataType t, int i,
+                        std::ostream& os) final;  // NOLINT(*)
+  void PrintVecElemStore(const std::string& vec, DataType t, int i,
+                         const std::string& value) final;
+  void PrintVecElemLoadExpr(DataType t, int i, const std::string& value,
+                            std::ostream& os) final;  // NOLINT(*)
+
   // overload visitor functions
   void VisitExpr_(const BroadcastNode* op, std::ostream& os) final;  // NOLINT(*)
+  void VisitExpr_(const AddNode* op, std::ostream& os) final;        // NOLINT(*)
+  void VisitExpr_(const CastNode* op, std::ostream& os) final;       // NOLINT(*)
   void VisitExpr_(const CallNode* op, std::ostream& os) final;       // NOLINT(*)
+  void VisitExpr_(const LoadNode* op, std::ostream& os) final;       // NOLINT(*)
   // overload min and max to use the ternary operator, so we don't rely on the
   // standard library implementations
   void VisitExpr_(const MinNode* op, std::ostream& os) final;  // NOLINT(*)
   void VisitExpr_(const MaxNode* op, std::ostream& os) final;  // NOLINT(*)
 
   void VisitStmt_(const AssertStmtNode* op) final;  // NOLINT(*)
+  void VisitStmt_(const StoreNode* op) final;       // NOLINT(*)
 
   Array<String> GetFunctionNames() { return function_names_; }
 
@@ -81,12 +108,34 @@ class CodeGenCHost final : public CodeGenC {
   Array<String> function_names_;
   /*! \brief whether to emit asserts in the resulting C code */
   bool emit_asserts_;
+  /*! \brief the name of the SIMD instruction set, empty for generic C */
+  std::string simd_name_;
+  /*! \brief the intrinsics of the SIMD instruction set, nullptr for generic C */
+  const CSIMDIntrinsics* simd_{nullptr};
 
   FunctionInfo GetFunctionInfo(const CallNode* op);
   void PrintGetFuncFromBackend(const std::string& func_name, const std::string& packed_func_name);
   void PrintFuncCall(const std::string& packed_func_name, int num_args);
   void PrintFuncCallC(const std::string& packed_func_name, int num_args);
 
+  /*! \brief Whether a type is a native vector type of the SIMD instruction set. */
+  bool IsSIMDVector(DataType t) const;
+  /*!
+   * \brief Print the SIMD intrinsic of an operation.
+   * \return false if the operation has no intrinsic for the type.
+   */
+  bool PrintSIMDIntrinsic(const std::string& op, DataType t, const Array<PrimExpr>& args,
+                          std::ostream& os);  // NOLINT(*)
+  /*! \brief Abort when the C operators are wrong on the vectors of the instruction set. */
+  void CheckSIMDFallback(const std::string& op, DataType t) const;
+  /*! \brief Get a pointer to the elements of a vector access. */
+  std::string GetVecPointer(DataType t, const VarNode* buffer, PrimExpr base);
+  /*!
+   * \brief Get the element indices of a vector access which is not contiguous,
+   *  it aborts when the index is not a ramp or a broadcast.
+   */
+  std::vector<PrimExpr> GetElemIndices(DataType t, const PrimExpr& index) const;
+
   /*!
    * \brief Print ternary conditional operator implementing binary `op`
    * Forces the operands to be in SSA form.
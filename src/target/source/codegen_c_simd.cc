@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file codegen_c_simd.cc
+ */
+#include "codegen_c_simd.h"
+
+#include <tvm/runtime/logging.h>
+
+namespace tvm {
+namespace codegen {
+
+/*!
+ * \brief Include the declarations of the intrinsics, or their portable C
+ *  emulation when the generated code is compiled with TVM_SIMD_EMULATION.
+ */
+static std::string IncludeIntrinsics(const std::string& header) {
+  return "#ifdef TVM_SIMD_EMULATION\n"
+         "#include \"tvm/runtime/crt/simd_emulation.h\"\n"
+         "#else\n"
+         "#include <" +
+         header + ">\n" + "#endif\n";
+}
+
+// Broadcast of a scalar into a vector packed in a 32-bit register, and the access to the
+// lanes of the vector, which the instruction sets have no intrinsics for.
+static const char* kPackedHelpers =
+    "static inline uint32_t tvm_simd_dup8(uint32_t x) { return (x & 0xffu) * 0x01010101u; }\n"
+    "static inline uint32_t tvm_simd_dup16(uint32_t x) { return (x & 0xffffu) * 0x00010001u; }\n"
+    "static inline uint32_t tvm_simd_lane8(uint32_t x, int i) { return (x >> (i * 8)) & 0xffu; }\n"
+    "static inline uint32_t tvm_simd_lane16(uint32_t x, int i) {\n"
+    "  return (x >> (i * 16)) & 0xffffu;\n"
+    "}\n"
+    "static inline uint32_t tvm_simd_set_lane8(uint32_t x, int i, uint32_t v) {\n"
+    "  return (x & ~(0xffu << (i * 8))) | ((v & 0xffu) << (i * 8));\n"
+    "}\n"
+    "static inline uint32_t tvm_simd_set_lane16(uint32_t x, int i, uint32_t v) {\n"
+    "  return (x & ~(0xffffu << (i * 16))) | ((v & 0xffffu) << (i * 16));\n"
+    "}\n"
+    "static inline uint32_t tvm_simd_pack8(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {\n"
+    "  return (a & 0xffu) | (b & 0xffu) << 8 | (c & 0xffu) << 16 | d << 24;\n"
+    "}\n"
+    "static inline uint32_t tvm_simd_pack16(uint32_t a, uint32_t b) {\n"
+    "  return (a & 0xffffu) | b << 16;\n"
+    "}\n";
+
+static std::string Key(const std::string& op, DataType t) {
+  return op + ":" + runtime::DLDataType2String(t);
+}
+
+const CSIMDIntrinsics& CSIMDIntrinsics::Get(const std::string& name) {
+  static const CSIMDIntrinsics neon = NEON();
+  static const CSIMDIntrinsics dsp = DSP();
+  static const CSIMDIntrinsics rvp = RVP();
+  if (name == "neon") return neon;
+  if (name == "dsp") return dsp;
+  if (name == "rvp") return rvp;
+  LOG(FATAL) << "Unknown SIMD instruction set " << name << ", expect neon, dsp or rvp";
+  return neon;
+}
+
+std::string CSIMDIntrinsics::VectorType(DataType t) const {
+  auto it = types_.find(runtime::DLDataType2String(t));
+  return it != types_.end() ? it->second : "";
+}
+
+std::string CSIMDIntrinsics::Intrinsic(const std::string& op, DataType t) const {
+  auto it = intrinsics_.find(Key(op, t));
+  return it != intrinsics_.end() ? it->second : "";
+}
+
+CSIMDIntrinsics CSIMDIntrinsics::NEON() {
+  CSIMDIntrinsics isa;
+  isa.header = IncludeIntrinsics("arm_neon.h");
+  struct {
+    DataType t;
+    const char* suffix;
+  } types[] = {
+      {DataType::Float(32, 4), "f32"},  {DataType::Int(8, 16), "s8"},
+      {DataType::Int(16, 8), "s16"},    {DataType::Int(32, 4), "s32"},
+      {DataType::UInt(8, 16), "u8"},    {DataType::UInt(16, 8), "u16"},
+      {DataType::UInt(32, 4), "u32"},
+  };
+  for (const auto& type : types) {
+    std::string suffix = type.suffix;
+    std::string elem = suffix[0] == 'f' ? "float" : suffix[0] == 's' ? "int" : "uint";
+    isa.types_[runtime::DLDataType2String(type.t)] =
+        elem + std::to_string(type.t.bits()) + "x" + std::to_string(type.t.lanes()) + "_t";
+    isa.intrinsics_[Key("load", type.t)] = "vld1q_" + suffix;
+    isa.intrinsics_[Key("store", type.t)] = "vst1q_" + suffix;
+    isa.intrinsics_[Key("broadcast", type.t)] = "vdupq_n_" + suffix;
+    isa.intrinsics_[Key("add", type.t)] = "vaddq_" + suffix;
+    isa.intrinsics_[Key("sub", type.t)] = "vsubq_" + suffix;
+    isa.intrinsics_[Key("mul", type.t)] = "vmulq_" + suffix;
+    isa.intrinsics_[Key("mla", type.t)] = "vmlaq_" + suffix;
+    isa.intrinsics_[Key("min", type.t)] = "vminq_" + suffix;
+    isa.intrinsics_[Key("max", type.t)] = "vmaxq_" + suffix;
+    if (!type.t.is_float()) {
+      isa.intrinsics_[Key("qadd", type.t)] = "vqaddq_" + suffix;
+      isa.intrinsics_[Key("qsub", type.t)] = "vqsubq_" + suffix;
+    }
+  }
+  return isa;
+}
+
+CSIMDIntrinsics CSIMDIntrinsics::DSP() {
+  CSIMDIntrinsics isa;
+  isa.header = IncludeIntrinsics("arm_acle.h") + kPackedHelpers;
+  isa.packed = true;
+  struct {
+    DataType t;
+    const char* type;
+    const char* add;
+    const char* sub;
+    const char* qadd;
+    const char* qsub;
+  } types[] = {
+      {DataType::Int(8, 4), "int8x4_t", "__sadd8", "__ssub8", "__qadd8", "__qsub8"},
+      {DataType::UInt(8, 4), "uint8x4_t", "__uadd8", "__usub8", "__uqadd8", "__uqsub8"},
+      {DataType::Int(16, 2), "int16x2_t", "__sadd16", "__ssub16", "__qadd16", "__qsub16"},
+      {DataType::UInt(16, 2), "uint16x2_t", "__uadd16", "__usub16", "__uqadd16", "__uqsub16"},
+  };
+  for (const auto& type : types) {
+    isa.types_[runtime::DLDataType2String(type.t)] = type.type;
+    isa.intrinsics_[Key("broadcast", type.t)] =
+        type.t.bits() == 8 ? "tvm_simd_dup8" : "tvm_simd_dup16";
+    isa.intrinsics_[Key("add", type.t)] = type.add;
+    isa.intrinsics_[Key("sub", type.t)] = type.sub;
+    isa.intrinsics_[Key("qadd", type.t)] = type.qadd;
+    isa.intrinsics_[Key("qsub", type.t)] = type.qsub;
+  }
+  return isa;
+}
+
+CSIMDIntrinsics CSIMDIntrinsics::RVP() {
+  CSIMDIntrinsics isa;
+  isa.header = IncludeIntrinsics("rvp_intrinsic.h") + kPackedHelpers;
+  isa.packed = true;
+  DataType types[] = {DataType::Int(8, 4), DataType::UInt(8, 4), DataType::Int(16, 2),
+                      DataType::UInt(16, 2)};
+  for (DataType t : types) {
+    std::string bits = std::to_string(t.bits());
+    std::string sign = t.is_int() ? "s" : "u";
+    std::string saturate = t.is_int() ? "k" : "uk";
+    // The intrinsics of RV32 take the packed vectors as 32-bit integers.
+    isa.types_[runtime::DLDataType2String(t)] = "uint32_t";
+    isa.intrinsics_[Key("broadcast", t)] = "tvm_simd_dup" + bits;
+    isa.intrinsics_[Key("add", t)] = "__rv_add" + bits;
+    isa.intrinsics_[Key("sub", t)] = "__rv_sub" + bits;
+    isa.intrinsics_[Key("qadd", t)] = "__rv_" + saturate + "add" + bits;
+    isa.intrinsics_[Key("qsub", t)] = "__rv_" + saturate + "sub" + bits;
+    isa.intrinsics_[Key("min", t)] = "__rv_" + sign + "min" + bits;
+    isa.intrinsics_[Key("max", t)] = "__rv_" + sign + "max" + bits;
+  }
+  return isa;
+}
+
+}  // namespace codegen
+}  // namespace tvm
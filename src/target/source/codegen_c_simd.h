@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file codegen_c_simd.h
+ * \brief The SIMD intrinsics printed by the C host code generator.
+ */
+#ifndef TVM_TARGET_SOURCE_CODEGEN_C_SIMD_H_
+#define TVM_TARGET_SOURCE_CODEGEN_C_SIMD_H_
+
+#include <tvm/runtime/data_type.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace tvm {
+namespace codegen {
+
+/*!
+ * \brief The vector types and intrinsics of a SIMD instruction set.
+ *
+ *  The instruction set is selected by the `-simd` attribute of the c target:
+ *
+ *  - `neon`: Arm Advanced SIMD on 128-bit registers, from arm_neon.h.
+ *  - `dsp`: the 32-bit SIMD of the Armv7E-M and Armv8-M DSP extension, from arm_acle.h.
+ *  - `rvp`: the 32-bit RISC-V packed SIMD extension, from rvp_intrinsic.h.
+ *
+ *  The operations are named "load", "store", "broadcast", "add", "sub", "mul",
+ *  "mla" (multiply-accumulate), "min", "max", "qadd" and "qsub" (saturating).
+ */
+class CSIMDIntrinsics {
+ public:
+  /*!
+   * \brief Get the intrinsics of an instruction set.
+   * \param name The name of the instruction set.
+   * \return The intrinsics, it aborts on an unknown name.
+   */
+  static const CSIMDIntrinsics& Get(const std::string& name);
+
+  /*!
+   * \brief Get the name of the native vector type.
+   * \param t The vector type.
+   * \return The name, or an empty string if the type has no native vector type.
+   */
+  std::string VectorType(DataType t) const;
+
+  /*!
+   * \brief Get the intrinsic of an operation.
+   * \param op The operation.
+   * \param t The vector type of the operation.
+   * \return The intrinsic, or an empty string if the operation has no intrinsic.
+   */
+  std::string Intrinsic(const std::string& op, DataType t) const;
+
+  /*! \brief The code including the declarations of the intrinsics. */
+  std::string header;
+  /*!
+   * \brief Whether the vectors are packed in a general purpose register,
+   *  the C operators are then wrong on the vectors.
+   */
+  bool packed{false};
+
+ private:
+  /*! \brief The native vector types. */
+  std::unordered_map<std::string, std::string> types_;
+  /*! \brief The intrinsics, keyed by the operation and the vector type. */
+  std::unordered_map<std::string, std::string> intrinsics_;
+
+  static CSIMDIntrinsics NEON();
+  static CSIMDIntrinsics DSP();
+  static CSIMDIntrinsics RVP();
+};
+
+}  // namespace codegen
+}  // namespace tvm
+
+#endif  // TVM_TARGET_SOURCE_CODEGEN_C_SIMD_H_
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file annotate_nontemporal_store.cc
+ * \brief Mark the stores to large write-only output buffers as non-temporal.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_set>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief Minimum size in bytes of a vector store that fills a whole write-combining chunk. */
+static constexpr int kMinNontemporalStoreBytes = 16;
+
+/*!
+ * \brief Find the buffers that are only written by full, contiguous vector
+ *  stores and are not otherwise referenced.
+ */
+class WriteOnlyStreamDetector : public StmtExprVisitor {
+ public:
+  bool IsWriteOnlyStream(const VarNode* buffer) const {
+    return streamed_.count(buffer) && !rejected_.count(buffer);
+  }
+
+  void VisitStmt_(const StoreNode* op) final {
+    const auto* ramp = op->index.as<RampNode>();
+    int bytes = op->value.dtype().bytes() * op->value.dtype().lanes();
+    if (ramp && is_one(ramp->stride) && bytes >= kMinNontemporalStoreBytes) {
+      streamed_.insert(op->buffer_var.get());
+    } else {
+      rejected_.insert(op->buffer_var.get());
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::nontemporal_store) {
+      // already annotated.
+      if (const auto* v = op->node.as<VarNode>()) rejected_.insert(v);
+      this->VisitStmt(op->body);
+      return;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    rejected_.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const VarNode* op) final {
+    // The handle escapes, e.g. into an extern call.
+    rejected_.insert(op);
+  }
+
+ private:
+  std::unordered_set<const VarNode*> streamed_;
+  std::unordered_set<const VarNode*> rejected_;
+};
+
+namespace transform {
+
+Pass AnnotateNontemporalStore() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    int64_t threshold =
+        ctx->GetConfig<Integer>("tir.nontemporal_store_threshold", Integer(32 << 20))
+            .value()
+            ->value;
+    if (threshold <= 0) return f;
+    WriteOnlyStreamDetector detector;
+    detector(f->body);
+    Stmt body = f->body;
+    for (const auto& kv : f->buffer_map) {
+      const Buffer& buffer = kv.second;
+      int64_t bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+      for (const PrimExpr& dim : buffer->shape) {
+        const auto* extent = dim.as<IntImmNode>();
+        bytes = extent ? bytes * extent->value : 0;
+      }
+      if (bytes >= threshold && detector.IsWriteOnlyStream(buffer->data.get())) {
+        body = AttrStmt(buffer->data, attr::nontemporal_store, 1, body);
+      }
+    }
+    if (!body.same_as(f->body)) {
+      f.CopyOnWrite()->body = body;
+    }
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.AnnotateNontemporalStore", {});
+}
+
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.nontemporal_store_threshold", Integer);
+
+TVM_REGISTER_GLOBAL("tir.transform.AnnotateNontemporalStore")
+    .set_body_typed(AnnotateNontemporalStore);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,371 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_prefetch.cc
+ * \brief Insert prefetch intrinsics for streaming accesses in the innermost loops of CPU code.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief Size of a cache line in bytes. */
+static constexpr int kCacheLineBytes = 64;
+/*! \brief Memory latency in cycles used when the target does not set prefetch-latency. */
+static constexpr int kDefaultPrefetchLatency = 200;
+/*! \brief Upper bound of the prefetch distance in loop iterations. */
+static constexpr int64_t kMaxPrefetchDistance = 64;
+/*! \brief Upper bound of the number of prefetched streams in one loop. */
+static constexpr size_t kMaxPrefetchPerLoop = 4;
+/*! \brief Iterations assumed for a loop whose extent is not a constant. */
+static constexpr int64_t kUnknownLoopExtent = 16;
+
+/*!
+ * \brief Estimate the number of operations executed by one iteration of a loop body,
+ *  assuming that one operation retires per cycle.
+ */
+class LoopBodyCost : public StmtExprVisitor {
+ public:
+  static int64_t Estimate(const Stmt& body) {
+    LoopBodyCost cost;
+    cost(body);
+    return std::max<int64_t>(cost.cost_, 1);
+  }
+
+ private:
+  void VisitExpr(const PrimExpr& e) final {
+    if (!e.as<VarNode>() && !e.as<IntImmNode>() && !e.as<FloatImmNode>()) {
+      ++cost_;
+    }
+    StmtExprVisitor::VisitExpr(e);
+  }
+
+  void VisitStmt_(const StoreNode* op) final {
+    ++cost_;
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    int64_t outer = cost_;
+    cost_ = 0;
+    StmtExprVisitor::VisitStmt_(op);
+    const auto* extent = op->extent.as<IntImmNode>();
+    cost_ = outer + cost_ * (extent ? extent->value : kUnknownLoopExtent);
+  }
+
+  int64_t cost_{0};
+};
+
+/*!
+ * \brief Collect the loads, inner loops and locally defined vars of a loop body,
+ *  and the loads only executed under a condition.
+ */
+class LoopBodyCollector : public StmtExprVisitor {
+ public:
+  std::vector<const LoadNode*> loads;
+  std::vector<const ForNode*> loops;
+  std::unordered_set<const VarNode*> defined_vars;
+  std::unordered_set<const LoadNode*> guarded_loads;
+
+ private:
+  void VisitExpr_(const LoadNode* op) final {
+    loads.push_back(op);
+    if (guard_depth_ > 0 || !is_one(op->predicate)) guarded_loads.insert(op);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    // skip the address computation of prefetches inserted for inner loops.
+    if (op->op.same_as(builtin::prefetch())) return;
+    if (op->op.same_as(builtin::if_then_else())) {
+      this->VisitExpr(op->args[0]);
+      VisitGuarded([&]() {
+        this->VisitExpr(op->args[1]);
+        this->VisitExpr(op->args[2]);
+      });
+      return;
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const SelectNode* op) final {
+    this->VisitExpr(op->condition);
+    VisitGuarded([&]() {
+      this->VisitExpr(op->true_value);
+      this->VisitExpr(op->false_value);
+    });
+  }
+
+  void VisitStmt_(const IfThenElseNode* op) final {
+    this->VisitExpr(op->condition);
+    VisitGuarded([&]() {
+      this->VisitStmt(op->then_case);
+      if (op->else_case.defined()) this->VisitStmt(op->else_case);
+    });
+  }
+
+  template <typename F>
+  void VisitGuarded(F fvisit) {
+    ++guard_depth_;
+    fvisit();
+    --guard_depth_;
+  }
+
+  void VisitExpr_(const LetNode* op) final {
+    defined_vars.insert(op->var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    defined_vars.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    loops.push_back(op);
+    defined_vars.insert(op->loop_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  // The number of conditions the visited node is under.
+  int guard_depth_{0};
+};
+
+/*!
+ * \brief Insert prefetches for the streaming accesses of loops.
+ *
+ *  Two access patterns are handled, both prefetched `distance` iterations of
+ *  the loop ahead, where the distance covers the memory latency with the
+ *  estimated cost of the loop body:
+ *
+ *  - In an innermost loop, loads whose address advances by at least a cache
+ *    line per iteration, and loads whose address depends on another load of
+ *    the loop var (e.g. A[B[i]]).
+ *  - In a loop whose body is a single innermost loop, loads of a contiguous
+ *    row selected through another load of the outer loop var, such as the
+ *    rows gathered by an embedding lookup. The whole row is prefetched.
+ *
+ *  Unit-stride streams are left to the hardware prefetcher. The prefetch of
+ *  an indirect access loads the index unconditionally, so the indirect loads
+ *  under a condition, e.g. the guard of a non-divisible split, are skipped.
+ */
+class SoftwarePrefetchInjector : public StmtMutator {
+ public:
+  explicit SoftwarePrefetchInjector(int latency) : latency_(latency) {}
+
+  Stmt operator()(Stmt stmt) {
+    PostOrderVisit(stmt, [this](const ObjectRef& node) {
+      if (const auto* op = node.as<AllocateNode>()) {
+        local_buffers_.insert(op->buffer_var.get());
+      }
+    });
+    return this->VisitStmt(std::move(stmt));
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    if (op->kind != ForKind::kSerial && op->kind != ForKind::kParallel) {
+      return stmt;
+    }
+    LoopBodyCollector body;
+    body(op->body);
+    std::vector<Stmt> prefetches;
+    if (body.loops.empty()) {
+      prefetches = StreamPrefetches(op, body);
+    } else if (body.loops.size() == 1) {
+      prefetches = RowPrefetches(op, body.loops[0], body);
+    }
+    if (prefetches.empty()) {
+      return stmt;
+    }
+    prefetches.push_back(op->body);
+    return For(op->loop_var, op->min, op->extent, op->kind, SeqStmt::Flatten(prefetches),
+               op->thread_binding, op->annotations);
+  }
+
+ private:
+  /*! \brief The iteration `distance` iterations ahead, clamped to the last iteration. */
+  PrimExpr NextIteration(const ForNode* loop) {
+    int64_t cost = LoopBodyCost::Estimate(loop->body);
+    int64_t distance = (latency_ + cost - 1) / cost;
+    distance = std::min(distance, kMaxPrefetchDistance);
+    if (const auto* extent = loop->extent.as<IntImmNode>()) {
+      if (distance >= extent->value) return PrimExpr();
+    }
+    const Var& var = loop->loop_var;
+    return min(var + make_const(var.dtype(), distance), loop->min + loop->extent - 1);
+  }
+
+  /*! \brief The scalar address of a load, the base of a vector load. */
+  static PrimExpr ScalarIndex(const LoadNode* op) {
+    if (const auto* ramp = op->index.as<RampNode>()) return ramp->base;
+    return op->index;
+  }
+
+  /*! \brief Whether the address depends on the value of another load of var. */
+  static bool IsIndirect(const PrimExpr& index, const Var& var) {
+    bool indirect = false;
+    PostOrderVisit(index, [&](const ObjectRef& node) {
+      if (const auto* load = node.as<LoadNode>()) {
+        indirect = indirect || ExprUseVar(load->index, var);
+      }
+    });
+    return indirect;
+  }
+
+  /*! \brief Whether the access can be prefetched from the head of the loop body. */
+  bool IsPrefetchable(const LoadNode* op, const PrimExpr& index,
+                      const LoopBodyCollector& body, const VarNode* inner_var = nullptr) {
+    if (local_buffers_.count(op->buffer_var.get())) return false;
+    return !ExprUseVar(index, [&](const VarNode* v) {
+      return v != inner_var && body.defined_vars.count(v) != 0;
+    });
+  }
+
+  /*! \brief Record a prefetched stream, return false if it shares the line of another one. */
+  bool AddStream(const LoadNode* op, const PrimExpr& index,
+                 std::vector<std::pair<const LoadNode*, PrimExpr>>* streams) {
+    if (streams->size() >= kMaxPrefetchPerLoop) return false;
+    for (const auto& stream : *streams) {
+      if (!stream.first->buffer_var.same_as(op->buffer_var)) continue;
+      const auto* diff = analyzer_.Simplify(index - stream.second).as<IntImmNode>();
+      if (diff && std::abs(diff->value) * op->dtype.bytes() < kCacheLineBytes) return false;
+    }
+    streams->emplace_back(op, index);
+    return true;
+  }
+
+  static Stmt MakePrefetch(const LoadNode* op, const PrimExpr& index) {
+    PrimExpr load = Load(op->dtype.element_of(), op->buffer_var, index, const_true());
+    PrimExpr address = Call(DataType::Handle(), builtin::address_of(), {load});
+    return Evaluate(Call(DataType::Int(32), builtin::prefetch(), {address, 0, 3, 1}));
+  }
+
+  std::vector<Stmt> StreamPrefetches(const ForNode* loop, const LoopBodyCollector& body) {
+    const Var& var = loop->loop_var;
+    std::vector<std::pair<const LoadNode*, PrimExpr>> streams;
+    for (const LoadNode* op : body.loads) {
+      PrimExpr index = ScalarIndex(op);
+      if (!ExprUseVar(index, var) || !IsPrefetchable(op, index, body)) continue;
+      if (IsIndirect(index, var)) {
+        if (body.guarded_loads.count(op)) continue;
+      } else {
+        Array<PrimExpr> coeff = arith::DetectLinearEquation(index, {var});
+        if (coeff.empty()) continue;
+        const auto* stride = coeff[0].as<IntImmNode>();
+        if (!stride || std::abs(stride->value) * op->dtype.bytes() < kCacheLineBytes) continue;
+      }
+      AddStream(op, index, &streams);
+    }
+    if (streams.empty()) return {};
+    PrimExpr next = NextIteration(loop);
+    if (!next.defined()) return {};
+    std::vector<Stmt> prefetches;
+    for (const auto& stream : streams) {
+      Map<Var, PrimExpr> vmap{{var, next}};
+      prefetches.push_back(MakePrefetch(stream.first, Substitute(stream.second, vmap)));
+    }
+    return prefetches;
+  }
+
+  std::vector<Stmt> RowPrefetches(const ForNode* loop, const ForNode* inner,
+                                  const LoopBodyCollector& body) {
+    const auto* inner_extent = inner->extent.as<IntImmNode>();
+    if (!inner_extent) return {};
+    LoopBodyCollector inner_body;
+    inner_body(inner->body);
+    if (!inner_body.loops.empty()) return {};
+    const Var& var = loop->loop_var;
+    std::vector<std::pair<const LoadNode*, PrimExpr>> streams;
+    for (const LoadNode* op : body.loads) {
+      PrimExpr index = ScalarIndex(op);
+      if (!IsIndirect(index, var) || body.guarded_loads.count(op) ||
+          !IsPrefetchable(op, index, body, inner->loop_var.get())) {
+        continue;
+      }
+      Array<PrimExpr> coeff = arith::DetectLinearEquation(index, {inner->loop_var});
+      if (coeff.empty() || !is_one(coeff[0])) continue;
+      AddStream(op, index, &streams);
+    }
+    if (streams.empty()) return {};
+    PrimExpr next = NextIteration(loop);
+    if (!next.defined()) return {};
+    std::vector<Stmt> prefetches;
+    for (const auto& stream : streams) {
+      int bytes = stream.first->dtype.bytes();
+      int64_t lines = (inner_extent->value * bytes + kCacheLineBytes - 1) / kCacheLineBytes;
+      Var line(inner->loop_var->name_hint + ".prefetch", inner->loop_var.dtype());
+      PrimExpr offset = inner->min + line * make_const(line.dtype(), kCacheLineBytes / bytes);
+      Map<Var, PrimExpr> vmap{{var, next}, {inner->loop_var, offset}};
+      PrimExpr index = Substitute(stream.second, vmap);
+      prefetches.push_back(For(line, make_zero(line.dtype()), make_const(line.dtype(), lines),
+                               ForKind::kSerial, MakePrefetch(stream.first, index)));
+    }
+    return prefetches;
+  }
+
+  // The memory latency to cover in cycles.
+  int latency_;
+  // Buffers allocated by the function, assumed to stay in cache.
+  std::unordered_set<const VarNode*> local_buffers_;
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass InjectSoftwarePrefetch() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined() || target.value()->kind->name != "llvm" ||
+        !target.value()->GetAttr<Bool>("software-prefetch").value_or(Bool(false))) {
+      return f;
+    }
+    int latency = target.value()
+                      ->GetAttr<Integer>("prefetch-latency")
+                      .value_or(Integer(kDefaultPrefetchLatency))
+                      ->value;
+    auto* n = f.CopyOnWrite();
+    n->body = SoftwarePrefetchInjector(latency)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePrefetch", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSoftwarePrefetch").set_body_typed(InjectSoftwarePrefetch);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
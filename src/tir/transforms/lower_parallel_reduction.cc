@@ -0,0 +1,322 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file lower_parallel_reduction.cc
+ * \brief Lower the reductions over a parallel loop on CPU into private partial
+ *  results per chunk of the loop, combined after a barrier of the parallel group.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The combiner of a parallel reduction. */
+enum class ReduceOp { kNone, kAdd, kMul, kMin, kMax };
+
+/*!
+ * \brief Match the body of a parallel loop that only accumulates into one
+ *  element, i.e. every store is `X[i] = X[i] op value` with the same X, i and op,
+ *  i is invariant in the loop and X is not accessed otherwise.
+ */
+class ParallelReductionMatcher : public StmtExprVisitor {
+ public:
+  explicit ParallelReductionMatcher(const Var& loop_var) { local_vars_.insert(loop_var.get()); }
+
+  bool Match(const Stmt& body) {
+    this->VisitStmt(body);
+    if (failed_ || buffer_ == nullptr || escaped_.count(buffer_) ||
+        num_loads_[buffer_] != num_stores_) {
+      return false;
+    }
+    return !ExprUseVar(index_, [this](const VarNode* v) { return local_vars_.count(v) != 0; });
+  }
+
+  const VarNode* buffer() const { return buffer_; }
+  const PrimExpr& index() const { return index_; }
+  DataType dtype() const { return dtype_; }
+  ReduceOp op() const { return op_; }
+
+  void VisitStmt_(const StoreNode* op) final {
+    if (local_buffers_.count(op->buffer_var.get())) {
+      StmtExprVisitor::VisitStmt_(op);
+      return;
+    }
+    PrimExpr operand;
+    ReduceOp reduce_op = MatchCombine(op, &operand);
+    if (reduce_op == ReduceOp::kNone || !is_one(op->predicate) || op->value.dtype().lanes() != 1 ||
+        (buffer_ != nullptr && (buffer_ != op->buffer_var.get() || reduce_op != op_ ||
+                                !ExprDeepEqual()(index_, op->index)))) {
+      failed_ = true;
+      return;
+    }
+    buffer_ = op->buffer_var.get();
+    index_ = op->index;
+    dtype_ = op->value.dtype();
+    op_ = reduce_op;
+    ++num_stores_;
+    this->VisitExpr(op->value);
+    this->VisitExpr(op->index);
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    ++num_loads_[op->buffer_var.get()];
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const VarNode* op) final {
+    // A handle used as a value escapes, e.g. into an address computation.
+    escaped_.insert(op);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    if (op->kind == ForKind::kParallel) failed_ = true;
+    local_vars_.insert(op->loop_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    local_vars_.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const AllocateNode* op) final {
+    local_buffers_.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::pragma_scope_prefix + std::string("parallel_launch_point") ||
+        op->attr_key == attr::pragma_scope_prefix + std::string("parallel_barrier_when_finish")) {
+      failed_ = true;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    // Opaque calls may have side effects that cannot be split into chunks.
+    if (!op->op.as<OpNode>() || op->op.same_as(builtin::call_extern()) ||
+        op->op.same_as(builtin::tvm_call_packed())) {
+      failed_ = true;
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+ private:
+  ReduceOp MatchCombine(const StoreNode* store, PrimExpr* operand) {
+    auto is_target = [store](const PrimExpr& e) {
+      const auto* load = e.as<LoadNode>();
+      return load != nullptr && load->buffer_var.same_as(store->buffer_var) &&
+             ExprDeepEqual()(load->index, store->index) && is_one(load->predicate);
+    };
+    auto match = [&](const PrimExpr& a, const PrimExpr& b) {
+      if (is_target(a)) {
+        *operand = b;
+        return true;
+      }
+      if (is_target(b)) {
+        *operand = a;
+        return true;
+      }
+      return false;
+    };
+    if (const auto* op = store->value.as<AddNode>()) {
+      if (match(op->a, op->b)) return ReduceOp::kAdd;
+    } else if (const auto* op = store->value.as<MulNode>()) {
+      if (match(op->a, op->b)) return ReduceOp::kMul;
+    } else if (const auto* op = store->value.as<MinNode>()) {
+      if (match(op->a, op->b)) return ReduceOp::kMin;
+    } else if (const auto* op = store->value.as<MaxNode>()) {
+      if (match(op->a, op->b)) return ReduceOp::kMax;
+    }
+    return ReduceOp::kNone;
+  }
+
+  const VarNode* buffer_{nullptr};
+  PrimExpr index_;
+  DataType dtype_;
+  ReduceOp op_{ReduceOp::kNone};
+  int num_stores_{0};
+  std::unordered_map<const VarNode*, int> num_loads_;
+  std::unordered_set<const VarNode*> escaped_;
+  bool failed_{false};
+  std::unordered_set<const VarNode*> local_vars_;
+  std::unordered_set<const VarNode*> local_buffers_;
+};
+
+/*! \brief Redirect the accumulation into the target element to a private accumulator. */
+class AccumulatorRedirector : public StmtExprMutator {
+ public:
+  AccumulatorRedirector(const VarNode* buffer, Var acc) : buffer_(buffer), acc_(std::move(acc)) {}
+
+  Stmt VisitStmt_(const StoreNode* op) final {
+    if (op->buffer_var.get() != buffer_) return StmtExprMutator::VisitStmt_(op);
+    return Store(acc_, this->VisitExpr(op->value), 0, const_true());
+  }
+
+  PrimExpr VisitExpr_(const LoadNode* op) final {
+    if (op->buffer_var.get() != buffer_) return StmtExprMutator::VisitExpr_(op);
+    return Load(op->dtype, acc_, 0, const_true());
+  }
+
+ private:
+  const VarNode* buffer_;
+  Var acc_;
+};
+
+class ParallelReductionLowerer : public StmtExprMutator {
+ public:
+  explicit ParallelReductionLowerer(int64_t max_chunks) : max_chunks_(max_chunks) {}
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::pragma_scope_prefix + std::string("parallel_launch_point")) {
+      // Already in a parallel launch, the barrier of a nested reduction would deadlock.
+      return GetRef<Stmt>(op);
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    if (op->kind != ForKind::kParallel) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    ParallelReductionMatcher matcher(op->loop_var);
+    if (!is_zero(op->min) || !matcher.Match(op->body)) {
+      // Other parallel loops are lowered by the codegen, do not look into them.
+      return GetRef<Stmt>(op);
+    }
+    return LowerReduction(op, matcher);
+  }
+
+ private:
+  Stmt LowerReduction(const ForNode* op, const ParallelReductionMatcher& matcher) {
+    DataType t = op->extent.dtype();
+    DataType dtype = matcher.dtype();
+    int64_t num_chunks = max_chunks_;
+    if (const auto* extent = op->extent.as<IntImmNode>()) {
+      num_chunks = std::max<int64_t>(1, std::min(num_chunks, extent->value));
+    }
+    PrimExpr k = make_const(t, num_chunks);
+    PrimExpr chunk_size = floordiv(op->extent + k - make_const(t, 1), k);
+
+    Var partial("partial", PointerType(PrimType(dtype)));
+    Var acc("acc", PointerType(PrimType(dtype)));
+    Var chunk(op->loop_var->name_hint + ".chunk", t);
+    Var inner(op->loop_var->name_hint + ".inner", t);
+    Var task(op->loop_var->name_hint + ".combine", t);
+    Var c(op->loop_var->name_hint + ".c", t);
+
+    // Each chunk accumulates into a private accumulator, then publishes it.
+    PrimExpr begin = chunk * chunk_size;
+    PrimExpr chunk_extent = max(min(chunk_size, op->extent - begin), make_zero(t));
+    Map<Var, PrimExpr> vmap{{op->loop_var, begin + inner}};
+    Stmt body = Substitute(AccumulatorRedirector(matcher.buffer(), acc)(op->body), vmap);
+    body = For(inner, make_zero(t), chunk_extent, ForKind::kSerial, body);
+    body = SeqStmt({Store(acc, Identity(matcher.op(), dtype), 0, const_true()), body,
+                    Store(partial, Load(dtype, acc, 0, const_true()), chunk, const_true())});
+    body = Allocate(acc, dtype, {1}, const_true(), body);
+    body = AttrStmt(acc, attr::storage_scope, StringImm("local"), body);
+    Stmt reduce = For(chunk, make_zero(t), k, ForKind::kParallel, body);
+    reduce = AttrStmt(make_zero(DataType::Int(32)),
+                      attr::pragma_scope_prefix + std::string("parallel_barrier_when_finish"), 1,
+                      reduce);
+
+    // After the barrier, the task that owns the single iteration combines the partials.
+    Var target = GetRef<Var>(matcher.buffer());
+    PrimExpr current = Load(dtype, target, matcher.index(), const_true());
+    PrimExpr value = Combine(matcher.op(), current, Load(dtype, partial, c, const_true()));
+    Stmt combine = For(c, make_zero(t), k, ForKind::kSerial,
+                       Store(target, value, matcher.index(), const_true()));
+    combine = For(task, make_zero(t), make_const(t, 1), ForKind::kParallel, combine);
+
+    Stmt launch = AttrStmt(make_zero(DataType::Int(32)),
+                           attr::pragma_scope_prefix + std::string("parallel_launch_point"), 1,
+                           SeqStmt({reduce, combine}));
+    Stmt ret = Allocate(partial, dtype, {k}, const_true(), launch);
+    return AttrStmt(partial, attr::storage_scope, StringImm("global"), ret);
+  }
+
+  static PrimExpr Identity(ReduceOp op, DataType dtype) {
+    switch (op) {
+      case ReduceOp::kAdd:
+        return make_zero(dtype);
+      case ReduceOp::kMul:
+        return make_const(dtype, 1);
+      case ReduceOp::kMin:
+        return max_value(dtype);
+      case ReduceOp::kMax:
+        return min_value(dtype);
+      default:
+        LOG(FATAL) << "Unknown reduction";
+        return PrimExpr();
+    }
+  }
+
+  static PrimExpr Combine(ReduceOp op, PrimExpr a, PrimExpr b) {
+    switch (op) {
+      case ReduceOp::kAdd:
+        return a + b;
+      case ReduceOp::kMul:
+        return a * b;
+      case ReduceOp::kMin:
+        return min(a, b);
+      case ReduceOp::kMax:
+        return max(a, b);
+      default:
+        LOG(FATAL) << "Unknown reduction";
+        return PrimExpr();
+    }
+  }
+
+  int64_t max_chunks_;
+};
+
+namespace transform {
+
+Pass LowerParallelReduction() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    int64_t max_chunks =
+        ctx->GetConfig<Integer>("tir.parallel_reduce_chunks", Integer(256)).value()->value;
+    if (max_chunks <= 0) return f;
+    auto* n = f.CopyOnWrite();
+    n->body = ParallelReductionLowerer(max_chunks)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.LowerParallelReduction", {});
+}
+
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.parallel_reduce_chunks", Integer);
+
+TVM_REGISTER_GLOBAL("tir.transform.LowerParallelReduction")
+    .set_body_typed(LowerParallelReduction);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
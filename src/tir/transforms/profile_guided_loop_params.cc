@@ -0,0 +1,275 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file profile_guided_loop_params.cc
+ * \brief Pick the loop unrolling and vectorization parameters of the hot
+ *  kernels of a profile by measuring a few variants on the host.
+ */
+#include <dmlc/json.h>
+#include <tvm/driver/driver_api.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+struct ProfileGuidedLoopParamsConfigNode
+    : public tvm::AttrsNode<ProfileGuidedLoopParamsConfigNode> {
+  String profile;
+  double hot_fraction;
+  String target;
+  int number;
+  int repeat;
+
+  TVM_DECLARE_ATTRS(ProfileGuidedLoopParamsConfigNode,
+                    "tir.transform.ProfileGuidedLoopParamsConfig") {
+    TVM_ATTR_FIELD(profile)
+        .describe("Path of the kernel profile, the pass does nothing when it is empty")
+        .set_default("");
+    TVM_ATTR_FIELD(hot_fraction)
+        .describe("Minimum fraction of the profiled time spent in a kernel to tune it")
+        .set_default(0.05);
+    TVM_ATTR_FIELD(target)
+        .describe("The host target the variants are built and measured for")
+        .set_default("llvm");
+    TVM_ATTR_FIELD(number)
+        .describe("Number of calls of a variant in one measurement")
+        .set_default(10);
+    TVM_ATTR_FIELD(repeat).describe("Number of measurements of a variant").set_default(3);
+  }
+};
+
+class ProfileGuidedLoopParamsConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(ProfileGuidedLoopParamsConfig, Attrs,
+                                            ProfileGuidedLoopParamsConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(ProfileGuidedLoopParamsConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.ProfileGuidedLoopParams", ProfileGuidedLoopParamsConfig);
+
+/*! \brief A set of parameters tried on a hot kernel. */
+struct LoopParamsVariant {
+  int auto_max_step;
+  int auto_max_extent;
+  bool explicit_unroll;
+  bool predicated_tail;
+
+  Map<String, ObjectRef> AsMap() const {
+    return {{"auto_max_step", Integer(auto_max_step)},
+            {"auto_max_extent", Integer(auto_max_extent)},
+            {"explicit_unroll", Bool(explicit_unroll)},
+            {"predicated_tail", Bool(predicated_tail)}};
+  }
+};
+
+// The baseline, the parameters of the PassContext, is always measured first.
+static const LoopParamsVariant kLoopParamsVariants[] = {
+    {16, 0, true, false},  {64, 0, true, false},  {16, 0, true, true},
+    {64, 0, true, true},   {64, 16, false, false},
+};
+
+/*! \brief Read a profile, a JSON object mapping kernel names to their total time. */
+std::map<std::string, double> LoadKernelProfile(const std::string& path) {
+  std::map<std::string, double> profile;
+  std::ifstream is(path);
+  if (!is.good()) {
+    LOG(WARNING) << "ProfileGuidedLoopParams: cannot open the profile " << path;
+    return profile;
+  }
+  dmlc::JSONReader reader(&is);
+  reader.Read(&profile);
+  return profile;
+}
+
+/*! \brief Fill a tensor with ones, which is a safe input for division and indexing. */
+void FillOnes(runtime::NDArray arr) {
+  int64_t size = 1;
+  for (int i = 0; i < arr->ndim; ++i) size *= arr->shape[i];
+  DataType dtype(arr->dtype);
+  if (dtype.is_float() && dtype.bits() == 32) {
+    std::fill_n(static_cast<float*>(arr->data), size, 1.0f);
+  } else if (dtype.is_float() && dtype.bits() == 64) {
+    std::fill_n(static_cast<double*>(arr->data), size, 1.0);
+  } else if ((dtype.is_int() || dtype.is_uint()) && dtype.bits() == 8) {
+    std::fill_n(static_cast<int8_t*>(arr->data), size, 1);
+  } else if ((dtype.is_int() || dtype.is_uint()) && dtype.bits() == 16) {
+    std::fill_n(static_cast<int16_t*>(arr->data), size, 1);
+  } else if ((dtype.is_int() || dtype.is_uint()) && dtype.bits() == 32) {
+    std::fill_n(static_cast<int32_t*>(arr->data), size, 1);
+  } else if ((dtype.is_int() || dtype.is_uint()) && dtype.bits() == 64) {
+    std::fill_n(static_cast<int64_t*>(arr->data), size, 1);
+  } else {
+    memset(arr->data, 0, size * dtype.bytes() * dtype.lanes());
+  }
+}
+
+/*! \brief Builds and measures the variants of a kernel on the host. */
+class LoopParamsTuner {
+ public:
+  explicit LoopParamsTuner(const ProfileGuidedLoopParamsConfig& cfg)
+      : target_(cfg->target), number_(cfg->number), repeat_(cfg->repeat) {}
+
+  /*!
+   * \brief Pick the parameters of a kernel.
+   * \return The annotated function, or the input one when the baseline is the fastest.
+   */
+  PrimFunc Tune(PrimFunc f) {
+    bool on_device = false;
+    PostOrderVisit(f->body, [&on_device](const ObjectRef& n) {
+      const auto* op = n.as<AttrStmtNode>();
+      if (op && op->attr_key == attr::thread_extent) on_device = true;
+    });
+    // Only the kernels that run on the host can be measured.
+    if (on_device) return f;
+    std::vector<runtime::NDArray> args;
+    Device dev{kDLCPU, 0};
+    for (const Var& param : f->params) {
+      auto it = f->buffer_map.find(param);
+      // Scalar arguments and symbolic shapes have no representative input.
+      if (it == f->buffer_map.end()) return f;
+      std::vector<int64_t> shape;
+      for (const PrimExpr& dim : (*it).second->shape) {
+        const auto* extent = dim.as<IntImmNode>();
+        if (extent == nullptr) return f;
+        shape.push_back(extent->value);
+      }
+      args.push_back(runtime::NDArray::Empty(shape, (*it).second->dtype, dev));
+      FillOnes(args.back());
+    }
+    double best = Measure(f, args);
+    Optional<Map<String, ObjectRef>> best_params;
+    for (const auto& variant : kLoopParamsVariants) {
+      Map<String, ObjectRef> params = variant.AsMap();
+      double cost = Measure(WithAttr(f, attr::kLoopParams, params), args);
+      if (cost < best) {
+        best = cost;
+        best_params = params;
+      }
+    }
+    if (!best_params.defined()) return f;
+    return WithAttr(std::move(f), attr::kLoopParams, best_params.value());
+  }
+
+ private:
+  /*! \brief Lower the rest of phase 2, build and return the median time of a call in seconds. */
+  double Measure(const PrimFunc& f, const std::vector<runtime::NDArray>& args) {
+    try {
+      return MeasureOrThrow(f, args);
+    } catch (const Error& e) {
+      DLOG(INFO) << "ProfileGuidedLoopParams: failed to measure a variant: " << e.what();
+      return std::numeric_limits<double>::infinity();
+    }
+  }
+
+  double MeasureOrThrow(const PrimFunc& f, const std::vector<runtime::NDArray>& args) {
+    String symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol).value();
+    IRModule mod({{GlobalVar(symbol), f}});
+    bool disable_vectorize = transform::PassContext::Current()
+                                 ->GetConfig<Bool>("tir.disable_vectorize", Bool(false))
+                                 .value();
+    mod = transform::Sequential({transform::VectorizeLoop(!disable_vectorize),
+                                 transform::InjectVirtualThread(), transform::InjectDoubleBuffer(),
+                                 transform::StorageRewrite(), transform::UnrollLoop(),
+                                 transform::Simplify(), transform::RemoveNoOp()})(mod);
+    runtime::Module rt_mod = build(mod, target_, target_);
+    runtime::PackedFunc pf = rt_mod.GetFunction(symbol);
+    ICHECK(pf != nullptr) << "ProfileGuidedLoopParams: cannot find " << symbol;
+    std::vector<TVMValue> values(args.size());
+    std::vector<int> type_codes(args.size());
+    runtime::TVMArgsSetter setter(values.data(), type_codes.data());
+    for (size_t i = 0; i < args.size(); ++i) {
+      setter(i, args[i]);
+    }
+    runtime::TVMRetValue rv;
+    // warm up, which also triggers the JIT.
+    pf.CallPacked(runtime::TVMArgs(values.data(), type_codes.data(), args.size()), &rv);
+    std::vector<double> costs;
+    for (int r = 0; r < repeat_; ++r) {
+      auto start = std::chrono::high_resolution_clock::now();
+      for (int i = 0; i < number_; ++i) {
+        pf.CallPacked(runtime::TVMArgs(values.data(), type_codes.data(), args.size()), &rv);
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+      costs.push_back(std::chrono::duration<double>(end - start).count() / number_);
+    }
+    std::sort(costs.begin(), costs.end());
+    return costs[costs.size() / 2];
+  }
+
+  /*! \brief The target of the measured modules. */
+  Target target_;
+  /*! \brief Number of calls in one measurement. */
+  int number_;
+  /*! \brief Number of measurements. */
+  int repeat_;
+};
+
+namespace transform {
+
+Pass ProfileGuidedLoopParams() {
+  auto pass_func = [=](IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<ProfileGuidedLoopParamsConfig>("tir.ProfileGuidedLoopParams");
+    if (!cfg.defined() || cfg.value()->profile.empty()) return m;
+    std::map<std::string, double> profile = LoadKernelProfile(cfg.value()->profile);
+    double total = 0;
+    for (const auto& kv : profile) total += kv.second;
+    if (total <= 0) return m;
+    LoopParamsTuner tuner(cfg.value());
+    Map<GlobalVar, PrimFunc> updates;
+    for (const auto& kv : m->functions) {
+      auto f = kv.second.as<PrimFuncNode>();
+      if (f == nullptr || f->GetAttr<Map<String, ObjectRef>>(attr::kLoopParams).defined()) {
+        continue;
+      }
+      auto symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
+      if (!symbol.defined()) continue;
+      auto it = profile.find(symbol.value());
+      if (it == profile.end() || it->second < cfg.value()->hot_fraction * total) continue;
+      updates.Set(kv.first, tuner.Tune(GetRef<PrimFunc>(f)));
+    }
+    auto* n = m.CopyOnWrite();
+    for (const auto& kv : updates) {
+      n->Update(kv.first, kv.second);
+    }
+    return m;
+  };
+  return tvm::transform::CreateModulePass(pass_func, 0, "tir.ProfileGuidedLoopParams", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.ProfileGuidedLoopParams")
+    .set_body_typed(ProfileGuidedLoopParams);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
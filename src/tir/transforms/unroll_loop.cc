@@ -227,6 +227,19 @@ Pass UnrollLoop() {
     if (!cfg.defined()) {
       cfg = AttrsWithDefaultValues<UnrollLoopConfig>();
     }
+    if (auto params = f->GetAttr<Map<String, ObjectRef>>(attr::kLoopParams)) {
+      auto node = make_object<UnrollLoopConfigNode>(*cfg.value().get());
+      for (const auto& kv : params.value()) {
+        if (kv.first == "auto_max_step") {
+          node->auto_max_step = Downcast<Integer>(kv.second)->value;
+        } else if (kv.first == "auto_max_extent") {
+          node->auto_max_extent = Downcast<Integer>(kv.second)->value;
+        } else if (kv.first == "explicit_unroll") {
+          node->explicit_unroll = Downcast<Bool>(kv.second)->value;
+        }
+      }
+      cfg = UnrollLoopConfig(node);
+    }
     n->body = UnrollLoop(std::move(f->body), cfg.value());
     return f;
   };
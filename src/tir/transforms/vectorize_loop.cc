@@ -100,7 +100,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  Vectorizer(Var var, int var_lanes) : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool predicated_tail = false)
+      : var_(var), var_lanes_(var_lanes), predicated_tail_(predicated_tail) {
     ramp_ = Ramp(0, 1, var_lanes);
   }
 
@@ -300,6 +301,12 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr VisitExpr_(const LoadNode* op) final {
     PrimExpr index = this->VisitExpr(op->index);
     PrimExpr pred = this->VisitExpr(op->predicate);
+    if (mask_.defined()) {
+      int lanes = std::max(index.dtype().lanes(), pred.dtype().lanes());
+      if (!MaskPredicate(lanes, &pred)) return GetRef<PrimExpr>(op);
+      return Load(op->dtype.with_lanes(mask_.dtype().lanes()), op->buffer_var,
+                  BroadcastTo(index, mask_.dtype().lanes()), pred);
+    }
     if (index.same_as(op->index) && pred.same_as(op->predicate)) {
       return GetRef<PrimExpr>(op);
     } else {
@@ -341,6 +348,13 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     PrimExpr value = this->VisitExpr(op->value);
     PrimExpr index = this->VisitExpr(op->index);
     PrimExpr pred = this->VisitExpr(op->predicate);
+    if (mask_.defined()) {
+      int lanes = std::max(value.dtype().lanes(), index.dtype().lanes());
+      lanes = std::max(lanes, pred.dtype().lanes());
+      if (!MaskPredicate(lanes, &pred)) return GetRef<Stmt>(op);
+      lanes = mask_.dtype().lanes();
+      return Store(op->buffer_var, BroadcastTo(value, lanes), BroadcastTo(index, lanes), pred);
+    }
     if (value.same_as(op->value) && index.same_as(op->index)) {
       return GetRef<Stmt>(op);
     } else {
@@ -374,6 +388,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     ICHECK(!op->condition.dtype().is_vector());
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
+      if (predicated_tail_ && !op->else_case.defined()) {
+        return MaskedThenCase(op, condition);
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -437,8 +454,20 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     return Allocate(op->buffer_var, op->dtype, extents, condition, body);
   }
 
+  // Evaluate
+  Stmt VisitStmt_(const EvaluateNode* op) final {
+    // An evaluated call may have side effects that cannot be masked.
+    if (mask_.defined()) {
+      mask_failed_ = true;
+      return GetRef<Stmt>(op);
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
   // scalarize the statment
   Stmt Scalarize(Stmt stmt) {
+    // A scalarized statement inside a masked region would lose its guard.
+    if (mask_.defined()) mask_failed_ = true;
     Var idx(var_->name_hint + ".s", var_->dtype);
     Map<Var, PrimExpr> values{{var_, idx}};
     stmt = Substitute(stmt, values);
@@ -451,6 +480,42 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   }
 
  private:
+  /*!
+   * \brief Vectorize the then case of a guard whose condition depends on the
+   *  vectorized var by turning the condition into the predicate of every load
+   *  and store in it, falls back to scalarization if that is not possible.
+   */
+  Stmt MaskedThenCase(const IfThenElseNode* op, PrimExpr condition) {
+    PrimExpr outer_mask = mask_;
+    bool outer_failed = mask_failed_;
+    if (outer_mask.defined() && outer_mask.dtype().lanes() != condition.dtype().lanes()) {
+      return Scalarize(GetRef<Stmt>(op));
+    }
+    mask_ = outer_mask.defined() ? outer_mask && condition : condition;
+    mask_failed_ = false;
+    Stmt then_case = this->VisitStmt(op->then_case);
+    bool failed = mask_failed_;
+    mask_ = outer_mask;
+    mask_failed_ = outer_failed;
+    if (failed) {
+      return Scalarize(GetRef<Stmt>(op));
+    }
+    return then_case;
+  }
+  // Combine the predicate of an access with `lanes` lanes with the current mask.
+  bool MaskPredicate(int lanes, PrimExpr* pred) {
+    int mask_lanes = mask_.dtype().lanes();
+    if (lanes != 1 && lanes != mask_lanes) {
+      mask_failed_ = true;
+      return false;
+    }
+    if (is_one(*pred)) {
+      *pred = mask_;
+    } else {
+      *pred = BroadcastTo(*pred, mask_lanes) && mask_;
+    }
+    return true;
+  }
   // analyzer
   arith::Analyzer analyzer_;
   // deep equal
@@ -463,6 +528,12 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr ramp_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
+  // whether guards on the vectorized var become predicated accesses.
+  bool predicated_tail_;
+  // the predicate of the accesses in the current guarded region.
+  PrimExpr mask_;
+  // flag to mark that the current guarded region cannot be predicated.
+  bool mask_failed_{false};
   // Let binding
   std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> let_binding_;
   // vectorizable property
@@ -530,6 +601,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(bool predicated_tail = false) : predicated_tail_(predicated_tail) {}
+
   Stmt VisitStmt_(const ForNode* op) final {
     if (op->kind == ForKind::kVectorized) {
       ICHECK(is_zero(op->min));
@@ -537,11 +610,15 @@ class LoopVectorizer : public StmtMutator {
       if (!extent_as_int || extent_as_int->value < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value))(op->body);
+      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value),
+                        predicated_tail_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  bool predicated_tail_;
 };
 
 Stmt VectorizeLoop(Stmt stmt) { return LoopVectorizer()(std::move(stmt)); }
@@ -563,12 +640,21 @@ Stmt SkipVectorize(Stmt stmt) { return VectorizeSkipper()(std::move(stmt)); }
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.vectorize_predicated_tail", Bool);
+
 // TODO(tvm-team): Make it as a target property.
 Pass VectorizeLoop(bool enable_vectorize) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = LoopVectorizer()(std::move(n->body));
+      bool predicated_tail =
+          ctx->GetConfig<Bool>("tir.vectorize_predicated_tail", Bool(false)).value();
+      if (auto params = f->GetAttr<Map<String, ObjectRef>>(attr::kLoopParams)) {
+        if (params.value().count("predicated_tail")) {
+          predicated_tail = Downcast<Bool>(params.value()["predicated_tail"])->value;
+        }
+      }
+      n->body = LoopVectorizer(predicated_tail)(std::move(n->body));
     } else {
       n->body = VectorizeSkipper()(std::move(n->body));
     }
@@ -18,6 +18,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <tvm/ir/transform.h>
 #include <tvm/node/structural_equal.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr.h>
@@ -42,6 +43,37 @@ TEST(Relay, SelfReference) {
   ICHECK(tvm::StructuralEqual()(type_fx->checked_type(), expected));
 }
 
+TEST(Relay, IncrementalInferTypeStaleSignature) {
+  using namespace tvm;
+  auto add_op = relay::Op::Get("add");
+  auto old_type = relay::TensorType({4}, DataType::Float(32));
+  auto x = relay::Var("x", old_type);
+  auto f = relay::Function(tvm::Array<relay::Var>{x}, relay::Call(add_op, {x, x}), relay::Type(),
+                           {});
+  auto mod = IRModule::FromExpr(f);
+
+  auto pass_ctx = transform::PassContext::Create();
+  pass_ctx->config.Set("relay.InferType.incremental", Bool(true));
+  With<transform::PassContext> scope(pass_ctx);
+  mod = relay::transform::InferType()(mod);
+  auto main = mod->GetGlobalVar("main");
+  auto typed = Downcast<relay::Function>(mod->Lookup(main));
+
+  // A pass changes the signature, but copies the checked types of the nodes it replaces.
+  auto new_type = relay::TensorType({8}, DataType::Float(32));
+  auto y = relay::Var("y", new_type);
+  y->checked_type_ = typed->params[0]->checked_type();
+  auto body = relay::Call(add_op, {y, y});
+  body->checked_type_ = typed->body->checked_type();
+  auto g = relay::Function(tvm::Array<relay::Var>{y}, body, relay::Type(), {});
+  g->checked_type_ = typed->checked_type();
+  mod->Update(main, g);
+  mod = relay::transform::InferType()(mod);
+
+  auto expected = relay::FuncType(tvm::Array<relay::Type>{new_type}, new_type, {}, {});
+  ICHECK(tvm::StructuralEqual()(mod->Lookup("main")->checked_type(), expected));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   testing::FLAGS_gtest_death_test_style = "threadsafe";
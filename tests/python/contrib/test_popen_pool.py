@@ -18,7 +18,7 @@
 import pytest
 import time
 from tvm.contrib.popen_pool import PopenWorker, PopenPoolExecutor
-from tvm.testing import identity_after, terminate_self
+from tvm.testing import identity_after, terminate_self, initializer, after_initializer
 
 
 def test_popen_worker():
@@ -66,6 +66,24 @@ def test_popen_pool_executor():
         assert val.value == idx
 
 
+def test_popen_initializer():
+    proc = PopenWorker(initializer=initializer, initargs=("xyz",))
+    proc.send(after_initializer)
+    assert proc.recv() == "xyz"
+
+    # the process restarted after a timeout is initialized again
+    with pytest.raises(TimeoutError):
+        proc.send(identity_after, [1, 100], timeout=0.01)
+        proc.recv()
+    proc.send(after_initializer)
+    assert proc.recv() == "xyz"
+
+    pool = PopenPoolExecutor(max_workers=2, timeout=None, initializer=initializer, initargs=(1,))
+    for val in pool.map_with_error_catching(lambda _: after_initializer(), range(10)):
+        assert val.value == 1
+
+
 if __name__ == "__main__":
     test_popen_worker()
     test_popen_pool_executor()
+    test_popen_initializer()
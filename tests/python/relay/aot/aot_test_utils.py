@@ -262,6 +262,7 @@ def compile_and_run(
     workspace_byte_alignment=8,
     mod_name=None,
     enable_op_fusion=True,
+    required_pass=None,
 ):
     """
     This method verifies the generated source
@@ -277,7 +278,7 @@ def compile_and_run(
     if not enable_op_fusion:
         config["relay.FuseOps.max_depth"] = 1
 
-    with tvm.transform.PassContext(opt_level=3, config=config):
+    with tvm.transform.PassContext(opt_level=3, config=config, required_pass=required_pass):
         lib = tvm.relay.build(mod, target, target_host=target, params=params, mod_name=mod_name)
 
     tmp_path = utils.tempdir()
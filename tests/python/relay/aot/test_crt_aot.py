@@ -513,5 +513,37 @@ def test_transpose(target_options):
     compile_and_run(func, input_list, output_list, target_options, True, enable_op_fusion=False)
 
 
+@pytest.mark.parametrize("target_options", ["--unpacked-api=0", "--unpacked-api=1"])
+def test_reorder_for_memory(target_options):
+    """Test the let bindings of ReorderForMemory, whose output is a let-bound variable."""
+
+    # The second input of the add needs more memory to compute and is run first.
+    x = relay.var("x", shape=(1, 64), dtype="float32")
+    a = relay.tile(x, (8, 1))
+    b = relay.sum(relay.broadcast_to(x, (32, 64, 4)), axis=2)
+    b = relay.sum(b, axis=0, keepdims=True)
+    func = relay.Function([x], relay.add(a, b))
+
+    mod = transform.InferType()(tvm.IRModule.from_expr(func))
+    body = transform.ReorderForMemory()(mod)["main"].body
+    assert isinstance(body, relay.Let)
+    while isinstance(body, relay.Let):
+        body = body.body
+    assert isinstance(body, relay.Var)
+
+    inputs = {"x": np.random.uniform(size=(1, 64)).astype("float32")}
+    output_list = generate_ref_data(func, inputs)
+    input_list = [inputs["x"]]
+    compile_and_run(
+        func,
+        input_list,
+        output_list,
+        target_options,
+        True,
+        enable_op_fusion=False,
+        required_pass=["ReorderForMemory"],
+    )
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
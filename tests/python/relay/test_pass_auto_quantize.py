@@ -22,6 +22,8 @@ from tvm import te
 from tvm import relay
 from tvm.relay import testing
 from tvm.relay.expr import Call
+from tvm.relay.quantize import _calibrate
+from tvm.relay.quantize.kl_divergence import _find_scale_by_kl
 from tvm.topi.utils import get_const_tuple
 
 
@@ -136,6 +138,61 @@ def test_calibrate_percentile():
         relay.quantize.quantize(mod, params, dataset)
 
 
+def annotate_for_calibration(mod, params):
+    with relay.quantize.qconfig(calibrate_mode="kl_divergence"):
+        annotated = relay.quantize.prerequisite_optimize(mod, params)
+        with tvm.transform.PassContext(opt_level=3, required_pass=["QuantizeAnnotate"]):
+            with relay.quantize.quantize_context():
+                passes = [relay.quantize.partition(), relay.quantize.annotate()]
+                return tvm.transform.Sequential(passes)(annotated)
+
+
+def test_calibrate_streaming():
+    mod, params = testing.synthetic.get_workload()
+    dataset = get_calibration_dataset(mod, "data")
+    annotated = annotate_for_calibration(mod, params)
+
+    samples = next(_calibrate.collect_stats(annotated, dataset))
+    kl_scales = _calibrate.stream_stats(annotated, dataset, "kl_divergence")
+    percentile_scales = _calibrate.stream_stats(annotated, dataset, "percentile")
+    assert len(kl_scales) == len(samples)
+    for arr, kl_scale, percentile_scale in zip(samples, kl_scales, percentile_scales):
+        np.testing.assert_allclose(kl_scale, _find_scale_by_kl(arr), rtol=1e-2)
+        # The percentile is found to the precision of a bin of the histogram.
+        bin_width = 2 * np.abs(arr).max() / 8001
+        assert abs(percentile_scale - _calibrate._find_scale_by_percentile(arr)) <= bin_width
+
+    with relay.quantize.qconfig(calibrate_mode="kl_divergence", calibrate_streaming=True):
+        relay.quantize.quantize(mod, params, dataset)
+
+
+def test_calibrate_streaming_generator():
+    mod, params = testing.synthetic.get_workload()
+    dataset = get_calibration_dataset(mod, "data")
+    annotated = annotate_for_calibration(mod, params)
+    scales = _calibrate.stream_stats(annotated, dataset, "kl_divergence")
+
+    # a generator is only iterated once, it is kept for the histogram pass
+    generator = (batch for batch in dataset)
+    assert _calibrate.stream_stats(annotated, generator, "kl_divergence") == scales
+    # a callable returns a new iterable for each pass
+    callable_dataset = lambda: (batch for batch in dataset)
+    assert _calibrate.stream_stats(annotated, callable_dataset, "kl_divergence") == scales
+
+    def one_pass():
+        if one_pass.called:
+            return []
+        one_pass.called = True
+        return dataset
+
+    one_pass.called = False
+    with pytest.raises(ValueError):
+        _calibrate.stream_stats(annotated, one_pass, "kl_divergence")
+
+    with relay.quantize.qconfig(calibrate_mode="kl_divergence", calibrate_streaming=True):
+        relay.quantize.quantize(mod, params, (batch for batch in dataset))
+
+
 ####################################
 # Quant/Dequant Partitioning Tests #
 ####################################
@@ -410,6 +467,8 @@ if __name__ == "__main__":
     test_calibrate_target(True)
     test_calibrate_memory_bound()
     test_calibrate_percentile()
+    test_calibrate_streaming()
+    test_calibrate_streaming_generator()
 
     test_add_partition()
     test_conv2d_partition()
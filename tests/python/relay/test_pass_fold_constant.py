@@ -298,6 +298,42 @@ def test_fold_dropout():
     assert tvm.ir.structural_equal(run_infer_type(before_mod["main"]), after_mod["main"])
 
 
+def test_fold_batch():
+    t = relay.TensorType([4, 8], "float32")
+
+    def before():
+        x = relay.var("x", t)
+        w = relay.const(np.random.uniform(size=(8, 4)).astype("float32"))
+        # a chain of weight-side transforms, shared by two consumers
+        wt = relay.multiply(relay.transpose(w), relay.const(2.0))
+        parts = relay.split(relay.add(wt, relay.const(1.0)), 2, axis=1)
+        y = relay.add(x, wt)
+        y = relay.concatenate([relay.multiply(y, wt), parts[0], parts[1]], axis=1)
+        # a let binding of a constant subgraph, foldable once the batch is evaluated
+        v = relay.var("v")
+        c = relay.Let(v, relay.sum(wt), relay.add(relay.sum(y), relay.add(v, relay.const(1.0))))
+        return relay.Function([x], c)
+
+    zz = run_opt_pass(before(), transform.FoldConstant())
+    with tvm.transform.PassContext(config={"relay.FoldConstant": {"batch": True}}):
+        batched = run_opt_pass(before(), transform.FoldConstant())
+    tvm.ir.assert_structural_equal(batched, zz)
+
+    # only the calls that depend on x remain
+    ops = []
+    relay.analysis.post_order_visit(
+        batched,
+        lambda n: ops.append(n.op.name) if isinstance(n, relay.Call) else None,
+    )
+    assert sorted(ops) == sorted(["add", "multiply", "concatenate", "sum", "add"])
+
+    # a small batch size evaluates the subgraphs in several batches
+    config = {"relay.FoldConstant": {"batch": True, "batch_size": 1}}
+    with tvm.transform.PassContext(config=config):
+        batched = run_opt_pass(before(), transform.FoldConstant())
+    tvm.ir.assert_structural_equal(batched, zz)
+
+
 if __name__ == "__main__":
     test_fold_const()
     test_fold_let()
@@ -307,3 +343,4 @@ if __name__ == "__main__":
     test_fold_batch_norm()
     test_fold_ndarray_size()
     test_fold_dropout()
+    test_fold_batch()
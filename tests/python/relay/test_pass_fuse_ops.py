@@ -784,6 +784,60 @@ def test_fuse_dynamic_squeeze_slice_take():
     assert np.allclose(result.numpy(), np_result)
 
 
+def _primitive_functions(expr):
+    funcs = []
+
+    def visit(node):
+        if isinstance(node, relay.Function) and node.attrs and "Primitive" in node.attrs:
+            funcs.append(node)
+
+    relay.analysis.post_order_visit(expr, visit)
+    return funcs
+
+
+def _fuse_with_objective(func, objective, **fields):
+    config = {"relay.FuseOps.cost_model": dict(objective=objective, **fields)}
+    with tvm.transform.PassContext(opt_level=2, config=config):
+        return run_opt_pass(func, transform.FuseOps())
+
+
+def test_fuse_cost_chained_reductions():
+    x = relay.var("x", shape=(4, 64))
+    m = relay.max(x, axis=1, keepdims=True)
+    e = relay.exp(relay.subtract(x, m))
+    out = relay.divide(e, relay.sum(e, axis=1, keepdims=True))
+    func = relay.Function([x], out)
+
+    assert len(_primitive_functions(_fuse_with_objective(func, "pattern"))) == 4
+    assert len(_primitive_functions(_fuse_with_objective(func, "cost"))) == 4
+    fused = _fuse_with_objective(func, "cost", fuse_reductions=True)
+    assert len(_primitive_functions(fused)) == 1
+    assert int(_primitive_functions(fused)[0].attrs["relay.chained_reductions"]) == 1
+
+    data = np.random.uniform(-1, 1, size=(4, 64)).astype("float32")
+    ref = np.exp(data - data.max(axis=1, keepdims=True))
+    ref = ref / ref.sum(axis=1, keepdims=True)
+    config = {"relay.FuseOps.cost_model": {"objective": "cost", "fuse_reductions": True}}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        mod = tvm.IRModule.from_expr(func)
+        result = relay.create_executor("graph", mod=mod, device=tvm.cpu(), target="llvm")
+        result = result.evaluate()(data)
+    tvm.testing.assert_allclose(result.numpy(), ref, rtol=1e-5)
+
+
+def test_fuse_cost_max_inputs():
+    xs = [relay.var("x%d" % i, shape=(10, 20)) for i in range(12)]
+    out = xs[0]
+    for x in xs[1:]:
+        out = relay.add(out, x)
+    func = relay.Function(xs, out)
+
+    assert len(_primitive_functions(_fuse_with_objective(func, "pattern"))) == 1
+    funcs = _primitive_functions(_fuse_with_objective(func, "cost", max_inputs=4))
+    assert len(funcs) > 1
+    assert all(len(f.params) <= 4 for f in funcs)
+
+
 if __name__ == "__main__":
     test_fuse_simple()
     test_conv2d_fuse()
@@ -804,3 +858,5 @@ if __name__ == "__main__":
     test_fuse_gather_nd()
     test_fuse_bcast_reduce_scalar()
     test_fuse_max_diamond()
+    test_fuse_cost_chained_reductions()
+    test_fuse_cost_max_inputs()
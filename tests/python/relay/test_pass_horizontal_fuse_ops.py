@@ -0,0 +1,128 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import json
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import graph_executor
+from tvm.relay.transform import FuseOps, HorizontalFuseOps, InferType
+
+
+def num_fused_calls(mod):
+    calls = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and isinstance(expr.op, relay.Function):
+            calls.append(expr)
+
+    relay.analysis.post_order_visit(mod["main"], visit)
+    return len(calls)
+
+
+def fuse(outputs):
+    func = relay.Function(relay.analysis.free_vars(relay.Tuple(outputs)), relay.Tuple(outputs))
+    mod = tvm.IRModule.from_expr(func)
+    return tvm.transform.Sequential([InferType(), FuseOps(fuse_opt_level=2)])(mod)
+
+
+def branches(op, num=4, shape=(4, 16)):
+    inputs = [relay.var("x%d" % i, shape=shape) for i in range(num)]
+    return inputs, [op(relay.exp(x)) for x in inputs]
+
+
+def build_and_run(outputs, inputs, inputs_np):
+    func = relay.Function(inputs, relay.Tuple(outputs))
+    with tvm.transform.PassContext(opt_level=3, required_pass=["HorizontalFuseOps"]):
+        lib = relay.build(tvm.IRModule.from_expr(func), target="llvm")
+    num_kernels = sum(node["op"] == "tvm_op" for node in json.loads(lib.get_graph_json())["nodes"])
+    module = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    for x, x_np in zip(inputs, inputs_np):
+        module.set_input(x.name_hint, x_np)
+    module.run()
+    return num_kernels, [module.get_output(i).numpy() for i in range(len(outputs))]
+
+
+def test_pack_elementwise():
+    inputs, outputs = branches(lambda y: relay.add(y, relay.const(1.0)))
+    mod = fuse(outputs)
+    assert num_fused_calls(mod) == 4
+    assert num_fused_calls(HorizontalFuseOps()(mod)) == 1
+
+    inputs_np = [np.random.uniform(size=(4, 16)).astype("float32") for _ in inputs]
+    num_kernels, res = build_and_run(outputs, inputs, inputs_np)
+    assert num_kernels == 1
+    for r, x_np in zip(res, inputs_np):
+        tvm.testing.assert_allclose(r, np.exp(x_np) + 1, rtol=1e-5)
+
+
+def test_pack_reductions():
+    inputs, outputs = branches(lambda y: relay.sum(y, axis=1))
+    inputs_np = [np.random.uniform(size=(4, 16)).astype("float32") for _ in inputs]
+    num_kernels, res = build_and_run(outputs, inputs, inputs_np)
+    assert num_kernels == 1
+    for r, x_np in zip(res, inputs_np):
+        tvm.testing.assert_allclose(r, np.exp(x_np).sum(axis=1), rtol=1e-5)
+
+
+def test_group_size():
+    _, outputs = branches(relay.nn.relu, num=5)
+    mod = fuse(outputs)
+    config = {"relay.HorizontalFuseOps": {"max_group_size": 2}}
+    with tvm.transform.PassContext(config=config):
+        # Two groups of two, and the last function left alone.
+        assert num_fused_calls(HorizontalFuseOps()(mod)) == 3
+
+
+def test_dependent_not_packed():
+    x = relay.var("x", shape=(4, 16))
+    y = relay.sum(relay.exp(x), axis=1, keepdims=True)
+    mod = fuse([relay.nn.softmax(relay.add(x, y))])
+    tvm.ir.assert_structural_equal(HorizontalFuseOps()(mod), mod)
+
+
+def test_packed_function_attr():
+    _, outputs = branches(lambda y: relay.sum(y, axis=1), num=2)
+    packed = HorizontalFuseOps()(fuse(outputs))
+    funcs = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and isinstance(expr.op, relay.Function):
+            funcs.append(expr.op)
+
+    relay.analysis.post_order_visit(packed["main"], visit)
+    assert [int(f.attrs["relay.horizontally_fused"]) for f in funcs] == [1]
+
+    # Without the attribute, a function with two reductions is still rejected.
+    x = relay.var("x", shape=(4, 16, 8))
+    p = relay.var("p", shape=(4, 16, 8))
+    chain = relay.Function([p], relay.sum(relay.sum(p, axis=2), axis=1))
+    chain = chain.with_attr("Primitive", tvm.tir.IntImm("int32", 1))
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.Call(chain, [x])))
+    with pytest.raises(tvm.TVMError):
+        relay.build(mod, target="llvm")
+
+
+if __name__ == "__main__":
+    test_pack_elementwise()
+    test_pack_reductions()
+    test_group_size()
+    test_dependent_not_packed()
+    test_packed_function_attr()
@@ -0,0 +1,83 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.relay.testing import count_ops, rand, run_infer_type
+from tvm.relay.transform import Rematerialize, gradient
+
+
+def late_use():
+    # a is used right away and at the end, the peak is at m in between.
+    x = relay.var("x", shape=(64, 64), dtype="float32")
+    a, s, m, r = [relay.var(name) for name in "asmr"]
+    e = relay.var("e")
+    body = relay.Let(e, relay.multiply(a, r), e)
+    body = relay.Let(r, relay.sum(m, axis=1, keepdims=True), body)
+    body = relay.Let(m, relay.tile(s, (1, 256)), body)
+    body = relay.Let(s, relay.sum(a, axis=1, keepdims=True), body)
+    body = relay.Let(a, relay.exp(x), body)
+    mod = tvm.IRModule.from_expr(relay.Function([x], body))
+    return relay.transform.InferType()(mod)
+
+
+def test_recompute():
+    mod = late_use()
+    remat = Rematerialize(0)(mod)
+    assert count_ops(mod["main"])["exp"] == 1
+    assert count_ops(remat["main"])["exp"] == 2
+
+    x_np = np.random.uniform(size=(64, 64)).astype("float32")
+    a_np = np.exp(x_np)
+    ref = a_np * (256 * a_np.sum(axis=1, keepdims=True))
+    for m in [mod, remat]:
+        res = relay.create_executor("debug", mod=m).evaluate()(x_np)
+        tvm.testing.assert_allclose(res.numpy(), ref, rtol=1e-5)
+
+
+def test_within_budget():
+    mod = late_use()
+    tvm.ir.assert_structural_equal(Rematerialize(1 << 30)(mod), mod)
+
+
+def test_gradient():
+    shape = (16, 16)
+    t = relay.TensorType(shape, "float32")
+    x = relay.var("x", t)
+    y = relay.exp(x)
+    func = run_infer_type(relay.Function([x], relay.multiply(relay.tanh(relay.sigmoid(y)), y)))
+    back_func = run_infer_type(gradient(func, mode="first_order"))
+    mod = tvm.IRModule.from_expr(back_func)
+    remat = Rematerialize(0)(mod)
+    # a forward activation is computed again for the backward section.
+    before, after = count_ops(mod["main"]), count_ops(remat["main"])
+    assert any(after[op] > before[op] for op in ["exp", "sigmoid", "tanh"])
+    assert all(after[op] >= count for op, count in before.items())
+
+    x_np = rand("float32", *shape)
+    forward, (grad,) = relay.create_executor(mod=mod).evaluate()(x_np)
+    remat_forward, (remat_grad,) = relay.create_executor(mod=remat).evaluate()(x_np)
+    tvm.testing.assert_allclose(remat_forward.numpy(), forward.numpy(), rtol=1e-5)
+    tvm.testing.assert_allclose(remat_grad.numpy(), grad.numpy(), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_recompute()
+    test_within_budget()
+    test_gradient()
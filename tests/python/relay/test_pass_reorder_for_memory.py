@@ -0,0 +1,77 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import graph_executor
+from tvm.relay.transform import ReorderForMemory
+
+
+def wide_graph():
+    # The first input of the add has a small subgraph and a large output, the
+    # second one a large subgraph and a small output, it is cheaper to run first.
+    x = relay.var("x", shape=(1, 64), dtype="float32")
+    a = relay.tile(x, (8, 1))
+    b = relay.sum(relay.broadcast_to(x, (32, 64, 4)), axis=2)
+    b = relay.sum(b, axis=0, keepdims=True)
+    return relay.Function([x], relay.add(a, b))
+
+
+def reference(x_np):
+    return x_np.repeat(8, axis=0) + 128 * x_np
+
+
+def test_reorder():
+    mod = tvm.IRModule.from_expr(wide_graph())
+    mod = relay.transform.InferType()(mod)
+    reordered = ReorderForMemory()(mod)
+    body = reordered["main"].body
+    assert isinstance(body, relay.Let)
+    assert body.value.op.name == "broadcast_to"
+
+    x_np = np.random.uniform(size=(1, 64)).astype("float32")
+    for m in [mod, reordered]:
+        res = relay.create_executor("debug", mod=m).evaluate()(x_np)
+        tvm.testing.assert_allclose(res.numpy(), reference(x_np), rtol=1e-5)
+
+
+def test_keep_order():
+    x = relay.var("x", shape=(16, 16), dtype="float32")
+    y = relay.exp(relay.add(x, x))
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.Tuple([y, relay.negative(y)])))
+    mod = relay.transform.InferType()(mod)
+    # A graph with no order lowering the peak keeps its dataflow form.
+    tvm.ir.assert_structural_equal(ReorderForMemory()(mod), mod)
+
+
+def test_graph_executor():
+    mod = tvm.IRModule.from_expr(wide_graph())
+    x_np = np.random.uniform(size=(1, 64)).astype("float32")
+    with tvm.transform.PassContext(opt_level=3, required_pass=["ReorderForMemory"]):
+        lib = relay.build(mod, target="llvm")
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    gmod.set_input("x", x_np)
+    gmod.run()
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), reference(x_np), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_reorder()
+    test_keep_order()
+    test_graph_executor()
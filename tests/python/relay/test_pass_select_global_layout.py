@@ -0,0 +1,126 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import json
+import os
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import utils
+from tvm.relay.testing import count_ops
+from tvm.relay.transform import InferType, SelectGlobalLayout
+
+
+def residual_block():
+    x = relay.var("x", shape=(1, 16, 14, 14))
+    w1 = relay.var("w1", shape=(32, 16, 3, 3))
+    w2 = relay.var("w2", shape=(32, 32, 3, 3))
+    w3 = relay.var("w3", shape=(32, 32, 1, 1))
+    y = relay.nn.relu(relay.nn.conv2d(x, w1, channels=32, kernel_size=(3, 3), padding=(1, 1)))
+    z = relay.nn.conv2d(y, w2, channels=32, kernel_size=(3, 3), padding=(1, 1))
+    z = relay.nn.conv2d(relay.add(z, y), w3, channels=32, kernel_size=(1, 1))
+    return InferType()(tvm.IRModule.from_expr(relay.Function([x, w1, w2, w3], z)))
+
+
+def nchwc_convs(mod):
+    convs = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and expr.op.name == "nn.contrib_conv2d_NCHWc":
+            convs.append(expr)
+
+    relay.analysis.post_order_visit(mod["main"], visit)
+    return convs
+
+
+def select(mod, config=None):
+    with tvm.transform.PassContext(config={"relay.SelectGlobalLayout": config or {}}):
+        return SelectGlobalLayout()(mod)
+
+
+def test_select_layout():
+    mod = residual_block()
+    selected = select(mod)
+    convs = nchwc_convs(selected)
+    assert len(convs) == 3
+    # The convolutions agree on the blocking, the transforms are the input, the
+    # weights and the output.
+    assert count_ops(selected["main"])["layout_transform"] == len(convs) + 2
+    for prev, conv in zip(convs, convs[1:]):
+        assert prev.attrs.out_layout == conv.attrs.data_layout
+
+    args = [
+        np.random.uniform(size=[int(d) for d in p.checked_type.shape]).astype("float32")
+        for p in mod["main"].params
+    ]
+    ref = relay.create_executor("graph", mod=mod, target="llvm").evaluate()(*args)
+    res = relay.create_executor("graph", mod=selected, target="llvm").evaluate()(*args)
+    tvm.testing.assert_allclose(res.numpy(), ref.numpy(), rtol=1e-4, atol=1e-4)
+
+
+def test_select_layout_from_log():
+    record = {
+        "input": [
+            "llvm",
+            "conv2d_NCHWc.x86",
+            [
+                ["TENSOR", [1, 32, 14, 14], "float32"],
+                ["TENSOR", [32, 32, 1, 1], "float32"],
+                [1, 1],
+                [0, 0, 0, 0],
+                [1, 1],
+                "NCHW",
+                "NCHW",
+                "float32",
+            ],
+            {},
+        ],
+        "config": {
+            "index": 0,
+            "code_hash": None,
+            "entity": [["tile_ic", "sp", [-1, 16]], ["tile_oc", "sp", [-1, 32]]],
+        },
+        "result": [[1e-5], 0, 0.1, 0],
+        "version": 0.2,
+        "tvm_version": "0.8.dev0",
+    }
+    log_file = os.path.join(utils.tempdir().temp_dir, "conv2d.log")
+    with open(log_file, "w") as f:
+        f.write(json.dumps(record) + "\n")
+    convs = nchwc_convs(select(residual_block(), {"log_file": log_file}))
+    assert convs[-1].attrs.data_layout == "NCHW16c"
+    assert convs[-1].attrs.out_layout == "NCHW32c"
+
+
+def test_select_layout_dynamic_shape():
+    x = relay.var("x", shape=(1, 16, 1, 1))
+    d = relay.var("d", shape=(1, 32, relay.Any(), relay.Any()))
+    w1 = relay.var("w1", shape=(32, 16, 1, 1))
+    w2 = relay.var("w2", shape=(32, 16, 1, 1))
+    y = relay.add(relay.nn.conv2d(x, w1, channels=32, kernel_size=(1, 1)), d)
+    # The join of the two convolutions has a dynamic shape, its edge is not costed.
+    z = relay.add(y, relay.nn.conv2d(x, w2, channels=32, kernel_size=(1, 1)))
+    mod = InferType()(tvm.IRModule.from_expr(relay.Function([x, d, w1, w2], z)))
+    assert len(nchwc_convs(select(mod))) == 2
+
+
+if __name__ == "__main__":
+    test_select_layout()
+    test_select_layout_from_log()
+    test_select_layout_dynamic_shape()
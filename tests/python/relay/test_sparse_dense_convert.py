@@ -86,5 +86,31 @@ def test_bsr_sparse_dense():
     np.testing.assert_allclose(sparse_output, dense_output, atol=1e-5, rtol=1e-5)
 
 
+def test_auto_bsr_sparse_dense():
+    data = relay.var("data", shape=(4, 128), dtype="float32")
+    w0 = relay.var("weight0", shape=(768, 128), dtype="float32")
+    w1 = relay.var("weight1", shape=(128, 768), dtype="float32")
+    y = relay.nn.dense(relay.nn.relu(relay.nn.dense(data, w0)), w1)
+    func = relay.Function(relay.analysis.free_vars(y), y)
+
+    params = {
+        "weight0": tvm.nd.array(random_bsr_matrix(768, 128, 16, 1, 0.1).todense()),
+        "weight1": tvm.nd.array(np.random.randn(128, 768).astype("float32")),
+    }
+
+    x_np = np.random.randn(4, 128).astype("float32")
+    dense_output = run_func(func, params, x_np)
+    sparse_func, params, report = relay.data_dep_optimization.auto_bsr.convert(
+        func, params, target="llvm -mcpu=core-avx2"
+    )
+    report = {layer["name"]: layer for layer in report}
+    assert report["weight0"]["converted"] and report["weight0"]["block_size"] == (16, 1)
+    assert not report["weight1"]["converted"]
+    assert "weight0.data" in params and "weight1" in params
+    sparse_output = run_func(sparse_func, params, x_np)
+    np.testing.assert_allclose(sparse_output, dense_output, atol=1e-4, rtol=1e-4)
+
+
 if __name__ == "__main__":
     test_bsr_sparse_dense()
+    test_auto_bsr_sparse_dense()
@@ -23,6 +23,7 @@ import tvm
 from tvm import relay
 from tvm.relay.testing import lstm
 from tvm.relay.transform import InferType, ToMixedPrecision, mixed_precision
+from tvm.relay.transform.mixed_precision_search import search_mixed_precision
 
 
 def run_module(mod: tvm.runtime.Module, mod_params: Dict[str, Any]) -> List:
@@ -436,5 +437,67 @@ def test_batch_matmul_simple():
     assert tvm.ir.structural_equal(expected_mod, output_mod)
 
 
+def two_convs():
+    data = relay.var("data", shape=(1, 3, 16, 16))
+    w1 = relay.var("w1", shape=(8, 3, 3, 3))
+    w2 = relay.var("w2", shape=(8, 8, 3, 3))
+    y = relay.nn.relu(relay.nn.conv2d(data, w1, padding=(1, 1)))
+    y = relay.nn.conv2d(y, w2, padding=(1, 1))
+    mod = InferType()(tvm.IRModule.from_expr(relay.Function([data, w1, w2], y)))
+    params = {
+        "w1": np.random.uniform(-1, 1, size=(8, 3, 3, 3)).astype("float32"),
+        "w2": np.random.uniform(-1, 1, size=(8, 8, 3, 3)).astype("float32"),
+    }
+    return mod, params
+
+
+def conv_out_dtypes(mod):
+    dtypes = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and expr.op.name == "nn.conv2d":
+            dtypes.append(expr.checked_type.dtype)
+
+    relay.analysis.post_order_visit(mod["main"], visit)
+    return dtypes
+
+
+def test_keep_fp32_layers():
+    mod, _ = two_convs()
+    config = {"relay.ToMixedPrecision.keep_fp32_layers": [1]}
+    with tvm.transform.PassContext(config=config):
+        output_mod = InferType()(ToMixedPrecision("float16")(mod))
+    assert conv_out_dtypes(output_mod) == ["float16", "float32"]
+
+
+def test_keep_fp32_layers_two_functions():
+    mod, _ = two_convs()
+    # A function with a single layer, the indices only apply to the layers of main.
+    x = relay.var("x", shape=(1, 3, 16, 16))
+    w = relay.var("w", shape=(8, 3, 3, 3))
+    mod["single_conv"] = relay.Function([x, w], relay.nn.conv2d(x, w, padding=(1, 1)))
+    mod = InferType()(mod)
+    config = {"relay.ToMixedPrecision.keep_fp32_layers": [1]}
+    with tvm.transform.PassContext(config=config):
+        output_mod = InferType()(ToMixedPrecision("float16")(mod))
+    assert conv_out_dtypes(output_mod) == ["float16", "float32"]
+    assert output_mod["single_conv"].body.checked_type.dtype == "float16"
+
+
+def test_search_mixed_precision():
+    mod, params = two_convs()
+    dataset = [{"data": np.random.uniform(-1, 1, size=(1, 3, 16, 16)).astype("float32")}]
+
+    # No error is allowed, the layers stay in FP32.
+    output_mod, report = search_mixed_precision(mod, params, dataset, tolerance=0.0)
+    assert [layer["precision"] for layer in report] == ["float32", "float32"]
+    assert conv_out_dtypes(InferType()(output_mod)) == ["float32", "float32"]
+
+    output_mod, report = search_mixed_precision(mod, params, dataset, tolerance=0.1)
+    assert [layer["precision"] for layer in report] == ["float16", "float16"]
+    assert all(layer["sensitivity"] > 0 for layer in report)
+    assert conv_out_dtypes(InferType()(output_mod)) == ["float16", "float16"]
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -545,6 +545,69 @@ def test_repeat_register():
         assert "Operator custom_log3 is registered before" in str(cm.execption)
 
 
+def _incremental_module():
+    mod = IRModule()
+    x = relay.var("x", shape=(4, 4))
+    double = relay.GlobalVar("double")
+    mod[double] = relay.Function([x], relay.add(x, x))
+    y = relay.var("y", shape=(4, 4))
+    add1 = relay.GlobalVar("add1")
+    mod[add1] = relay.Function([y], relay.add(y, relay.const(1.0)))
+    a = relay.var("a", shape=(4, 4))
+    mod["main"] = relay.Function([a], relay.Call(add1, [relay.Call(double, [a])]))
+    return mod
+
+
+def _full_infer(mod):
+    with tvm.transform.PassContext(config={"relay.InferType.incremental": False}):
+        return transform.InferType()(mod)
+
+
+def _incremental_infer(mod):
+    with tvm.transform.PassContext(config={"relay.InferType.incremental": True}):
+        return transform.InferType()(mod)
+
+
+def test_incremental_infer_type_reuses_functions():
+    mod = _incremental_infer(_incremental_module())
+    funcs = {gv: mod[gv] for gv in mod.get_global_vars()}
+    updated = _incremental_infer(mod)
+    for gv, func in funcs.items():
+        assert updated[gv].same_as(func)
+    full = _full_infer(updated)
+    assert tvm.ir.structural_equal(updated, full)
+    assert not full["double"].same_as(funcs[mod.get_global_var("double")])
+
+
+def test_incremental_infer_type_edited_function():
+    mod = _incremental_infer(_incremental_module())
+    double = mod.get_global_var("double")
+    a = relay.var("a", shape=(4, 4))
+    mod["main"] = relay.Function([a], relay.subtract(relay.Call(double, [a]), a))
+    func = mod[double]
+    updated = _incremental_infer(mod)
+    assert updated[double].same_as(func)
+    assert updated["main"].checked_type.ret_type == relay.TensorType((4, 4), "float32")
+    assert tvm.ir.structural_equal(updated, _full_infer(updated))
+
+
+def test_incremental_infer_type_callee_changed():
+    mod = _incremental_infer(_incremental_module())
+    # The caller is unchanged, but the type of the function it calls is.
+    y = relay.var("y", shape=(4, 4))
+    mod[mod.get_global_var("add1")] = relay.Function([y], relay.cast(y, "float16"))
+    updated = _incremental_infer(mod)
+    assert updated["main"].checked_type.ret_type == relay.TensorType((4, 4), "float16")
+    assert tvm.ir.structural_equal(updated, _full_infer(updated))
+
+
+def test_infer_type_default_is_full():
+    mod = transform.InferType()(_incremental_module())
+    updated = transform.InferType()(mod)
+    for gv in mod.get_global_vars():
+        assert not updated[gv].same_as(mod[gv])
+
+
 if __name__ == "__main__":
     import sys
 
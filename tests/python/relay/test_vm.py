@@ -915,5 +915,28 @@ def test_get_output_multiple():
     np.testing.assert_allclose(outputs[1].numpy(), inp)
 
 
+def test_vm_shape_buckets():
+    target = tvm.target.Target("llvm")
+    x = relay.var("x", shape=(relay.Any(), 16), dtype="float32")
+    w = relay.var("w", shape=(8, 16), dtype="float32")
+    f = relay.Function([x, w], relay.nn.relu(relay.nn.dense(x, w)))
+    mod = IRModule.from_expr(f)
+
+    with tvm.transform.PassContext(opt_level=3, config={"relay.backend.shape_buckets": [4, 32]}):
+        exe = vm.compile(mod, target=target)
+    assert any("_bucket4" in name for name in exe.primitive_ops)
+    assert any("_bucket32" in name for name in exe.primitive_ops)
+
+    code, lib = exe.save()
+    exe = runtime.vm.Executable.load_exec(code, lib)
+    vm_factory = runtime.vm.VirtualMachine(exe, tvm.cpu())
+    w_np = np.random.uniform(size=(8, 16)).astype("float32")
+    for n in [4, 7, 32]:
+        x_np = np.random.uniform(size=(n, 16)).astype("float32")
+        out = vm_factory.invoke("main", x_np, w_np)
+        ref = np.maximum(np.dot(x_np, w_np.T), 0)
+        tvm.testing.assert_allclose(out.numpy(), ref, rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
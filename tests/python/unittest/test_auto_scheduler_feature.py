@@ -20,6 +20,8 @@
 import math
 import tempfile
 
+import numpy as np
+
 import tvm
 from tvm import te, auto_scheduler
 
@@ -200,7 +202,34 @@ def test_gpu_feature():
         assert fequal(fea_dicts[0]["is_gpu"], 1.0)
 
 
+def test_feature_tensor():
+    dag = auto_scheduler.ComputeDAG(matmul_auto_scheduler_test(128, 128, 128))
+    target = tvm.target.Target("llvm")
+    task = auto_scheduler.SearchTask(compute_dag=dag, workload_key="test", target=target)
+
+    states = []
+    for factor in [1, 4, 16]:
+        s = dag.get_init_state()
+        C = s.stage_ops[2]
+        i, j, k = s[C].iters
+        io, ii = s.split(C, i, [factor])
+        s.parallel(C, io)
+        states.append(s)
+
+    features = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    tensor, row_offsets = auto_scheduler.feature.get_per_store_feature_tensor_from_states(
+        states, task
+    )
+
+    assert tensor.dtype == np.float32 and row_offsets.dtype == np.int32
+    assert tensor.shape == (sum(len(x) for x in features), len(features[0][0]))
+    assert row_offsets.shape == (len(states) + 1,)
+    for i, feature in enumerate(features):
+        np.testing.assert_allclose(tensor[row_offsets[i] : row_offsets[i + 1]], feature)
+
+
 if __name__ == "__main__":
     test_cpu_matmul()
     test_cpu_fusion()
     test_gpu_feature()
+    test_feature_tensor()
@@ -293,6 +293,39 @@ def test_dag_measure_local_builder_runner():
         assert mress[0].error_no == 0
 
 
+def test_measure_local_builder_cache():
+    if not tvm.testing.device_enabled("llvm"):
+        return
+
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(128, 128, 128), target="llvm"
+    )
+    state = task.compute_dag.init_state
+    state.parallel(2, state.stages[2].iters[0])
+
+    with tempfile.TemporaryDirectory() as cache_dir:
+        local_builder = auto_scheduler.LocalBuilder(cache_dir=cache_dir)
+        local_runner = auto_scheduler.LocalRunner(timeout=60)
+
+        # The duplicated inputs in one batch are only built once
+        minps = [
+            auto_scheduler.MeasureInput(task, task.compute_dag.init_state),
+            auto_scheduler.MeasureInput(task, state),
+            auto_scheduler.MeasureInput(task, task.compute_dag.init_state),
+        ]
+        bress = local_builder.build(minps)
+        assert all(bres.error_no == 0 for bres in bress)
+        assert len(set(bres.filename for bres in bress)) == 3
+        mress = local_runner.run(minps, bress)
+        assert all(mres.error_no == 0 for mres in mress)
+
+        # The artifacts are still reusable after the runner removed its copies
+        bress = local_builder.build(minps[:2])
+        assert all(bres.error_no == 0 for bres in bress)
+        mress = local_runner.run(minps[:2], bress)
+        assert all(mres.error_no == 0 for mres in mress)
+
+
 def test_measure_local_builder_rpc_runner():
     if not tvm.testing.device_enabled("llvm"):
         return
@@ -423,6 +456,7 @@ if __name__ == "__main__":
     test_workload_dis_factor()
     test_measure_local_builder_runner()
     test_dag_measure_local_builder_runner()
+    test_measure_local_builder_cache()
     test_measure_local_builder_rpc_runner()
     test_measure_target_host()
     test_measure_special_inputs_map_by_name_local_runner()
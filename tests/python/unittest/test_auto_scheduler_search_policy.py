@@ -209,6 +209,88 @@ def test_sketch_search_policy_custom_sketch():
     )
 
 
+@tvm.testing.requires_llvm
+def test_sketch_search_policy_transfer_states():
+    source_task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(64, 64, 64), target="llvm"
+    )
+    target_task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(96, 64, 64), target="llvm"
+    )
+    other_task = auto_scheduler.SearchTask(
+        func=zero_rank_reduce_auto_scheduler_test, args=(64,), target="llvm"
+    )
+
+    with tempfile.NamedTemporaryFile() as fp:
+        log_file = fp.name
+
+        # Record some tiled states of the source workload and an unrelated workload
+        source_policy = auto_scheduler.SketchPolicy(source_task, verbose=0)
+        source_states = source_policy.sample_initial_population()[:4]
+        other_states = auto_scheduler.SketchPolicy(
+            other_task, verbose=0
+        ).sample_initial_population()[:4]
+        inputs = [auto_scheduler.MeasureInput(source_task, s) for s in source_states]
+        inputs += [auto_scheduler.MeasureInput(other_task, s) for s in other_states]
+        results = [
+            auto_scheduler.MeasureResult([0.1 * (i + 1)], 0, "", 0.2, 1)
+            for i in range(len(inputs))
+        ]
+        auto_scheduler.save_records(log_file, inputs, results)
+
+        policy = auto_scheduler.SketchPolicy(
+            target_task,
+            verbose=0,
+            init_search_callbacks=[auto_scheduler.PreloadTransferredStates(log_file, 2)],
+        )
+        states = policy.transferred_states()
+        assert 0 < len(states) <= 2
+        for state in states:
+            # The adapted states must be valid schedules of the target workload
+            sch, args = target_task.compute_dag.apply_steps_from_state(state)
+            tvm.lower(sch, args)
+
+        # No states are transferred to the source workload from its own records
+        policy = auto_scheduler.SketchPolicy(
+            source_task,
+            verbose=0,
+            init_search_callbacks=[auto_scheduler.PreloadTransferredStates(log_file)],
+        )
+        assert len(policy.transferred_states()) == 0
+
+
+@tvm.testing.requires_llvm
+def test_sketch_search_policy_transfer_split_non_divisible():
+    source_task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(64, 64, 64), target="llvm"
+    )
+    target_task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(36, 64, 64), target="llvm"
+    )
+
+    with tempfile.NamedTemporaryFile() as fp:
+        log_file = fp.name
+
+        # Split i into 16 x 4 x 4, the last length is the innermost one
+        C = source_task.compute_dag.ops[-1]
+        state = source_task.compute_dag.get_init_state()
+        state.split(C, state[C].iters[0], [4, 4], inner_to_outer=True)
+        inputs = [auto_scheduler.MeasureInput(source_task, state)]
+        results = [auto_scheduler.MeasureResult([0.1], 0, "", 0.2, 1)]
+        auto_scheduler.save_records(log_file, inputs, results)
+
+        policy = auto_scheduler.SketchPolicy(
+            target_task,
+            verbose=0,
+            init_search_callbacks=[auto_scheduler.PreloadTransferredStates(log_file)],
+        )
+        states = policy.transferred_states()
+        assert len(states) == 1
+        # 36 is not divisible by 16, the innermost length is kept and the next one adapted
+        iters = states[0].stages[-1].iters
+        assert [int(it.range.extent) for it in iters[:3]] == [3, 3, 4]
+
+
 if __name__ == "__main__":
     test_workload_registry_empty_policy()
     test_sketch_search_policy_basic()
@@ -218,3 +300,5 @@ if __name__ == "__main__":
     test_sketch_search_policy_cuda_xgbmodel_rpc_runner()
     test_sketch_search_policy_zero_rank()
     test_sketch_search_policy_custom_sketch()
+    test_sketch_search_policy_transfer_states()
+    test_sketch_search_policy_transfer_split_non_divisible()
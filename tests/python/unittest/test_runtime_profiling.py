@@ -18,9 +18,10 @@ import numpy as np
 import pytest
 from io import StringIO
 import csv
+import json
 
 import tvm.testing
-from tvm.runtime import profiler_vm
+from tvm.runtime import profiler_vm, profiling
 from tvm import relay
 from tvm.relay.testing import mlp
 from tvm.contrib.debugger import debug_executor
@@ -61,3 +62,69 @@ def test_graph_executor(target, dev):
     assert "fused_nn_softmax" in str(report)
     assert "Total" in str(report)
     assert "Hash" in str(report)
+
+
+def test_json():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.build(mod, "llvm", params=params)
+    gr = debug_executor.create(exe.get_graph_json(), exe.lib, tvm.cpu())
+
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    parsed = json.loads(gr.profile(data=data).json())
+    assert "device_metrics" in parsed
+    assert "calls" in parsed
+    assert "Duration (us)" in parsed["calls"][0]
+    assert "microseconds" in parsed["calls"][0]["Duration (us)"]
+    assert len(parsed["calls"]) > 0
+    for call in parsed["calls"]:
+        assert isinstance(call["Name"], str)
+        assert isinstance(call["Count"]["count"], int)
+
+
+def perf_event_enabled():
+    if tvm.get_global_func("runtime.profiling.PerfEventCollector", allow_missing=True) is None:
+        return False
+    try:
+        with open("/proc/sys/kernel/perf_event_paranoid") as f:
+            return int(f.read()) <= 2
+    except (OSError, ValueError):
+        return False
+
+
+@pytest.mark.skipif(not perf_event_enabled(), reason="perf_event counters not available")
+def test_perf_event():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.build(mod, "llvm", params=params)
+    gr = debug_executor.create(exe.get_graph_json(), exe.lib, tvm.cpu())
+
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    collector = profiling.PerfEventCollector(["cycles", "instructions"])
+    report = gr.profile(data=data, collectors=[collector])
+    assert "Cycles" in str(report)
+    assert "Instructions" in str(report)
+    calls = json.loads(report.json())["calls"]
+    assert all(call["Cycles"]["count"] > 0 for call in calls)
+
+
+def test_roofline():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.build(mod, "llvm", params=params)
+    gr = debug_executor.create(exe.get_graph_json(), exe.lib, tvm.cpu())
+
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    report = gr.profile(data=data, peak_gflops=100.0, peak_gbps=20.0)
+    assert "GFLOPS" in str(report)
+    assert "GB/s" in str(report)
+    assert "Roofline (%)" in str(report)
+
+    calls = json.loads(report.json())["calls"]
+    dense = [call for call in calls if call["Name"].startswith("fused_nn_dense")]
+    assert len(dense) > 0
+    for call in dense:
+        assert call["FLOPs"]["count"] > 0
+        assert call["Bytes"]["count"] > 0
+        assert call["GFLOPS"]["ratio"] > 0
+        assert 0 < call["Roofline (%)"]["ratio"]
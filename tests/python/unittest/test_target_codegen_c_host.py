@@ -227,6 +227,97 @@ def test_call_packed():
     check_global_packed_func()
 
 
+def test_simd_intrinsics():
+    def saturate(x, dtype):
+        info = np.iinfo(dtype)
+        return te.max(te.min(x, tvm.tir.const(info.max, x.dtype)), tvm.tir.const(info.min, x.dtype))
+
+    def mla(dtype):
+        A = te.placeholder((64,), dtype, name="A")
+        B = te.placeholder((64,), dtype, name="B")
+        D = te.placeholder((64,), dtype, name="D")
+        C = te.compute(A.shape, lambda i: A[i] * B[i] + D[i], name="C")
+        return [A, B, D, C], lambda a, b, d: a * b + d
+
+    def qadd(dtype):
+        A = te.placeholder((64,), dtype, name="A")
+        B = te.placeholder((64,), dtype, name="B")
+        wide = lambda x: x.astype("int32")
+        C = te.compute(
+            A.shape, lambda i: saturate(wide(A[i]) + wide(B[i]), dtype).astype(dtype), name="C"
+        )
+        return [A, B, C], lambda a, b: np.clip(wide(a) + wide(b), *_bounds(dtype)).astype(dtype)
+
+    def qsub(dtype):
+        A = te.placeholder((64,), dtype, name="A")
+        B = te.placeholder((64,), dtype, name="B")
+        wide = lambda x: x.astype("int32")
+        C = te.compute(
+            A.shape, lambda i: saturate(wide(A[i]) - wide(B[i]), dtype).astype(dtype), name="C"
+        )
+        return [A, B, C], lambda a, b: np.clip(wide(a) - wide(b), *_bounds(dtype)).astype(dtype)
+
+    def vmax(dtype):
+        A = te.placeholder((64,), dtype, name="A")
+        B = te.placeholder((64,), dtype, name="B")
+        C = te.compute(A.shape, lambda i: te.max(A[i], B[i]), name="C")
+        return [A, B, C], np.maximum
+
+    def strided_add(dtype):
+        # The load of A is not contiguous, its elements are packed into a vector.
+        A = te.placeholder((128,), dtype, name="A")
+        B = te.placeholder((64,), dtype, name="B")
+        C = te.compute(B.shape, lambda i: A[i * 2] + B[i], name="C")
+        return [A, B, C], lambda a, b: a[::2] + b
+
+    def _bounds(dtype):
+        info = np.iinfo(dtype)
+        return info.min, info.max
+
+    def check(simd, workload, dtype, lanes, intrinsics):
+        args, ref = workload(dtype)
+        C = args[-1]
+        s = te.create_schedule(C.op)
+        _, xi = s[C].split(C.op.axis[0], factor=lanes)
+        s[C].vectorize(xi)
+        mhost = tvm.build(s, args, "c -simd=%s" % simd, name="test_simd")
+        src = mhost.get_source()
+        for intrin in intrinsics:
+            assert intrin in src, "%s is not used for %s on %s" % (intrin, workload.__name__, simd)
+
+        # run on the host with the portable emulation of the intrinsics
+        temp = utils.tempdir()
+        path_dso = temp.relpath("temp.so")
+        mhost.export_library(path_dso, options=["-DTVM_SIMD_EMULATION"])
+        f = tvm.runtime.load_module(path_dso)["test_simd"]
+        dev = tvm.cpu(0)
+        if np.dtype(dtype).kind == "f":
+            inputs = [
+                np.random.uniform(-1, 1, size=[int(d) for d in x.shape]).astype(dtype)
+                for x in args[:-1]
+            ]
+        else:
+            low, high = _bounds(dtype)
+            inputs = [
+                np.random.randint(low, high + 1, size=[int(d) for d in x.shape]).astype(dtype)
+                for x in args[:-1]
+            ]
+        out = tvm.nd.array(np.zeros(64, dtype=dtype), dev)
+        f(*[tvm.nd.array(x, dev) for x in inputs], out)
+        tvm.testing.assert_allclose(out.numpy(), ref(*inputs), rtol=1e-5)
+
+    check("neon", mla, "float32", 4, ["vld1q_f32", "vmlaq_f32", "vst1q_f32"])
+    check("neon", qadd, "int8", 16, ["vqaddq_s8"])
+    check("neon", qsub, "uint16", 8, ["vqsubq_u16"])
+    check("dsp", qadd, "int8", 4, ["__qadd8"])
+    check("dsp", qsub, "uint16", 2, ["__uqsub16"])
+    check("rvp", vmax, "int16", 2, ["__rv_smax16"])
+    check("rvp", qadd, "uint8", 4, ["__rv_ukadd8"])
+    check("neon", strided_add, "float32", 4, ["(float32x4_t){", "vaddq_f32"])
+    check("dsp", strided_add, "int8", 4, ["tvm_simd_pack8", "__sadd8"])
+    check("rvp", strided_add, "int16", 2, ["tvm_simd_pack16", "__rv_add16"])
+
+
 if __name__ == "__main__":
     test_add()
     test_add_pipeline()
@@ -235,3 +326,4 @@ if __name__ == "__main__":
     test_floor()
     test_round()
     test_call_packed()
+    test_simd_intrinsics()
@@ -17,6 +17,7 @@
 import collections
 import ctypes
 import json
+import os
 import sys
 
 import tvm
@@ -142,6 +143,185 @@ def test_llvm_persist_parallel():
     check_llvm()
 
 
+@tvm.testing.requires_llvm
+def test_llvm_parallel_schedule():
+    # triangular workload: row i sums the first i + 1 elements of A
+    n = 257
+    A = te.placeholder((n,), name="A")
+    k = te.reduce_axis((0, n), name="k")
+    B = te.compute(
+        (n,), lambda i: te.sum(te.if_then_else(k <= i, A[k], 0.0), axis=k), name="B"
+    )
+
+    def check_llvm(schedule):
+        s = te.create_schedule(B.op)
+        s[B].parallel(B.op.axis[0])
+        s[B].pragma(B.op.axis[0], "parallel_schedule", schedule)
+        f = tvm.build(s, [A, B], "llvm")
+        dev = tvm.cpu(0)
+        a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+        b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+        # run twice to check that the shared counter is reset between launches
+        for _ in range(2):
+            f(a, b)
+            tvm.testing.assert_allclose(b.numpy(), np.cumsum(a.numpy()), rtol=1e-5)
+
+    for schedule in ["static", "dynamic", "dynamic,4", "guided", "guided,16"]:
+        check_llvm(schedule)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_parallel_schedule_launch_point():
+    # the dynamically scheduled loop is entered once per row within a single launch
+    m, n = 4, 101
+    A = te.placeholder((m, n), name="A")
+    B = te.compute((m, n), lambda i, j: A[i, j] + 1, name="B")
+
+    def check_llvm(schedule):
+        s = te.create_schedule(B.op)
+        s[B].pragma(B.op.axis[0], "parallel_launch_point")
+        s[B].parallel(B.op.axis[1])
+        s[B].pragma(B.op.axis[1], "parallel_schedule", schedule)
+        f = tvm.build(s, [A, B], "llvm")
+        dev = tvm.cpu(0)
+        a = tvm.nd.array(np.random.uniform(size=(m, n)).astype(A.dtype), dev)
+        b = tvm.nd.array(np.zeros((m, n), dtype=B.dtype), dev)
+        f(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1, rtol=1e-5)
+
+    for schedule in ["dynamic,4", "guided"]:
+        check_llvm(schedule)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_nested_parallel():
+    n, m = 13, 37
+    A = te.placeholder((n, m), name="A")
+
+    def check_llvm(s, C, ref):
+        f = tvm.build(s, [A, C], "llvm")
+        dev = tvm.cpu(0)
+        a = tvm.nd.array(np.random.uniform(size=(n, m)).astype(A.dtype), dev)
+        c = tvm.nd.array(np.zeros(C.shape, dtype=C.dtype), dev)
+        f(a, c)
+        tvm.testing.assert_allclose(c.numpy(), ref(a.numpy()), rtol=1e-5)
+
+    # perfectly nested parallel loops are collapsed into one parallel loop
+    C = te.compute((n, m), lambda i, j: A[i, j] * 2, name="C")
+    s = te.create_schedule(C.op)
+    s[C].parallel(C.op.axis[0])
+    s[C].parallel(C.op.axis[1])
+    check_llvm(s, C, lambda a: a * 2)
+
+    # the inner parallel loop is not perfectly nested and runs serially within each task
+    B = te.compute((n, m), lambda i, j: A[i, j] + 1, name="B")
+    C = te.compute((n, m), lambda i, j: B[i, j] * 2, name="C")
+    s = te.create_schedule(C.op)
+    s[B].compute_at(s[C], C.op.axis[0])
+    s[B].parallel(B.op.axis[1])
+    s[C].parallel(C.op.axis[0])
+    s[C].parallel(C.op.axis[1])
+    check_llvm(s, C, lambda a: (a + 1) * 2)
+
+    # the outer loop starting at a non-zero min keeps its offset when collapsed
+    def extern_ir(ins, outs):
+        ib = tvm.tir.ir_builder.create()
+        a = ib.buffer_ptr(ins[0])
+        c = ib.buffer_ptr(outs[0])
+        with ib.for_range(0, n * m, name="k") as k:
+            c[k] = tvm.tir.const(0, "float32")
+        with ib.for_range(3, n, name="i", kind="parallel") as i:
+            with ib.for_range(0, m, name="j", kind="parallel") as j:
+                c[i * m + j] = a[i * m + j] * 2.0
+        return ib.get()
+
+    def ref(a):
+        c = np.zeros_like(a)
+        c[3:] = a[3:] * 2
+        return c
+
+    C = te.extern((n, m), [A], extern_ir, name="C", dtype="float32")
+    s = te.create_schedule(C.op)
+    check_llvm(s, C, ref)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_vectorize_predicated_tail():
+    def check_llvm(n, factor, index):
+        A = te.placeholder((n,), name="A")
+        C = te.compute((n,), lambda i: A[index(i)] + 1.0, name="C")
+        s = te.create_schedule(C.op)
+        xo, xi = s[C].split(C.op.axis[0], factor=factor)
+        s[C].parallel(xo)
+        s[C].vectorize(xi)
+        with tvm.transform.PassContext(config={"tir.vectorize_predicated_tail": True}):
+            f = tvm.build(s, [A, C], "llvm")
+        assert "llvm.masked" in f.get_source("ll")
+        dev = tvm.cpu(0)
+        a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+        c = tvm.nd.array(np.zeros(n, dtype=C.dtype), dev)
+        f(a, c)
+        tvm.testing.assert_allclose(c.numpy(), a.numpy()[index(np.arange(n))] + 1, rtol=1e-5)
+
+    # contiguous accesses use masked load/store
+    check_llvm(37, 16, lambda i: i)
+    check_llvm(5, 16, lambda i: i)
+    # non-contiguous accesses use masked gather/scatter
+    check_llvm(37, 16, lambda i: 36 - i)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_nontemporal_store():
+    n = 4096
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    xo, xi = s[B].split(B.op.axis[0], factor=8)
+    s[B].parallel(xo)
+    s[B].vectorize(xi)
+    with tvm.transform.PassContext(config={"tir.nontemporal_store_threshold": 1}):
+        f = tvm.build(s, [A, B], "llvm")
+        # every parallel task ends with a store fence
+        m = tvm.build(s, [A, B], "llvm -mtriple=x86_64-linux-gnu")
+    assert "!nontemporal" in f.get_source("ll")
+    assert "llvm.x86.sse.sfence" in m.get_source("ll")
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+    b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_orc_jit():
+    if tvm.target.codegen.llvm_version_major() < 13:
+        return
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    C = te.compute((n,), lambda i: A[i] * 2.0, name="C")
+    sb = te.create_schedule(B.op)
+    sb[B].parallel(B.op.axis[0])
+    sc = te.create_schedule(C.op)
+    mod = tvm.lower(sb, [A, B], name="add_one")
+    mod.update(tvm.lower(sc, [A, C], name="mul_two"))
+
+    temp = utils.tempdir()
+    target = "llvm -jit=orc -jit-threads=2 -jit-cache-dir=%s" % temp.relpath("cache")
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+    for _ in range(2):
+        # the second build loads the objects compiled by the first one from the cache
+        f = tvm.build(mod, target=target)
+        b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+        c = tvm.nd.array(np.zeros(n, dtype=C.dtype), dev)
+        f["add_one"](a, b)
+        f["mul_two"](a, c)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+        tvm.testing.assert_allclose(c.numpy(), a.numpy() * 2.0)
+    assert any(name.endswith(".o") for name in os.listdir(temp.relpath("cache")))
+
+
 @tvm.testing.requires_llvm
 def test_llvm_flip_pipeline():
     def check_llvm(nn, base):
@@ -0,0 +1,78 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm import te
+
+
+def _annotated_buffers(mod, threshold):
+    with tvm.transform.PassContext(config={"tir.nontemporal_store_threshold": threshold}):
+        body = tvm.tir.transform.AnnotateNontemporalStore()(mod)["main"].body
+    buffers = []
+    while isinstance(body, tvm.tir.AttrStmt) and body.attr_key == "nontemporal_store":
+        buffers.append(body.node.name)
+        body = body.body
+    return buffers
+
+
+def _lower(fcompute, vectorize=True):
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: fcompute(A, i), name="B")
+    s = te.create_schedule(B.op)
+    if vectorize:
+        _, xi = s[B].split(B.op.axis[0], factor=8)
+        s[B].vectorize(xi)
+    return tvm.lower(s, [A, B])
+
+
+def test_write_only_stream():
+    mod = _lower(lambda A, i: A[i] * 2)
+    assert _annotated_buffers(mod, 1) == ["B"]
+    # smaller than the threshold
+    assert _annotated_buffers(mod, 1 << 20) == []
+    # disabled
+    assert _annotated_buffers(mod, 0) == []
+
+
+def test_scalar_store():
+    mod = _lower(lambda A, i: A[i] * 2, vectorize=False)
+    assert _annotated_buffers(mod, 1) == []
+
+
+def test_read_back():
+    n = 1024
+    A = tvm.tir.decl_buffer((n,), "float32", name="A")
+    i = te.var("i")
+    index = tvm.tir.Ramp(i * 4, 1, 4)
+
+    def check(value, expected):
+        store = tvm.tir.Store(A.data, value, index)
+        loop = tvm.tir.For(i, 0, n // 4, tvm.tir.ForKind.SERIAL, store)
+        a = tvm.tir.Var("a", "handle")
+        mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([a], loop, buffer_map={a: A}))
+        assert _annotated_buffers(mod, 1) == expected
+
+    one = tvm.tir.Broadcast(tvm.tir.const(1, "float32"), 4)
+    check(one, ["A"])
+    # the buffer is read back, the stores have to stay in cache
+    check(tvm.tir.Load("float32x4", A.data, index) + one, [])
+
+
+if __name__ == "__main__":
+    test_write_only_stream()
+    test_scalar_store()
+    test_read_back()
@@ -0,0 +1,136 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import te, topi
+
+
+def _count_prefetch(stmt):
+    calls = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            calls.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return calls
+
+
+def _run_pass(stmt, args, target="llvm -software-prefetch=1"):
+    func = tvm.tir.PrimFunc(args, stmt).with_attr("target", tvm.target.Target(target))
+    mod = tvm.IRModule.from_expr(func)
+    return tvm.tir.transform.InjectSoftwarePrefetch()(mod)["main"].body
+
+
+def test_indirect_access():
+    n = 1024
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("int32", name="B")
+    C = ib.pointer("float32", name="C")
+    with ib.for_range(0, n, name="i") as i:
+        C[i] = A[B[i]]
+    stmt = _run_pass(ib.get(), [A, B, C])
+
+    calls = _count_prefetch(stmt)
+    assert len(calls) == 1
+    load = calls[0].args[0].args[0]
+    assert load.buffer_var.same_as(A.asobject())
+    assert isinstance(load.index, tvm.tir.Load)
+    assert isinstance(load.index.index, tvm.tir.Min)
+
+    # the pass is only enabled by the target attribute
+    stmt = _run_pass(ib.get(), [A, B, C], target="llvm")
+    assert len(_count_prefetch(stmt)) == 0
+
+
+def test_guarded_indirect_access():
+    n = 1000
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("int32", name="B")
+    C = ib.pointer("float32", name="C")
+    # the guard of a non-divisible split, B is only read in bounds
+    with ib.for_range(0, (n + 15) // 16, name="xo") as xo:
+        with ib.for_range(0, 16, name="xi") as xi:
+            with ib.if_scope(tvm.tir.likely(xo * 16 + xi < n)):
+                C[xo * 16 + xi] = A[B[xo * 16 + xi]]
+    stmt = _run_pass(ib.get(), [A, B, C])
+    assert len(_count_prefetch(stmt)) == 0
+
+
+def test_strided_access():
+    n = 1024
+
+    def check(stride, expected):
+        ib = tvm.tir.ir_builder.create()
+        A = ib.pointer("float32", name="A")
+        C = ib.pointer("float32", name="C")
+        with ib.for_range(0, n, name="i") as i:
+            C[i] = A[i * stride]
+        stmt = _run_pass(ib.get(), [A, C])
+        assert len(_count_prefetch(stmt)) == expected
+
+    # unit-stride streams are left to the hardware prefetcher
+    check(1, 0)
+    check(64, 1)
+
+
+def test_gathered_rows():
+    n, dim = 64, 128
+    ib = tvm.tir.ir_builder.create()
+    W = ib.pointer("float32", name="W")
+    B = ib.pointer("int32", name="B")
+    C = ib.pointer("float32", name="C")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.for_range(0, dim, name="j") as j:
+            C[i * dim + j] = W[B[i] * dim + j]
+    stmt = _run_pass(ib.get(), [W, B, C])
+
+    calls = _count_prefetch(stmt)
+    assert len(calls) == 1
+    # one prefetch per cache line of the row
+    assert isinstance(stmt.body[0], tvm.tir.For)
+    assert stmt.body[0].extent.value == dim * 4 // 64
+
+
+@tvm.testing.requires_llvm
+def test_embedding_lookup():
+    n, vocab, dim = 200, 1000, 64
+    W = te.placeholder((vocab, dim), name="W")
+    B = te.placeholder((n,), dtype="int32", name="B")
+    C = topi.take(W, B, axis=0)
+    s = te.create_schedule(C.op)
+    f = tvm.build(s, [W, B, C], "llvm -software-prefetch=1")
+    assert "llvm.prefetch" in f.get_source("ll")
+
+    dev = tvm.cpu(0)
+    w = tvm.nd.array(np.random.uniform(size=(vocab, dim)).astype(W.dtype), dev)
+    b = tvm.nd.array(np.random.randint(0, vocab, size=n).astype(B.dtype), dev)
+    c = tvm.nd.array(np.zeros((n, dim), dtype=C.dtype), dev)
+    f(w, b, c)
+    tvm.testing.assert_allclose(c.numpy(), w.numpy()[b.numpy()])
+
+
+if __name__ == "__main__":
+    test_indirect_access()
+    test_guarded_indirect_access()
+    test_strided_access()
+    test_gathered_rows()
+    test_embedding_lookup()
@@ -0,0 +1,97 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def _parallel_sum(n, dtype="float32"):
+    ib = tvm.tir.ir_builder.create()
+    A = tvm.tir.decl_buffer((n,), dtype, name="A")
+    B = tvm.tir.decl_buffer((1,), dtype, name="B")
+    Aptr = ib.buffer_ptr(A)
+    Bptr = ib.buffer_ptr(B)
+    Bptr[0] = tvm.tir.const(0, dtype)
+    with ib.for_range(0, n, name="k", kind="parallel") as k:
+        Bptr[0] = Bptr[0] + Aptr[k]
+    return tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, B], ib.get()))
+
+
+def _find(stmt, cond):
+    found = []
+    tvm.tir.stmt_functor.post_order_visit(stmt, lambda n: found.append(n) if cond(n) else None)
+    return found
+
+
+def test_lower_parallel_reduction():
+    mod = _parallel_sum(1000)
+    with tvm.transform.PassContext(config={"tir.parallel_reduce_chunks": 16}):
+        body = tvm.tir.transform.LowerParallelReduction()(mod)["main"].body
+    launch = _find(
+        body,
+        lambda n: isinstance(n, tvm.tir.AttrStmt) and n.attr_key == "pragma_parallel_launch_point",
+    )
+    barrier = _find(
+        body,
+        lambda n: isinstance(n, tvm.tir.AttrStmt)
+        and n.attr_key == "pragma_parallel_barrier_when_finish",
+    )
+    assert len(launch) == 1 and len(barrier) == 1
+    loops = _find(body, lambda n: isinstance(n, tvm.tir.For) and n.kind == tvm.tir.ForKind.PARALLEL)
+    assert sorted(loop.extent.value for loop in loops) == [1, 16]
+
+    # disabled by a non-positive number of chunks
+    with tvm.transform.PassContext(config={"tir.parallel_reduce_chunks": 0}):
+        ret = tvm.tir.transform.LowerParallelReduction()(mod)
+    tvm.ir.assert_structural_equal(ret, mod)
+
+
+def test_lower_parallel_reduction_skip():
+    # the loop writes a different element per iteration, it is not a reduction
+    ib = tvm.tir.ir_builder.create()
+    A = tvm.tir.decl_buffer((64,), "float32", name="A")
+    Aptr = ib.buffer_ptr(A)
+    with ib.for_range(0, 64, name="i", kind="parallel") as i:
+        Aptr[i] = Aptr[i] + 1.0
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A], ib.get()))
+    ret = tvm.tir.transform.LowerParallelReduction()(mod)
+    tvm.ir.assert_structural_equal(ret, mod)
+
+
+@tvm.testing.requires_llvm
+def test_parallel_reduction_llvm():
+    n = 1 << 20
+    A = te.placeholder((n,), name="A")
+    for reducer, ref in [(te.sum, np.sum), (te.max, np.max)]:
+        k = te.reduce_axis((0, n), name="k")
+        B = te.compute((1,), lambda _: reducer(A[k], axis=k), name="B")
+        s = te.create_schedule(B.op)
+        s[B].parallel(k)
+        f = tvm.build(s, [A, B], "llvm")
+        assert "pragma_parallel_barrier_when_finish" in str(tvm.lower(s, [A, B]))
+        dev = tvm.cpu(0)
+        a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+        b = tvm.nd.array(np.zeros(1, dtype=B.dtype), dev)
+        f(a, b)
+        tvm.testing.assert_allclose(b.numpy()[0], ref(a.numpy()), rtol=1e-4)
+
+
+if __name__ == "__main__":
+    test_lower_parallel_reduction()
+    test_lower_parallel_reduction_skip()
+    test_parallel_reduction_llvm()
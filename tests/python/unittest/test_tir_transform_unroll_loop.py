@@ -14,8 +14,13 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
+
+import numpy as np
 import tvm
+import tvm.testing
 from tvm import te
+from tvm.contrib import utils
 import os
 
 
@@ -110,7 +115,84 @@ def test_unroll_single_count_loops():
         assert ret == stmt
 
 
+def test_unroll_loop_params_attr():
+    ib = tvm.tir.ir_builder.create()
+    n = te.size_var("n")
+    Ab = tvm.tir.decl_buffer((n,), "int64")
+    Aptr = ib.buffer_ptr(Ab)
+    with ib.for_range(0, 8, name="i") as i:
+        Aptr[i] = Aptr[i] + 1
+    func = tvm.tir.PrimFunc([Ab], ib.get())
+
+    # the function attribute overrides the PassContext
+    with tvm.transform.PassContext(config={"tir.UnrollLoop": {"auto_max_step": 16}}):
+        mod = tvm.IRModule.from_expr(func.with_attr("tir.loop_params", {"auto_max_step": 4}))
+        assert isinstance(tvm.tir.transform.UnrollLoop()(mod)["main"].body, tvm.tir.For)
+        mod = tvm.IRModule.from_expr(func)
+        assert not isinstance(tvm.tir.transform.UnrollLoop()(mod)["main"].body, tvm.tir.For)
+
+
+@tvm.testing.requires_llvm
+def test_profile_guided_loop_params():
+    n = 64
+    A = te.placeholder((n, n), name="A")
+    k = te.reduce_axis((0, 16), name="k")
+    B = te.compute((n, n - 16), lambda i, j: te.sum(A[i, j + k], axis=k), name="B")
+    s = te.create_schedule(B.op)
+    jo, ji = s[B].split(B.op.axis[1], factor=8)
+    s[B].reorder(B.op.axis[0], jo, k, ji)
+    s[B].vectorize(ji)
+
+    temp = utils.tempdir()
+    profile = temp.relpath("profile.json")
+    with open(profile, "w") as f:
+        json.dump({"hot": 90.0, "cold": 10.0}, f)
+    keys = ["auto_max_step", "auto_max_extent", "explicit_unroll", "predicated_tail"]
+    config = {"tir.ProfileGuidedLoopParams": {"profile": profile, "number": 1, "repeat": 1}}
+    with tvm.transform.PassContext(config=config):
+        cold = tvm.lower(s, [A, B], name="cold")["cold"]
+        hot = tvm.lower(s, [A, B], name="hot")["hot"]
+        f = tvm.build(s, [A, B], "llvm", name="hot")
+    assert "tir.loop_params" not in cold.attrs
+    # the hot kernel keeps the PassContext parameters unless a variant is faster
+    params = hot.attrs["tir.loop_params"] if "tir.loop_params" in hot.attrs else {}
+    params = tuple(int(params[key]) for key in keys) if params else None
+    serial, unrolled = tvm.tir.ForKind.SERIAL, tvm.tir.ForKind.UNROLLED
+    # the loops of each variant, the k loop has a single step and is expanded when unrolled
+    # explicitly, the j.outer loop has 17 steps and is only unrolled up to an extent of 16.
+    expected = {
+        None: {"i": serial, "j.outer": serial, "k": serial},
+        (16, 0, 1, 0): {"i": serial, "j.outer": serial},
+        (64, 0, 1, 0): {"i": serial, "j.outer": serial},
+        (16, 0, 1, 1): {"i": serial, "j.outer": serial},
+        (64, 0, 1, 1): {"i": serial, "j.outer": serial},
+        (64, 16, 0, 0): {"i": serial, "j.outer": unrolled, "k": unrolled},
+    }
+    assert params in expected
+    loops, lanes = {}, set()
+
+    def visit(stmt):
+        if isinstance(stmt, tvm.tir.For):
+            loops[stmt.loop_var.name] = stmt.kind
+        elif isinstance(stmt, tvm.tir.Ramp):
+            lanes.add(stmt.lanes)
+
+    tvm.tir.stmt_functor.post_order_visit(hot.body, visit)
+    assert loops == expected[params]
+    # j.inner is vectorized by the split factor in every variant
+    assert lanes == {8}
+
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=(n, n)).astype(A.dtype), dev)
+    b = tvm.nd.array(np.zeros((n, n - 16), dtype=B.dtype), dev)
+    f(a, b)
+    ref = sum(a.numpy()[:, j : j + n - 16] for j in range(16))
+    tvm.testing.assert_allclose(b.numpy(), ref, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_unroll_loop()
     test_unroll_fake_loop()
     test_unroll_single_count_loops()
+    test_unroll_loop_params_attr()
+    test_profile_guided_loop_params()
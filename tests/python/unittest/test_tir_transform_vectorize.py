@@ -82,6 +82,31 @@ def test_vectorize_with_if():
     assert isinstance(stmt.else_case, tvm.tir.For)
 
 
+def test_vectorize_predicated_tail():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            B[i] = A[i] + 1
+    stmt = ib.get()
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, B, n], stmt))
+
+    # by default the guarded body is scalarized
+    stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+    assert isinstance(stmt, tvm.tir.For)
+
+    with tvm.transform.PassContext(config={"tir.vectorize_predicated_tail": True}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+    assert isinstance(stmt, tvm.tir.Store)
+    assert isinstance(stmt.index, tvm.tir.Ramp)
+    assert stmt.value.dtype == "float32x4"
+    assert stmt.predicate.dtype == "boolx4"
+    assert isinstance(stmt.value.a, tvm.tir.Load)
+    assert stmt.value.a.predicate.dtype == "boolx4"
+
+
 def test_vectorize_let():
     v = tvm.tir.Var("v", "float32")
     ib = tvm.tir.ir_builder.create()
@@ -208,6 +233,7 @@ def test_vectorize_while_fail():
 if __name__ == "__main__":
     test_vectorize_vector()
     test_vectorize_with_if()
+    test_vectorize_predicated_tail()
     test_vectorize_loop()
     test_vectorize_if_then_else()
     test_vectorize_with_le_cond()